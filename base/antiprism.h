@@ -52,13 +52,17 @@
 #include "colormap.h"
 #include "const.h"
 #include "displaypoly.h"
+#include "edgefaces.h"
 #include "elemprops.h"
 #include "geometry.h"
 #include "geometryinfo.h"
 #include "geometryutils.h"
 #include "getopt.h"
+#include "hullbuilder.h"
+#include "kdtree.h"
 #include "mathutils.h"
 #include "normal.h"
+#include "offstream.h"
 #include "planar.h"
 #include "polygon.h"
 #include "povwriter.h"
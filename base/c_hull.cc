@@ -26,25 +26,30 @@
    \brief wrapper around qhull for convex hulls and delaunay edges.
 */
 
+#include <float.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <algorithm>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "boundbox.h"
 #include "geometry.h"
 #include "geometryutils.h"
+#include "hullbuilder.h"
+#include "kdtree.h"
 #include "mathutils.h"
+#include "private_misc.h"
 #include "utils.h"
 
 #include "qhull/qhull_ra.h"
 
-#define NUM_TO_USE_DELAUNAY 20
-
 using std::vector;
 using std::map;
 using std::pair;
@@ -60,7 +65,24 @@ static void qhull_cleanup(qhT *qh)
   qh_memfreeshort(qh, &curlong, &totlong); // free short mem and mem allocator
 }
 
-static bool make_hull(Geometry &geom, bool append, string qh_args, char *errmsg)
+static_assert(sizeof(coordT) == sizeof(double),
+              "HullContext holds qhull coordinates as double");
+
+HullContext::HullContext()
+{
+  errfile = fopen("/dev/null", "w"); // suppress qhull error messages
+  if (!errfile)                      // must be a valid pointer
+    errfile = stderr;
+}
+
+HullContext::~HullContext()
+{
+  if (errfile != stderr)
+    fclose(errfile);
+}
+
+static bool make_hull(Geometry &geom, bool append, string qh_args, char *errmsg,
+                      HullContext &ctx)
 {
   vector<Vec3d> verts = geom.verts();
   Vec3d cent = geom.centroid();
@@ -69,7 +91,8 @@ static bool make_hull(Geometry &geom, bool append, string qh_args, char *errmsg)
   vcols = geom.colors(VERTS).get_properties();
 
   const int dim = 3;
-  auto *points = new coordT[verts.size() * dim];
+  ctx.points.resize(verts.size() * dim);
+  coordT *points = ctx.points.data();
 
   for (unsigned i = 0; i < verts.size(); i++)
     for (int j = 0; j < dim; j++)
@@ -79,9 +102,7 @@ static bool make_hull(Geometry &geom, bool append, string qh_args, char *errmsg)
 
   boolT ismalloc = False;  // don't free points in qh_freeqhull() or realloc
   FILE *outfile = nullptr; // suppress output from qh_produce_output()
-  FILE *errfile = fopen("/dev/null", "w"); // suppress qhull error messages
-  if (!errfile)                            // must be a valid pointer
-    errfile = stderr;
+  FILE *errfile = ctx.errfile;
 
   qhT qh_val;
   qhT *qh = &qh_val;
@@ -95,7 +116,6 @@ static bool make_hull(Geometry &geom, bool append, string qh_args, char *errmsg)
     if (errmsg)
       snprintf(errmsg, MSG_SZ, "error calculating convex hull");
     qhull_cleanup(qh);
-    delete[] points;
     return false;
   }
 
@@ -179,13 +199,569 @@ static bool make_hull(Geometry &geom, bool append, string qh_args, char *errmsg)
   }
 
   qhull_cleanup(qh);
-  delete[] points;
+
+  return true;
+}
+
+// Built in convex hull, by quickhull. The hull is made of triangles with
+// outward normals and links to their neighbours. The triangles visible
+// from a new point are found with the exact orientation predicate, and
+// points closer to the hull than the rounding error of the coordinates
+// are not added. At the end, triangles are merged into polygons when they
+// are coplanar, or coplanar within the rounding error. Degenerate input,
+// or anything the triangulation can't handle cleanly, is left for Qhull.
+namespace {
+
+// relative error bound of the floating point orientation determinant, as
+// used by orient3d()
+const double orient_err_bound =
+    (7.0 + 56.0 * DBL_EPSILON / 2) * DBL_EPSILON / 2;
+
+class QuickHull {
+public:
+  /// Make the hull
+  /**\param points the points.
+   * \param cos_merge also merge neighbouring faces whose normals have an
+   *  angle cosine of at least this.
+   * \param faces to return the hull faces, as point index numbers.
+   * \return \c true if the hull was made, otherwise \c false. */
+  bool make(const vector<Vec3d> &points, double cos_merge,
+            vector<vector<int>> &faces);
+
+private:
+  struct Face {
+    int v[3];   // vertices, anticlockwise from outside
+    int nbr[3]; // face across edge v[i] -> v[i+1]
+    Vec3d norm;
+    double offset;
+    Vec3d cross;      // cross product of the edges from v[0]
+    Vec3d cross_perm; // the cross product with absolute values of terms
+    int outside;      // first point of the outside list, or -1
+    int mark;         // iteration number when last found visible
+    bool alive;
+  };
+
+  struct HorizonEdge {
+    int from, to;
+    int face; // the non-visible face on the other side
+    int edge; // edge number in face
+  };
+
+  struct Frame {
+    int face, edge, cnt;
+  };
+
+  const vector<Vec3d> *pts = nullptr;
+  double tol = 0;
+
+  // scratch memory, reused between calls
+  vector<Face> fs;
+  vector<int> next_pt;
+  vector<int> visible;
+  vector<HorizonEdge> horizon;
+  vector<Frame> stack;
+  vector<int> todo;
+  vector<int> group;
+  vector<int> ref_face;
+  vector<std::tuple<int, int, int>> bounds;
+  vector<int> v_cnts;
+
+  double dist(int f_idx, int p_idx) const
+  {
+    return vdot(fs[f_idx].norm, (*pts)[p_idx]) - fs[f_idx].offset;
+  }
+
+  // exact side of the plane of a face that a point is on, 1 for outside,
+  // 0 for on the plane and -1 for inside. The determinant of orient3d()
+  // is first evaluated with the cross product of the face, and with the
+  // same error bound.
+  int side(int f_idx, int p_idx) const
+  {
+    const vector<Vec3d> &P = *pts;
+    const Face &face = fs[f_idx];
+    Vec3d W = P[p_idx] - P[face.v[0]];
+    double det = vdot(W, face.cross);
+    double err_bound = orient_err_bound * (fabs(W[0]) * face.cross_perm[0] +
+                                           fabs(W[1]) * face.cross_perm[1] +
+                                           fabs(W[2]) * face.cross_perm[2]);
+    if (det > err_bound)
+      return 1;
+    if (-det > err_bound)
+      return -1;
+    det = orient3d(P[face.v[0]], P[face.v[1]], P[face.v[2]], P[p_idx]);
+    return (det > 0.0) - (det < 0.0);
+  }
+
+  // a point is only added to the hull if it is outside a face by more
+  // than the rounding error of the coordinates
+  bool is_outside(int f_idx, int p_idx) const
+  {
+    return dist(f_idx, p_idx) > tol && side(f_idx, p_idx) > 0;
+  }
+
+  void add_face(int v0, int v1, int v2);
+  int edge_in_face(int f_idx, int from, int to) const;
+  bool init_simplex();
+  bool add_point(int f_idx);
+  int find_group(int f_idx);
+  bool check_groups();
+  bool merge_faces(double cos_merge, vector<vector<int>> &faces);
+};
+
+void QuickHull::add_face(int v0, int v1, int v2)
+{
+  const vector<Vec3d> &P = *pts;
+  Face face;
+  face.v[0] = v0;
+  face.v[1] = v1;
+  face.v[2] = v2;
+  face.nbr[0] = face.nbr[1] = face.nbr[2] = -1;
+  Vec3d U = P[v1] - P[v0];
+  Vec3d V = P[v2] - P[v0];
+  face.cross = vcross(U, V);
+  face.cross_perm = Vec3d(fabs(U[1] * V[2]) + fabs(U[2] * V[1]),
+                          fabs(U[2] * V[0]) + fabs(U[0] * V[2]),
+                          fabs(U[0] * V[1]) + fabs(U[1] * V[0]));
+  // a sliver may have a zero normal, but its side tests are still exact
+  face.norm = face.cross;
+  double len = face.norm.len();
+  if (len > 0)
+    face.norm /= len;
+  face.offset = vdot(face.norm, P[v0]);
+  face.outside = -1;
+  face.mark = -1;
+  face.alive = true;
+  fs.push_back(face);
+}
+
+int QuickHull::edge_in_face(int f_idx, int from, int to) const
+{
+  const Face &face = fs[f_idx];
+  for (int i = 0; i < 3; i++)
+    if (face.v[i] == from && face.v[(i + 1) % 3] == to)
+      return i;
+  return -1;
+}
+
+bool QuickHull::init_simplex()
+{
+  const vector<Vec3d> &P = *pts;
+  const int num = P.size();
+
+  // extreme points along each axis
+  int ext[6] = {0, 0, 0, 0, 0, 0};
+  for (int i = 0; i < num; i++)
+    for (int j = 0; j < 3; j++) {
+      if (P[i][j] < P[ext[2 * j]][j])
+        ext[2 * j] = i;
+      if (P[i][j] > P[ext[2 * j + 1]][j])
+        ext[2 * j + 1] = i;
+    }
+
+  // the most distant pair of extreme points
+  int v[4] = {ext[0], ext[1], -1, -1};
+  double max_d = 0;
+  for (int i = 0; i < 6; i++)
+    for (int j = i + 1; j < 6; j++) {
+      double d = (P[ext[i]] - P[ext[j]]).len2();
+      if (d > max_d) {
+        max_d = d;
+        v[0] = ext[i];
+        v[1] = ext[j];
+      }
+    }
+  if (!(max_d > 0))
+    return false;
+
+  // the most distant point from the line
+  Vec3d dir = (P[v[1]] - P[v[0]]).unit();
+  max_d = 0;
+  for (int i = 0; i < num; i++) {
+    double d = vcross(P[i] - P[v[0]], dir).len();
+    if (d > max_d) {
+      max_d = d;
+      v[2] = i;
+    }
+  }
+  if (!(max_d > 0))
+    return false;
+
+  // the most distant point from the plane
+  Vec3d norm = vcross(P[v[1]] - P[v[0]], P[v[2]] - P[v[0]]).unit();
+  max_d = 0;
+  for (int i = 0; i < num; i++) {
+    double d = vdot(norm, P[i] - P[v[0]]);
+    if (fabs(d) > fabs(max_d)) {
+      max_d = d;
+      v[3] = i;
+    }
+  }
+  if (v[3] < 0)
+    return false;
+
+  // the points must not be coplanar, and face 0 must point away from the
+  // fourth vertex
+  double orient = orient3d(P[v[0]], P[v[1]], P[v[2]], P[v[3]]);
+  if (orient == 0.0)
+    return false;
+  if (orient > 0)
+    swap(v[1], v[2]);
+
+  add_face(v[0], v[1], v[2]);
+  add_face(v[0], v[3], v[1]);
+  add_face(v[1], v[3], v[2]);
+  add_face(v[0], v[2], v[3]);
+
+  for (int f = 0; f < 4; f++)
+    for (int i = 0; i < 3; i++)
+      for (int g = 0; g < 4; g++) {
+        int e = edge_in_face(g, fs[f].v[(i + 1) % 3], fs[f].v[i]);
+        if (e >= 0)
+          fs[f].nbr[i] = g;
+      }
+
+  // share out the other points
+  for (int i = 0; i < num; i++) {
+    if (i == v[0] || i == v[1] || i == v[2] || i == v[3])
+      continue;
+    for (int f = 0; f < 4; f++)
+      if (is_outside(f, i)) {
+        next_pt[i] = fs[f].outside;
+        fs[f].outside = i;
+        break;
+      }
+  }
+
+  return true;
+}
+
+bool QuickHull::add_point(int f_idx)
+{
+  // the eye point is the furthest outside point
+  int eye = fs[f_idx].outside;
+  double max_d = dist(f_idx, eye);
+  for (int p = next_pt[eye]; p >= 0; p = next_pt[p]) {
+    double d = dist(f_idx, p);
+    if (d > max_d) {
+      max_d = d;
+      eye = p;
+    }
+  }
+
+  // find the faces visible from the eye, and the horizon edges in order
+  visible.clear();
+  horizon.clear();
+  stack.clear();
+  fs[f_idx].mark = eye;
+  visible.push_back(f_idx);
+  stack.push_back({f_idx, 0, 0});
+  while (stack.size()) {
+    Frame &frame = stack.back();
+    if (frame.cnt == 3) {
+      stack.pop_back();
+      continue;
+    }
+    const int cur = frame.face;
+    const int k = frame.edge;
+    frame.edge = (k + 1) % 3;
+    frame.cnt++;
+
+    int nbr = fs[cur].nbr[k];
+    if (fs[nbr].mark == eye)
+      continue;
+    int from = fs[cur].v[k];
+    int to = fs[cur].v[(k + 1) % 3];
+    int e = edge_in_face(nbr, to, from);
+    if (side(nbr, eye) > 0) {
+      fs[nbr].mark = eye;
+      visible.push_back(nbr);
+      stack.push_back({nbr, (e + 1) % 3, 1});
+    }
+    else
+      horizon.push_back({from, to, nbr, e});
+  }
+
+  // the visible region must be a disc
+  const int h_sz = horizon.size();
+  for (int i = 0; i < h_sz; i++)
+    if (horizon[i].to != horizon[(i + 1) % h_sz].from)
+      return false;
+
+  for (int f : visible)
+    fs[f].alive = false;
+
+  // make a cone of new faces from the horizon to the eye
+  const int first = fs.size();
+  for (const auto &h : horizon) {
+    add_face(h.from, h.to, eye);
+    fs.back().nbr[0] = h.face;
+    fs[h.face].nbr[h.edge] = fs.size() - 1;
+  }
+  for (int i = 0; i < h_sz; i++) {
+    int cur = first + i;
+    int nxt = first + (i + 1) % h_sz;
+    fs[cur].nbr[1] = nxt;
+    fs[nxt].nbr[2] = cur;
+  }
+
+  // share out the outside points of the visible faces
+  for (int f : visible) {
+    int p = fs[f].outside;
+    while (p >= 0) {
+      int nxt = next_pt[p];
+      if (p != eye) {
+        for (int i = first; i < (int)fs.size(); i++)
+          if (is_outside(i, p)) {
+            next_pt[p] = fs[i].outside;
+            fs[i].outside = p;
+            break;
+          }
+      }
+      p = nxt;
+    }
+    fs[f].outside = -1;
+  }
+
+  for (int i = first; i < (int)fs.size(); i++)
+    if (fs[i].outside >= 0)
+      todo.push_back(i);
+
+  return true;
+}
+
+int QuickHull::find_group(int f_idx)
+{
+  while (group[f_idx] != f_idx)
+    f_idx = group[f_idx] = group[group[f_idx]];
+  return f_idx;
+}
+
+bool QuickHull::check_groups()
+{
+  const int f_sz = fs.size();
+
+  // the largest triangle of a group gives the most reliable plane
+  ref_face.assign(f_sz, -1);
+  for (int f = 0; f < f_sz; f++) {
+    if (!fs[f].alive)
+      continue;
+    int &ref = ref_face[find_group(f)];
+    if (ref < 0 || fs[f].cross.len2() > fs[ref].cross.len2())
+      ref = f;
+  }
+
+  for (int f = 0; f < f_sz; f++) {
+    if (!fs[f].alive)
+      continue;
+    int g = find_group(f);
+    for (int v : fs[f].v)
+      if (!(fabs(dist(ref_face[g], v)) <= tol))
+        return false; // the group is not planar
+    for (int nbr : fs[f].nbr) {
+      int h = find_group(nbr);
+      if (h == g)
+        continue;
+      bool in_nbr_plane = true;
+      for (int v : fs[f].v)
+        if (!(fabs(dist(ref_face[h], v)) <= tol))
+          in_nbr_plane = false;
+      if (in_nbr_plane)
+        return false; // the triangle could belong to either group
+    }
+  }
+
+  return true;
+}
+
+bool QuickHull::merge_faces(double cos_merge, vector<vector<int>> &faces)
+{
+  const int f_sz = fs.size();
+  group.resize(f_sz);
+  for (int f = 0; f < f_sz; f++)
+    group[f] = f;
+
+  // join neighbouring faces that are coplanar, or close enough in angle
+  for (int f = 0; f < f_sz; f++) {
+    if (!fs[f].alive)
+      continue;
+    for (int i = 0; i < 3; i++) {
+      int nbr = fs[f].nbr[i];
+      if (nbr < f)
+        continue;
+      int e = edge_in_face(nbr, fs[f].v[(i + 1) % 3], fs[f].v[i]);
+      int f_opp = fs[f].v[(i + 2) % 3];
+      int nbr_opp = fs[nbr].v[(e + 2) % 3];
+      bool join = side(f, nbr_opp) == 0 || (dist(f, nbr_opp) > -tol &&
+                                            dist(nbr, f_opp) > -tol);
+      if (join || vdot(fs[f].norm, fs[nbr].norm) >= cos_merge) {
+        int g0 = find_group(f);
+        int g1 = find_group(nbr);
+        if (g0 != g1)
+          group[std::max(g0, g1)] = std::min(g0, g1);
+      }
+    }
+  }
+
+  // Triangles that are close to the line of an edge, from points that are
+  // close to the edge, have no reliable plane, and may not be merged
+  // cleanly. Without merging by angle the result is checked.
+  if (cos_merge > 1 && !check_groups())
+    return false;
+
+  // the boundary edges of each group make a polygon
+  bounds.clear();
+  for (int f = 0; f < f_sz; f++) {
+    if (!fs[f].alive)
+      continue;
+    int g = find_group(f);
+    for (int i = 0; i < 3; i++)
+      if (find_group(fs[f].nbr[i]) != g)
+        bounds.push_back(std::make_tuple(g, fs[f].v[i], fs[f].v[(i + 1) % 3]));
+  }
+  sort(bounds.begin(), bounds.end());
+
+  faces.clear();
+  const int b_sz = bounds.size();
+  for (int start = 0, end; start < b_sz; start = end) {
+    int g = std::get<0>(bounds[start]);
+    for (end = start; end < b_sz && std::get<0>(bounds[end]) == g; end++)
+      if (end > start && std::get<1>(bounds[end]) ==
+                             std::get<1>(bounds[end - 1]))
+        return false; // vertex visited twice
+    auto next_vert = [&](int v) {
+      auto it = std::lower_bound(bounds.begin() + start, bounds.begin() + end,
+                                 std::make_tuple(g, v, -1));
+      return (it != bounds.begin() + end && std::get<1>(*it) == v)
+                 ? std::get<2>(*it)
+                 : -1;
+    };
+    vector<int> face;
+    int v = std::get<1>(bounds[start]);
+    do {
+      face.push_back(v);
+      v = next_vert(v);
+    } while (v >= 0 && v != face[0] && (int)face.size() < end - start);
+    if (v != face[0] || (int)face.size() != end - start)
+      return false; // boundary is not a single loop
+    faces.push_back(face);
+  }
+
+  // vertices on only two faces lie along an edge
+  v_cnts.assign(pts->size(), 0);
+  for (const auto &face : faces)
+    for (int v : face)
+      v_cnts[v]++;
+  int num_verts = 0;
+  int num_edges = 0;
+  for (auto &face : faces) {
+    face.erase(std::remove_if(face.begin(), face.end(),
+                              [&](int v) { return v_cnts[v] < 3; }),
+               face.end());
+    if (face.size() < 3)
+      return false;
+    num_edges += face.size();
+  }
+  for (int cnt : v_cnts)
+    num_verts += (cnt >= 3);
+
+  // Euler characteristic check
+  return num_verts - num_edges / 2 + (int)faces.size() == 2;
+}
+
+bool QuickHull::make(const vector<Vec3d> &points, double cos_merge,
+                     vector<vector<int>> &faces)
+{
+  pts = &points;
+  fs.clear();
+  todo.clear();
+  next_pt.assign(points.size(), -1);
+  if (points.size() < 4)
+    return false;
+
+  double max_coord = 0;
+  for (const auto &P : points)
+    for (int j = 0; j < 3; j++)
+      max_coord = std::max(max_coord, fabs(P[j]));
+  tol = 100 * DBL_EPSILON * max_coord;
+
+  if (!init_simplex())
+    return false;
+  for (int f = 0; f < 4; f++)
+    if (fs[f].outside >= 0)
+      todo.push_back(f);
+
+  while (todo.size()) {
+    int f = todo.back();
+    todo.pop_back();
+    if (fs[f].alive && fs[f].outside >= 0 && !add_point(f))
+      return false;
+  }
+
+  return merge_faces(cos_merge, faces);
+}
+
+// Read a merge angle cosine from Qhull "A" options, and check that there
+// are no others
+bool native_hull_args(const string &qh_args, double *cos_merge)
+{
+  *cos_merge = 2; // no merging by angle
+  vector<char> args(qh_args.begin(), qh_args.end());
+  args.push_back('\0');
+  vector<char *> parts;
+  split_line(args.data(), parts);
+  for (char *part : parts) {
+    if (*part == '-')
+      part++;
+    double val;
+    if (*part != 'A' || !read_double_noparse(part + 1, &val))
+      return false;
+    *cos_merge = fabs(val);
+  }
+  return true;
+}
+
+} // namespace
+
+static bool make_native_hull(Geometry &geom, bool append,
+                             const string &qh_args)
+{
+  double cos_merge;
+  if (!native_hull_args(qh_args, &cos_merge))
+    return false;
+
+  // scratch memory is kept between calls
+  static thread_local QuickHull hull;
+  vector<vector<int>> faces;
+  if (!hull.make(geom.verts(), cos_merge, faces))
+    return false;
+
+  if (!append) {
+    vector<int> used(geom.verts().size(), -1);
+    for (const auto &face : faces)
+      for (int v : face)
+        used[v] = 0;
+
+    Geometry hull_geom;
+    for (unsigned int i = 0; i < used.size(); i++)
+      if (used[i] == 0) {
+        used[i] = hull_geom.add_vert(geom.verts(i));
+        hull_geom.colors(VERTS).set(used[i], geom.colors(VERTS).get(i));
+      }
+    for (auto &face : faces)
+      for (int &v : face)
+        v = used[v];
+    geom = hull_geom;
+  }
+
+  for (const auto &face : faces)
+    geom.add_face(face);
 
   return true;
 }
 
 static int dimension_safe_make_hull(Geometry &geom, bool append, string qh_args,
-                                    char *errmsg)
+                                    int engine, char *errmsg,
+                                    HullContext *context)
 {
   // an empty geom should be the only reason an error can occur
   if (!(geom.verts().size())) {
@@ -195,7 +771,17 @@ static int dimension_safe_make_hull(Geometry &geom, bool append, string qh_args,
   }
 
   int dimension = 3;
-  if (!make_hull(geom, append, qh_args, errmsg)) {
+  if (engine == HULL_NATIVE && make_native_hull(geom, append, qh_args))
+    return dimension;
+
+  std::unique_ptr<HullContext> local_context;
+  if (!context) {
+    local_context.reset(new HullContext);
+    context = local_context.get();
+  }
+  HullContext &ctx = *context;
+
+  if (!make_hull(geom, append, qh_args, errmsg, ctx)) {
     // if make_hull fails
     // assume point, line, or polygon 3 to limit
 
@@ -245,7 +831,7 @@ static int dimension_safe_make_hull(Geometry &geom, bool append, string qh_args,
       geom.add_vert(point1);
 
       // 2D test for polygon
-      if (!make_hull(geom, append, qh_args, errmsg)) {
+      if (!make_hull(geom, append, qh_args, errmsg, ctx)) {
         // if test fails need to test with another point to verify not 2D
         // remove point 1 and enter point 2 (also second narrowest edge) in the
         // sort list
@@ -259,7 +845,7 @@ static int dimension_safe_make_hull(Geometry &geom, bool append, string qh_args,
         Vec3d point2 = cent + pvec[1];
         geom.add_vert(point2);
 
-        if (!make_hull(geom, append, qh_args, errmsg)) {
+        if (!make_hull(geom, append, qh_args, errmsg, ctx)) {
           // if still error then vertices are on a line. Add a second point
           dimension = 1;
 
@@ -268,7 +854,7 @@ static int dimension_safe_make_hull(Geometry &geom, bool append, string qh_args,
           geom.add_vert(point1);
 
           // 1D test for line
-          if (!make_hull(geom, append, qh_args, errmsg)) {
+          if (!make_hull(geom, append, qh_args, errmsg, ctx)) {
             // 0 dimensional geom should not have gotten in here. instead, make
             // this an error so it can be spotted
             if (errmsg)
@@ -334,11 +920,13 @@ static int dimension_safe_make_hull(Geometry &geom, bool append, string qh_args,
   return dimension;
 }
 
-Status add_hull(Geometry &geom, string qh_args, int *dim)
+Status add_hull(Geometry &geom, string qh_args, int *dim, int engine,
+                HullContext *ctx)
 {
   Status stat;
   char errmsg[MSG_SZ];
-  int ret = dimension_safe_make_hull(geom, true, qh_args, errmsg);
+  int ret =
+      dimension_safe_make_hull(geom, true, qh_args, engine, errmsg, ctx);
   if (dim)
     *dim = ret;
   if (ret < 0)
@@ -346,11 +934,13 @@ Status add_hull(Geometry &geom, string qh_args, int *dim)
   return stat;
 }
 
-Status set_hull(Geometry &geom, string qh_args, int *dim)
+Status set_hull(Geometry &geom, string qh_args, int *dim, int engine,
+                HullContext *ctx)
 {
   Status stat;
   char errmsg[MSG_SZ];
-  int ret = dimension_safe_make_hull(geom, false, qh_args, errmsg);
+  int ret =
+      dimension_safe_make_hull(geom, false, qh_args, engine, errmsg, ctx);
   if (dim)
     *dim = ret;
   if (ret < 0) {
@@ -433,29 +1023,28 @@ Status get_delaunay_edges(const vector<Vec3d> &verts,
 
 double get_min_vert_to_vert_dist(const vector<Vec3d> &verts, double sig_dist)
 {
+  if (!verts.size())
+    return 0;
+
   double sig_dist2 = sig_dist * sig_dist;
   double min_sig_dist = 1e100;
   double mag2;
 
-  if (!verts.size())
-    min_sig_dist = 0;
-  else if (verts.size() < NUM_TO_USE_DELAUNAY) {
-    Vec3d dvec;
-    for (unsigned int i = 0; i < verts.size() - 1; i++)
-      for (unsigned int j = i + 1; j < verts.size(); j++) {
-        mag2 = (verts[j] - verts[i]).len2();
-        if (mag2 >= sig_dist2 && mag2 < min_sig_dist)
-          min_sig_dist = mag2;
-      }
-  }
-  else {
-    map<pair<int, int>, int> edges;
-    if (!get_delaunay_edges(verts, edges, ""))
-      return -1; // error
-
-    map<pair<int, int>, int>::iterator mi;
-    for (mi = edges.begin(); mi != edges.end(); ++mi) {
-      mag2 = (verts[mi->first.second] - verts[mi->first.first]).len2();
+  KDTree tree(verts);
+  for (unsigned int i = 0; i < verts.size(); i++) {
+    int v_idx = -1;
+    if (sig_dist > 0)
+      v_idx = tree.nearest(verts[i], sig_dist);
+    else {
+      // the vertex itself is at distance 0, so take the next nearest
+      for (int idx : tree.k_nearest(verts[i], 2))
+        if (idx != (int)i) {
+          v_idx = idx;
+          break;
+        }
+    }
+    if (v_idx != -1) {
+      mag2 = (verts[v_idx] - verts[i]).len2();
       if (mag2 >= sig_dist2 && mag2 < min_sig_dist)
         min_sig_dist = mag2;
     }
@@ -570,13 +1159,216 @@ Status get_voronoi_cells(const vector<Vec3d> &verts, vector<Geometry> *cells,
   qhull_cleanup(qh);
   delete[] points;
 
-  for (unsigned int i = 0; i < vcells.faces().size(); i++) {
-    Geometry cell;
+  // the cells are independent, so hull them together
+  vector<Geometry> cell_geoms(vcells.faces().size());
+  for (unsigned int i = 0; i < vcells.faces().size(); i++)
     for (unsigned int j = 0; j < vcells.faces(i).size(); j++)
-      cell.add_vert(vcells.face_v(i, j));
-    cell.add_hull();
-    cells->push_back(cell);
+      cell_geoms[i].add_vert(vcells.face_v(i, j));
+  HullBuilder().make_hulls(cell_geoms, true);
+  cells->insert(cells->end(), cell_geoms.begin(), cell_geoms.end());
+  return Status::ok();
+}
+
+void VoronoiCells::clear()
+{
+  verts.clear();
+  sites.clear();
+  face_offs.clear();
+  vert_offs.clear();
+  face_verts.clear();
+}
+
+Geometry VoronoiCells::get_cell(int idx) const
+{
+  Geometry cell;
+  map<int, int> new_idxs;
+  for (int f = face_offs[idx]; f < face_offs[idx + 1]; f++) {
+    vector<int> face;
+    for (int i = vert_offs[f]; i < vert_offs[f + 1]; i++) {
+      auto vi = new_idxs.find(face_verts[i]);
+      if (vi == new_idxs.end())
+        vi = new_idxs
+                 .insert(std::make_pair(face_verts[i],
+                                        cell.add_vert(verts[face_verts[i]])))
+                 .first;
+      face.push_back(vi->second);
+    }
+    cell.add_face(face);
+  }
+  return cell;
+}
+
+namespace {
+// Voronoi ridges, collected from qhull
+struct VoronoiRidges {
+  vector<pair<int, int>> sites; // the points on each side of the ridge
+  vector<int> offs;             // first vertex of each ridge, then the total
+  vector<int> verts;            // Voronoi vertex index numbers of the ridges
+  vector<bool> unbounded;       // for each point, if its cell is infinite
+};
+} // namespace
+
+static void collect_voronoi_ridge(qhT *qh, FILE *, vertexT *vertex,
+                                  vertexT *vertexA, setT *centers,
+                                  boolT unbounded)
+{
+  auto *ridges = static_cast<VoronoiRidges *>(qh->cpp_object);
+  int site0 = qh_pointid(qh, vertex->point);
+  int site1 = qh_pointid(qh, vertexA->point);
+  if (unbounded) {
+    ridges->unbounded[site0] = true;
+    ridges->unbounded[site1] = true;
+    return;
+  }
+  ridges->sites.push_back(std::make_pair(site0, site1));
+  facetT *facet, **facetp;
+  FOREACHfacet_(centers)
+  {
+    if (!facet->center)
+      facet->center = qh_facetcenter(qh, facet->vertices);
+    ridges->verts.push_back(facet->visitid - 1);
+  }
+  ridges->offs.push_back(ridges->verts.size());
+}
+
+Status get_voronoi_cells(const vector<Vec3d> &verts, VoronoiCells &cells,
+                         const std::function<bool(const Vec3d &)> &vert_test,
+                         const Vec3d *centre, double eps, string qh_args)
+{
+  cells.clear();
+  cells.face_offs.push_back(0);
+  cells.vert_offs.push_back(0);
+
+  HullContext ctx;
+  const int dim = 3;
+  ctx.points.resize(verts.size() * dim);
+  coordT *points = ctx.points.data();
+  for (unsigned i = 0; i < verts.size(); i++)
+    for (int j = 0; j < dim; j++)
+      points[i * dim + j] = verts[i][j];
+
+  qh_args.insert(0, "qhull v o ");
+
+  boolT ismalloc = False;  // don't free points in qh_freeqhull() or realloc
+  FILE *outfile = nullptr; // suppress output from qh_produce_output()
+
+  qhT qh_val;
+  qhT *qh = &qh_val;
+  QHULL_LIB_CHECK
+  qh_zero(qh, ctx.errfile);
+
+  if (qh_new_qhull(qh, dim, verts.size(), points, ismalloc,
+                   (char *)qh_args.c_str(), outfile, ctx.errfile)) {
+    qhull_cleanup(qh);
+    return Status::error("error calculating voronoi cells");
   }
+
+  // walk the ridges, noting the points with infinite cells
+  VoronoiRidges ridges;
+  ridges.offs.push_back(0);
+  ridges.unbounded.resize(verts.size());
+  qh->cpp_object = &ridges;
+  qh_eachvoronoi_all(qh, ctx.errfile, collect_voronoi_ridge, False,
+                     qh_RIDGEall, True);
+  qh->cpp_object = nullptr;
+
+  vector<Vec3d> vor_verts;
+  facetT *facet;
+  FORALLfacets
+  {
+    if (facet->visitid) {
+      if ((int)vor_verts.size() < (int)facet->visitid)
+        vor_verts.resize(facet->visitid);
+      if (!facet->center)
+        facet->center = qh_facetcenter(qh, facet->vertices);
+      vor_verts[facet->visitid - 1] =
+          Vec3d(facet->center[0], facet->center[1], facet->center[2]);
+    }
+  }
+  qhull_cleanup(qh);
+
+  // ridges of each point, with a sign to show if it is the first point
+  const int num_sites = verts.size();
+  const int num_ridges = ridges.sites.size();
+  vector<int> site_offs(num_sites + 1, 0);
+  for (const auto &sp : ridges.sites) {
+    site_offs[sp.first + 1]++;
+    site_offs[sp.second + 1]++;
+  }
+  for (int i = 0; i < num_sites; i++)
+    site_offs[i + 1] += site_offs[i];
+  vector<int> site_ridges(site_offs[num_sites]);
+  vector<int> fill = site_offs;
+  for (int r = 0; r < num_ridges; r++) {
+    site_ridges[fill[ridges.sites[r].first]++] = r + 1;
+    site_ridges[fill[ridges.sites[r].second]++] = -(r + 1);
+  }
+
+  // orientation of each ridge, seen from the first point
+  vector<bool> ridge_reversed(num_ridges);
+  for (int r = 0; r < num_ridges; r++) {
+    Vec3d norm(0, 0, 0);
+    const int start = ridges.offs[r];
+    const int sz = ridges.offs[r + 1] - start;
+    for (int i = 0; i < sz; i++)
+      norm += vcross(vor_verts[ridges.verts[start + i]],
+                     vor_verts[ridges.verts[start + (i + 1) % sz]]);
+    Vec3d out = verts[ridges.sites[r].second] - verts[ridges.sites[r].first];
+    ridge_reversed[r] = vdot(norm, out) < 0;
+  }
+
+  // check the cells, and store the ones that are wanted
+  vector<signed char> vert_ok(vor_verts.size(), -1); // -1 is untested
+  vector<int> new_idxs(vor_verts.size(), -1);
+  for (int site = 0; site < num_sites; site++) {
+    if (ridges.unbounded[site] || site_offs[site + 1] - site_offs[site] < 4)
+      continue;
+
+    bool wanted = true;
+    for (int i = site_offs[site]; wanted && i < site_offs[site + 1]; i++) {
+      int r = abs(site_ridges[i]) - 1;
+      for (int j = ridges.offs[r]; j < ridges.offs[r + 1]; j++) {
+        int v = ridges.verts[j];
+        if (vert_test && vert_ok[v] < 0)
+          vert_ok[v] = vert_test(vor_verts[v]);
+        if (vert_test && !vert_ok[v]) {
+          wanted = false;
+          break;
+        }
+      }
+      // inside the cell is on the same side of each face as the point
+      if (centre) {
+        const auto &sp = ridges.sites[r];
+        Vec3d out = verts[sp.second] - verts[sp.first];
+        if (site_ridges[i] < 0)
+          out = -out;
+        Vec3d v0 = vor_verts[ridges.verts[ridges.offs[r]]];
+        if (vdot(out.unit(), *centre - v0) > eps)
+          wanted = false;
+      }
+    }
+    if (!wanted)
+      continue;
+
+    cells.sites.push_back(site);
+    for (int i = site_offs[site]; i < site_offs[site + 1]; i++) {
+      int r = abs(site_ridges[i]) - 1;
+      const size_t pos = cells.face_verts.size();
+      for (int j = ridges.offs[r]; j < ridges.offs[r + 1]; j++) {
+        int v = ridges.verts[j];
+        if (new_idxs[v] < 0) {
+          new_idxs[v] = cells.verts.size();
+          cells.verts.push_back(vor_verts[v]);
+        }
+        cells.face_verts.push_back(new_idxs[v]);
+      }
+      if (ridge_reversed[r] != (site_ridges[i] < 0))
+        std::reverse(cells.face_verts.begin() + pos, cells.face_verts.end());
+      cells.vert_offs.push_back(cells.face_verts.size());
+    }
+    cells.face_offs.push_back(cells.vert_offs.size() - 1);
+  }
+
   return Status::ok();
 }
 
@@ -127,14 +127,23 @@ void Coloring::setup_lights(Geometry &lts)
       lts.verts(l).to_unit();
 }
 
-Color Coloring::light(Vec3d vec, Geometry &lts)
+Color Coloring::light(Vec3d vec, Geometry &lts, const KDTree *lt_tree)
 {
   Vec3d col_sum(0, 0, 0);
   vec.to_unit();
   double dot;
-  for (unsigned int l = 0; l < lts.verts().size(); l++)
+  auto add_light = [&](int l) {
     if ((dot = vdot(vec, lts.verts(l))) > 0)
       col_sum += dot * lts.colors(VERTS).get(l).get_vec3d();
+  };
+  if (lt_tree) {
+    // unit vectors with a positive dot product are less than sqrt(2) apart
+    for (int l : lt_tree->in_radius(vec, 1.5))
+      add_light(l);
+  }
+  else
+    for (unsigned int l = 0; l < lts.verts().size(); l++)
+      add_light(l);
 
   for (int j = 0; j < 3; j++)
     if (col_sum[j] > 1)
@@ -237,9 +246,11 @@ void Coloring::v_avg_angle(bool apply_map)
 void Coloring::v_lights(Geometry lts)
 {
   setup_lights(lts);
+  KDTree lt_tree(lts.verts());
   Vec3d cent = get_geom()->centroid();
   for (unsigned int i = 0; i < get_geom()->verts().size(); i++)
-    get_geom()->colors(VERTS).set(i, light(get_geom()->verts(i) - cent, lts));
+    get_geom()->colors(VERTS).set(
+        i, light(get_geom()->verts(i) - cent, lts, &lt_tree));
 }
 
 void Coloring::face_edge_color(const vector<vector<int>> &elems,
@@ -318,12 +329,11 @@ void Coloring::f_proper(bool apply_map)
 {
   ProperColor prop(get_geom()->faces().size());
 
-  auto ef_prs = get_geom()->get_edge_face_pairs(false);
-  for (const auto &kp : ef_prs) {
-    const auto &f_idxs = kp.second;
-    for (unsigned int i = 0; i < f_idxs.size(); ++i)
-      for (unsigned int j = i + 1; j < f_idxs.size(); ++j)
-        prop.set_adj(f_idxs[i], f_idxs[j]);
+  EdgeFaces ef(*get_geom());
+  for (int e = 0; e < ef.num_edges(); e++) {
+    for (int i = 0; i < ef.num_faces(e); ++i)
+      for (int j = i + 1; j < ef.num_faces(e); ++j)
+        prop.set_adj(ef.edge_face(e, i), ef.edge_face(e, j));
   }
 
   prop.find_colors();
@@ -403,15 +413,19 @@ void Coloring::f_centroid(bool apply_map)
 void Coloring::f_lights(Geometry lts)
 {
   setup_lights(lts);
+  KDTree lt_tree(lts.verts());
   for (unsigned int i = 0; i < get_geom()->faces().size(); i++)
-    get_geom()->colors(FACES).set(i, light(get_geom()->face_norm(i), lts));
+    get_geom()->colors(FACES).set(
+        i, light(get_geom()->face_norm(i), lts, &lt_tree));
 }
 
 void Coloring::f_lights2(Geometry lts)
 {
   setup_lights(lts);
+  KDTree lt_tree(lts.verts());
   for (unsigned int i = 0; i < get_geom()->faces().size(); i++)
-    get_geom()->colors(FACES).set(i, light(get_geom()->face_cent(i), lts));
+    get_geom()->colors(FACES).set(
+        i, light(get_geom()->face_cent(i), lts, &lt_tree));
 }
 
 void Coloring::e_apply_cmap()
@@ -449,31 +463,22 @@ void Coloring::e_unique(bool apply_map)
 
 void Coloring::e_proper(bool apply_map)
 {
-  auto edges = get_geom()->get_edge_face_pairs(false);
-  map<vector<int>, vector<int>>::iterator mi;
-  int idx = 0;
-  for (mi = edges.begin(); mi != edges.end(); ++mi)
-    mi->second[0] = idx++; // assign index numbers to the impl edges
-  ProperColor prop(idx);   // idx is total number of impl edges
+  EdgeFaces ef(*get_geom());  // impl edges are indexed in order
+  ProperColor prop(ef.num_edges());
 
-  vector<int> e_next(2);
   for (unsigned int i = 0; i < get_geom()->faces().size(); ++i) {
-    for (unsigned int j = 0; j < get_geom()->faces(i).size(); ++j) {
-      vector<int> e0 =
-          make_edge(get_geom()->faces(i, j), get_geom()->faces_mod(i, j + 1));
-      vector<int> e1 = make_edge(get_geom()->faces_mod(i, j + 1),
-                                 get_geom()->faces_mod(i, j + 2));
+    const unsigned int sz = get_geom()->faces(i).size();
+    for (unsigned int j = 0; j < sz; ++j) {
       // An edge is adjacent to the edge that follows it on a face
-      prop.set_adj(edges[e0][0], edges[e1][0]);
+      prop.set_adj(ef.face_edge(i, j), ef.face_edge(i, (j + 1) % sz));
     }
   }
 
   prop.find_colors();
-  for (mi = edges.begin(); mi != edges.end(); ++mi) {
-    int e_idx = edges[mi->first][0];
-    int col_idx = prop.get_color(e_idx);
+  for (int e = 0; e < ef.num_edges(); e++) {
+    int col_idx = prop.get_color(e);
     Color col = (apply_map) ? get_col(col_idx) : Color(col_idx);
-    get_geom()->add_edge(mi->first[0], mi->first[1], col);
+    get_geom()->add_edge(ef.edge_v(e, 0), ef.edge_v(e, 1), col);
   }
 }
 
@@ -586,10 +591,11 @@ void Coloring::e_vector(bool apply_map)
 void Coloring::e_lights(Geometry lts)
 {
   setup_lights(lts);
+  KDTree lt_tree(lts.verts());
   Vec3d cent = get_geom()->centroid();
   for (unsigned int i = 0; i < get_geom()->edges().size(); i++)
     get_geom()->colors(EDGES).set(
-        i, light(get_geom()->edge_nearpt(i, cent) - cent, lts));
+        i, light(get_geom()->edge_nearpt(i, cent) - cent, lts, &lt_tree));
 }
 
 void Coloring::e_dir_lights(Geometry lts)
@@ -603,10 +609,11 @@ void Coloring::e_dir_lights(Geometry lts)
     lts.add_vert(Vec3d(0.28, -0.5, -0.3), Vec3d(0, 0, 1));
   }
   setup_lights(lts);
+  KDTree lt_tree(lts.verts());
 
   for (unsigned int i = 0; i < get_geom()->edges().size(); i++)
     get_geom()->colors(EDGES).set(
-        i, light(get_unsigned(get_geom()->edge_vec(i)), lts));
+        i, light(get_unsigned(get_geom()->edge_vec(i)), lts, &lt_tree));
 }
 
 void Coloring::vef_one_col(Color vert_col, Color edge_col, Color face_col)
@@ -33,6 +33,7 @@
 
 #include "colormap.h"
 #include "geometry.h"
+#include "kdtree.h"
 
 namespace anti {
 
@@ -72,8 +73,10 @@ protected:
   /// Colour for a position vector from a set of lights.
   /**\param vec the position vector.
    * \param lts the lights (prepared for use by setup_lights().)
+   * \param lt_tree a tree of the light positions, to only consider the
+   *  lights on the same side as the position vector.
    * \return The final RGBA colour. */
-  Color light(Vec3d vec, Geometry &lts);
+  Color light(Vec3d vec, Geometry &lts, const KDTree *lt_tree = nullptr);
 
   /// Convert all colour index numbers into colour values.
   /**\param cols the colours of the elements, by element index. */
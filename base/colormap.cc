@@ -762,9 +762,10 @@ static bool parse_gimp_file(FILE *cfile, map<int, Color> *cmap,
     }
 
     // stage == 3
-    char *r = strtok(line, WHITESPACE);
-    char *g = (r) ? strtok(nullptr, WHITESPACE) : nullptr;
-    char *b = (g) ? strtok(nullptr, WHITESPACE) : nullptr;
+    char *tok_ptr;
+    char *r = strtok_r(line, WHITESPACE, &tok_ptr);
+    char *g = (r) ? strtok_r(nullptr, WHITESPACE, &tok_ptr) : nullptr;
+    char *b = (g) ? strtok_r(nullptr, WHITESPACE, &tok_ptr) : nullptr;
     // char *name = (b) ? strtok(NULL, WHITESPACE) : 0;
 
     if (!b) {
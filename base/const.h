@@ -90,6 +90,12 @@ enum {
   TESS_WINDING_ABS_GEQ_TWO = 100134, ///< Absolute value of winding number >= 2
 };
 
+/// Select the engine used to calculate convex hulls
+enum {
+  HULL_QHULL = 0, ///< Qhull
+  HULL_NATIVE = 1 ///< Built in quickhull, using Qhull when it can't be used
+};
+
 } // namespace anti
 
 #endif // CONST_H
@@ -34,6 +34,7 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "coloring.h"
@@ -109,12 +110,10 @@ int orient_geom(Geometry &geom, vector<vector<int>> *parts)
 {
   int part_num = 0;
   const int done = -1;
-  auto edges = geom.get_edge_face_pairs(false);
+  EdgeFaces ef(geom);
   vector<int> cur_idx(geom.faces().size(), 0);
   vector<int> prev_face(geom.faces().size(), 0);
-  vector<int> e_verts(2);
   vector<int> orig_e_verts(2);
-  vector<int> e_faces(2);
   for (unsigned int i = 0; i < geom.faces().size(); i++) {
     if (geom.faces(i).size() < 3)
       cur_idx[i] = done; // don't process degenerate faces
@@ -132,17 +131,16 @@ int orient_geom(Geometry &geom, vector<vector<int>> *parts)
 
       // read off the next edge
       const vector<int> &face = geom.faces(cur_fidx);
+      // (faces are reoriented as they are visited, so find edge by vertices)
+      const int e_idx = ef.find(face[idx], face[(idx + 1) % face.size()]);
       orig_e_verts[0] = face[idx];
       idx = (idx + 1) % face.size();
       orig_e_verts[1] = face[idx];
       cur_idx[cur_fidx] = idx ? idx : done; // set to next idx, or mark done
 
-      e_verts = orig_e_verts;
-      if (e_verts[0] > e_verts[1])
-        swap(e_verts[0], e_verts[1]);
-      e_faces = edges.find(e_verts)->second;
-
-      int next_face = (e_faces[0] != cur_fidx) ? e_faces[0] : e_faces[1];
+      int next_face = ef.edge_face(e_idx, 0);
+      if (next_face == cur_fidx)
+        next_face = (ef.num_faces(e_idx) > 1) ? ef.edge_face(e_idx, 1) : -1;
       if (next_face >= 0 && cur_idx[next_face] == 0) { // face not looked at yet
         orient_face(geom.raw_faces()[next_face], orig_e_verts[1],
                     orig_e_verts[0]);
@@ -195,38 +193,49 @@ void orient_reverse(Geometry &geom)
 }
 
 void get_pol_recip_verts(Geometry &dual, const Geometry &geom, double recip_rad,
-                         Vec3d centre, double inf)
+                         Vec3d centre, double inf, int num_threads)
 {
   const double min_lim = 1e-15;
   // const int r_sign = 1 - 2*(recip_rad<0); // -ve rad will reflect in centre
   const int r_sign = 1; // no reflection in centre
 
   dual.clear(VERTS);
-  for (const auto &face : geom.faces()) {
-    if (recip_rad) {
-      auto f_norm = geom.face_norm(face);
-      auto f_cent = geom.face_cent(face);
-      double f_dist = vdot(f_norm, f_cent - centre);
-      double dist = r_sign * recip_rad * recip_rad / f_dist;
-      if (fabs(f_dist) < min_lim || fabs(dist) > inf)
-        dist = r_sign * inf * (1 - 2 * (f_dist < 0)) / f_norm.len();
-      dual.add_vert(f_norm * dist + centre);
-    }
-    else // all dual vertices = centre
-      dual.add_vert(centre);
-  }
+  const vector<vector<int>> &faces = geom.faces();
+  vector<Vec3d> &d_verts = dual.raw_verts();
+  d_verts.assign(faces.size(), centre); // all dual vertices = centre
+  if (!recip_rad)
+    return;
+
+  // The faces are shared out in blocks, which are only worth a thread
+  // for larger models
+  if (num_threads <= 0)
+    num_threads = std::thread::hardware_concurrency();
+  int f_sz = faces.size();
+  int blocks = std::max(1, std::min(num_threads, f_sz / 256));
+  parallel_for(blocks,
+               [&](int b) {
+                 for (int i = f_sz * b / blocks; i < f_sz * (b + 1) / blocks;
+                      i++) {
+                   auto f_norm = geom.face_norm(faces[i]);
+                   auto f_cent = geom.face_cent(faces[i]);
+                   double f_dist = vdot(f_norm, f_cent - centre);
+                   double dist = r_sign * recip_rad * recip_rad / f_dist;
+                   if (fabs(f_dist) < min_lim || fabs(dist) > inf)
+                     dist = r_sign * inf * (1 - 2 * (f_dist < 0)) /
+                            f_norm.len();
+                   d_verts[i] = f_norm * dist + centre;
+                 }
+               },
+               blocks);
 }
 
-class zero_sz {
-public:
-  bool operator()(const vector<int> &f) const { return f.size() == 0; }
-};
-
-void get_dual(Geometry &dual, const Geometry &geom, double recip_rad,
-              Vec3d centre, double inf)
+// Dual faces, and the pair of faces on each edge, for any geometry.
+// The edges are in index order, and the face pairs follow the
+// orientation of the face that reached the edge last.
+static void get_dual_faces(const Geometry &geom, vector<vector<int>> &d_faces,
+                           vector<pair<vector<int>, pair<int, int>>> &e_faces)
 {
-  get_pol_recip_verts(dual, geom, recip_rad, centre, inf);
-  vector<vector<int>> d_faces(geom.verts().size());
+  d_faces.assign(geom.verts().size(), vector<int>());
 
   const vector<vector<int>> &faces = geom.faces();
   map<pair<int, int>, pair<int, int>> edges;
@@ -255,6 +264,7 @@ void get_dual(Geometry &dual, const Geometry &geom, double recip_rad,
     d_faces[mi->first.first].push_back(mi->second.second);
     d_faces[mi->first.second].push_back(mi->second.second);
     d_faces[mi->first.second].push_back(mi->second.first);
+    e_faces.push_back({{mi->first.first, mi->first.second}, mi->second});
   }
 
   vector<int>::iterator vi;
@@ -275,31 +285,137 @@ void get_dual(Geometry &dual, const Geometry &geom, double recip_rad,
     if (vi != d_face.begin())
       d_face.erase(vi - 1, d_face.end());
   }
+}
+
+// Dual faces, and the pair of faces on each edge, from the half-edges of
+// the geometry in a single pass. This is only possible when each edge
+// has two faces that pass along it in opposite directions, and the faces
+// around each vertex form a single cycle, otherwise false is returned.
+// The results are the same as get_dual_faces().
+static bool
+get_dual_faces_half_edges(const Geometry &geom, vector<vector<int>> &d_faces,
+                          vector<pair<vector<int>, pair<int, int>>> &e_faces)
+{
+  // half-edges leaving each vertex, as the vertex they go to, their face,
+  // and the vertex before the start vertex in the face
+  struct HalfEdge {
+    int to;
+    int face;
+    int prev;
+    bool operator<(const HalfEdge &he) const { return to < he.to; }
+  };
+
+  const vector<vector<int>> &faces = geom.faces();
+  int v_sz = geom.verts().size();
+  vector<int> starts(v_sz + 1, 0);
+  for (const auto &face : faces) {
+    if (face.size() < 3)
+      return false;
+    for (int v : face)
+      starts[v + 1]++;
+  }
+  for (int v = 0; v < v_sz; v++)
+    starts[v + 1] += starts[v];
+
+  vector<HalfEdge> hes(starts[v_sz]);
+  vector<int> next_pos(starts.begin(), starts.end() - 1);
+  for (unsigned int i = 0; i < faces.size(); i++) {
+    const vector<int> &face = faces[i];
+    int sz = face.size();
+    for (int j = 0; j < sz; j++)
+      hes[next_pos[face[j]]++] = {face[(j + 1) % sz], (int)i,
+                                  face[(j + sz - 1) % sz]};
+  }
+
+  for (int v = 0; v < v_sz; v++) {
+    std::sort(hes.begin() + starts[v], hes.begin() + starts[v + 1]);
+    for (int he = starts[v] + 1; he < starts[v + 1]; he++)
+      if (hes[he].to == hes[he - 1].to)
+        return false; // repeated half-edge, or a vertex repeated in a face
+  }
+
+  // index of the half-edge from v0 to v1, or -1
+  auto find_he = [&](int v0, int v1) {
+    auto beg = hes.begin() + starts[v0];
+    auto end = hes.begin() + starts[v0 + 1];
+    auto it = std::lower_bound(beg, end, HalfEdge{v1, 0, 0});
+    return (it != end && it->to == v1) ? int(it - hes.begin()) : -1;
+  };
+
+  // each half-edge needs an opposite half-edge in another face
+  for (int v = 0; v < v_sz; v++)
+    for (int he = starts[v]; he < starts[v + 1]; he++) {
+      int opp = find_he(hes[he].to, v);
+      if (opp < 0 || hes[opp].face == hes[he].face)
+        return false;
+    }
+
+  // The dual face starts with the face with the half-edge to the vertex
+  // from its lowest numbered neighbour, then continues with the face
+  // with the opposite half-edge, and so on, crossing the edge to the
+  // previous vertex in each face.
+  d_faces.assign(v_sz, vector<int>());
+  for (int v = 0; v < v_sz; v++) {
+    int deg = starts[v + 1] - starts[v];
+    if (!deg)
+      continue;
+    vector<int> &d_face = d_faces[v];
+    d_face.resize(deg);
+    int he = starts[v];
+    for (int i = 1; i <= deg; i++) {
+      d_face[i % deg] = hes[he].face;
+      he = find_he(v, hes[he].prev);
+      if (he == starts[v] && i < deg)
+        return false; // more than one cycle of faces around the vertex
+    }
+    if (he != starts[v])
+      return false;
+  }
+
+  for (int v = 0; v < v_sz; v++)
+    for (int he = starts[v]; he < starts[v + 1]; he++)
+      if (v < hes[he].to)
+        e_faces.push_back({{v, hes[he].to},
+                           {hes[find_he(hes[he].to, v)].face, hes[he].face}});
+
+  return true;
+}
+
+void get_dual(Geometry &dual, const Geometry &geom, double recip_rad,
+              Vec3d centre, double inf, int num_threads)
+{
+  get_pol_recip_verts(dual, geom, recip_rad, centre, inf, num_threads);
+  vector<vector<int>> d_faces;
+  vector<pair<vector<int>, pair<int, int>>> e_faces;
+  if (!get_dual_faces_half_edges(geom, d_faces, e_faces)) {
+    e_faces.clear();
+    get_dual_faces(geom, d_faces, e_faces);
+  }
 
   dual.clear(EDGES);
-  const vector<vector<int>> &g_edges = geom.edges();
   dual.colors(FACES) = geom.colors(VERTS);
   dual.colors(VERTS) = geom.colors(FACES);
-  vector<int> g_edge(2);
-  vector<int> d_edge(2);
-  for (mi = edges.begin(); mi != edges.end(); mi++) {
-    g_edge[0] = mi->first.first;
-    g_edge[1] = mi->first.second;
-    d_edge[0] = mi->second.first;
-    d_edge[1] = mi->second.second;
-    int gidx, didx;
-    vector<vector<int>>::const_iterator ei;
-    ei = find(g_edges.begin(), g_edges.end(), g_edge);
-    if (ei != g_edges.end()) {
-      gidx = ei - g_edges.begin();
-      didx = dual.add_edge(d_edge);
-      dual.colors(EDGES).set(didx, geom.colors(EDGES).get(gidx));
+
+  // Dual edges for the edges of the geometry, with the edge colour. The
+  // first geometry edge with the vertex index numbers is used.
+  map<vector<int>, int> g_edge_idxs;
+  for (unsigned int i = 0; i < geom.edges().size(); i++)
+    g_edge_idxs.emplace(geom.edges(i), i);
+  map<vector<int>, int> d_edge_idxs;
+  for (const auto &e_face : e_faces) {
+    auto ei = g_edge_idxs.find(e_face.first);
+    if (ei != g_edge_idxs.end()) {
+      vector<int> d_edge = make_edge(e_face.second.first, e_face.second.second);
+      auto di = d_edge_idxs.emplace(d_edge, dual.edges().size()).first;
+      if (di->second == (int)dual.edges().size())
+        dual.raw_edges().push_back(d_edge);
+      dual.colors(EDGES).set(di->second, geom.colors(EDGES).get(ei->second));
     }
   }
 
-  for (unsigned int i = 0; i < d_faces.size(); ++i)
-    if (d_faces[i].size() >= 3)
-      dual.add_face(d_faces[i]);
+  for (auto &d_face : d_faces)
+    if (d_face.size() >= 3)
+      dual.add_face(d_face);
 }
 
 void add_extra_ideal_elems(Geometry &geom, Vec3d centre, double inf)
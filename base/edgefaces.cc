@@ -0,0 +1,140 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*!\file edgefaces.cc
+ * \brief Adjacency of the edges and faces of a geometry
+*/
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "edgefaces.h"
+#include "geometry.h"
+
+using std::map;
+using std::pair;
+using std::vector;
+
+namespace anti {
+
+uint64_t EdgeFaces::key(int v_idx0, int v_idx1)
+{
+  if (v_idx0 > v_idx1)
+    std::swap(v_idx0, v_idx1);
+  return (uint64_t(uint32_t(v_idx0)) << 32) | uint32_t(v_idx1);
+}
+
+void EdgeFaces::init(const Geometry &geom)
+{
+  const vector<vector<int>> &faces = geom.faces();
+  const int f_sz = faces.size();
+  f_offs.resize(f_sz + 1);
+  int he_sz = 0;
+  for (int i = 0; i < f_sz; i++) {
+    f_offs[i] = he_sz;
+    he_sz += faces[i].size();
+  }
+  f_offs[f_sz] = he_sz;
+
+  // key each half-edge by its edge, the half-edge index keeps face order
+  vector<pair<uint64_t, int>> keyed_hes(he_sz);
+  he_faces.resize(he_sz);
+  he_edges.resize(he_sz);
+  for (int i = 0; i < f_sz; i++) {
+    const vector<int> &face = faces[i];
+    const int sz = face.size();
+    for (int j = 0; j < sz; j++) {
+      const int he = f_offs[i] + j;
+      const int v0 = face[j];
+      const int v1 = face[(j + 1) % sz];
+      keyed_hes[he] = pair<uint64_t, int>(key(v0, v1), he);
+      he_faces[he] = i;
+      he_edges[he] = v0 > v1; // direction, edge index added below
+    }
+  }
+  std::sort(keyed_hes.begin(), keyed_hes.end());
+
+  e_keys.clear();
+  e_offs.clear();
+  e_hes.resize(he_sz);
+  for (int i = 0; i < he_sz; i++) {
+    if (i == 0 || keyed_hes[i].first != keyed_hes[i - 1].first) {
+      e_keys.push_back(keyed_hes[i].first);
+      e_offs.push_back(i);
+    }
+    const int he = keyed_hes[i].second;
+    e_hes[i] = he;
+    he_edges[he] += 2 * (e_keys.size() - 1);
+  }
+  e_offs.push_back(he_sz);
+}
+
+vector<int> EdgeFaces::edge(int e_idx) const
+{
+  return vector<int>{edge_v(e_idx, 0), edge_v(e_idx, 1)};
+}
+
+int EdgeFaces::find(int v_idx0, int v_idx1) const
+{
+  const uint64_t e_key = key(v_idx0, v_idx1);
+  auto ki = std::lower_bound(e_keys.begin(), e_keys.end(), e_key);
+  return (ki != e_keys.end() && *ki == e_key) ? ki - e_keys.begin() : -1;
+}
+
+vector<int> EdgeFaces::faces(int e_idx) const
+{
+  vector<int> f_idxs(num_faces(e_idx));
+  for (unsigned int i = 0; i < f_idxs.size(); i++)
+    f_idxs[i] = edge_face(e_idx, i);
+  return f_idxs;
+}
+
+int EdgeFaces::side_face(int e_idx, int side) const
+{
+  int f_idx = -1;
+  for (int i = 0; i < num_faces(e_idx); i++) {
+    const int he = edge_half_edge(e_idx, i);
+    if (half_edge_reversed(he) == bool(side))
+      f_idx = he_faces[he];
+  }
+  return f_idx;
+}
+
+vector<int> EdgeFaces::face_pair(int e_idx) const
+{
+  return vector<int>{side_face(e_idx, 0), side_face(e_idx, 1)};
+}
+
+map<vector<int>, vector<int>> EdgeFaces::get_map(bool oriented) const
+{
+  map<vector<int>, vector<int>> edge2facepr;
+  for (int i = 0; i < num_edges(); i++) // edges in order, insert at end
+    edge2facepr.emplace_hint(edge2facepr.end(), edge(i),
+                             oriented ? face_pair(i) : faces(i));
+  return edge2facepr;
+}
+
+} // namespace anti
@@ -0,0 +1,213 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*!\file edgefaces.h
+ * \brief Adjacency of the edges and faces of a geometry
+*/
+
+#ifndef EDGEFACES_H
+#define EDGEFACES_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace anti {
+
+class Geometry;
+
+/// Edges of the faces of a geometry, with the faces that meet each edge
+/** Each side of each face is a half-edge. The half-edges are numbered
+ *  in face order, so the half-edge leading from face vertex \c v_no of
+ *  face \c f_idx is <tt>face_start(f_idx) + v_no</tt>. The edges are
+ *  numbered in the order of their vertex index numbers, lowest first,
+ *  which is also the order of the edges in the map returned by
+ *  \c Geometry::get_edge_face_pairs(). The data is held in a few flat
+ *  arrays, and is made with a single sort of packed edge keys.*/
+class EdgeFaces {
+private:
+  std::vector<uint64_t> e_keys; // packed edge vertex index numbers, in order
+  std::vector<int> e_offs;      // start of each edge in e_hes, and total
+  std::vector<int> e_hes;       // half-edges on each edge, in face order
+  std::vector<int> f_offs;      // first half-edge of each face, and total
+  std::vector<int> he_faces;    // face of each half-edge
+  std::vector<int> he_edges;    // 2*edge + 1 if edge is reversed in face
+
+public:
+  /// Constructor
+  EdgeFaces() = default;
+
+  /// Constructor
+  /**\param geom geometry to find the edge face adjacency for */
+  EdgeFaces(const Geometry &geom) { init(geom); }
+
+  /// Find the edge face adjacency for a geometry
+  /**\param geom geometry to find the edge face adjacency for */
+  void init(const Geometry &geom);
+
+  /// Pack an edge into a key
+  /**\param v_idx0 index number of one vertex.
+   * \param v_idx1 index number of the other vertex.
+   * \return The key, which is the same for either order of vertices.*/
+  static uint64_t key(int v_idx0, int v_idx1);
+
+  //-------------------------------------------
+  // Edges
+
+  /// Get the number of edges
+  /**\return The number of edges.*/
+  int num_edges() const { return e_keys.size(); }
+
+  /// Get the vertex index number of an edge
+  /**\param e_idx edge index number.
+   * \param v_no \c 0 for the lower vertex index, \c 1 for the higher.
+   * \return The vertex index number.*/
+  int edge_v(int e_idx, int v_no) const
+  {
+    return v_no ? int(e_keys[e_idx] & 0xFFFFFFFF) : int(e_keys[e_idx] >> 32);
+  }
+
+  /// Get an edge
+  /**\param e_idx edge index number.
+   * \return The edge, with the lowest vertex index first.*/
+  std::vector<int> edge(int e_idx) const;
+
+  /// Find an edge
+  /**\param v_idx0 index number of one vertex.
+   * \param v_idx1 index number of the other vertex.
+   * \return The edge index number, or \c -1 if the edge is not found.*/
+  int find(int v_idx0, int v_idx1) const;
+
+  /// Get the number of faces that meet an edge
+  /** A face that includes the edge more than once is counted for
+   *  each time it includes the edge.
+   * \param e_idx edge index number.
+   * \return The number of faces.*/
+  int num_faces(int e_idx) const { return e_offs[e_idx + 1] - e_offs[e_idx]; }
+
+  /// Get a half-edge that lies on an edge
+  /**\param e_idx edge index number.
+   * \param n position of the half-edge on the edge, the half-edges
+   *  are in face order.
+   * \return The half-edge index number.*/
+  int edge_half_edge(int e_idx, int n) const
+  {
+    return e_hes[e_offs[e_idx] + n];
+  }
+
+  /// Get a face that meets an edge
+  /**\param e_idx edge index number.
+   * \param n position of the face on the edge, the faces are in order.
+   * \return The face index number.*/
+  int edge_face(int e_idx, int n) const
+  {
+    return he_faces[edge_half_edge(e_idx, n)];
+  }
+
+  /// Get the faces that meet an edge
+  /**\param e_idx edge index number.
+   * \return The face index numbers, in order.*/
+  std::vector<int> faces(int e_idx) const;
+
+  /// Get the face on one side of an edge
+  /** For use with an oriented geometry.
+   * \param e_idx edge index number.
+   * \param side \c 0 for the face that has the edge vertices in order
+   *  (lowest vertex index first), \c 1 for the face that has the edge
+   *  vertices in reverse order.
+   * \return The face index number, or \c -1 if the edge is open on that
+   *  side. If several faces have the edge in the same direction then the
+   *  last of these is returned.*/
+  int side_face(int e_idx, int side) const;
+
+  /// Get the faces on each side of an edge
+  /** For use with an oriented geometry.
+   * \param e_idx edge index number.
+   * \return The face that has the edge vertices in order (lowest
+   *  vertex index first) followed by the face that has the edge
+   *  vertices in reverse order, \c -1 for a face index indicates
+   *  the edge is open on that side.*/
+  std::vector<int> face_pair(int e_idx) const;
+
+  //-------------------------------------------
+  // Half-edges
+
+  /// Get the number of half-edges
+  /**\return The number of half-edges.*/
+  int num_half_edges() const { return he_faces.size(); }
+
+  /// Get the first half-edge of a face
+  /**\param f_idx face index number.
+   * \return The half-edge index number leading from face vertex \c 0.*/
+  int face_start(int f_idx) const { return f_offs[f_idx]; }
+
+  /// Get the face of a half-edge
+  /**\param he_idx half-edge index number.
+   * \return The face index number.*/
+  int half_edge_face(int he_idx) const { return he_faces[he_idx]; }
+
+  /// Get the position of a half-edge in its face
+  /**\param he_idx half-edge index number.
+   * \return The face vertex number that the half-edge leads from.*/
+  int half_edge_pos(int he_idx) const
+  {
+    return he_idx - f_offs[he_faces[he_idx]];
+  }
+
+  /// Get the edge of a half-edge
+  /**\param he_idx half-edge index number.
+   * \return The edge index number.*/
+  int half_edge_edge(int he_idx) const { return he_edges[he_idx] / 2; }
+
+  /// Check the direction of a half-edge
+  /**\param he_idx half-edge index number.
+   * \return \c true if the half-edge leads from the higher vertex
+   *  index number of its edge to the lower, otherwise \c false.*/
+  bool half_edge_reversed(int he_idx) const { return he_edges[he_idx] % 2; }
+
+  /// Get the edge of a face side
+  /**\param f_idx face index number.
+   * \param v_no the face vertex that the side leads from.
+   * \return The edge index number.*/
+  int face_edge(int f_idx, int v_no) const
+  {
+    return half_edge_edge(face_start(f_idx) + v_no);
+  }
+
+  //-------------------------------------------
+  // Conversion
+
+  /// Get a map of edges to faces
+  /**\param oriented \c true the value is a pair of faces, as given by
+   *  \c face_pair(), \c false the value is a list of all the faces
+   *  sharing the edge, as given by \c faces().
+   * \return The map, in the same format as that returned by
+   *  \c Geometry::get_edge_face_pairs().*/
+  std::map<std::vector<int>, std::vector<int>>
+  get_map(bool oriented = true) const;
+};
+
+} // namespace anti
+
+#endif // EDGEFACES_H
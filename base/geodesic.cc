@@ -32,12 +32,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
 #include <vector>
 
 #include "geometryutils.h"
 #include "mathutils.h"
 #include "private_geodesic.h"
 #include "private_misc.h"
+#include "utils.h"
 
 using std::vector;
 using std::map;
@@ -138,12 +140,13 @@ inline int Geodesic::index_map(int i, int j, const vector<int> &indx, int p_idx)
   // polyhedron face interior
   if (pos.is_face()) {
     if (p_idx == noindex) {
-      auto mi = grid_idxs.find(int_pr(i, j));
-      if (mi == grid_idxs.end()) {
+      if (i < 0 || j < 0 || i >= grid_sz || j >= grid_sz)
+        return noindex;
+      p_idx = grid_idxs[i * grid_sz + j];
+      if (p_idx == noindex) {
         // fprintf(stderr, "not found in grid_idxs i=%d, j=%d\n", i, j);
         return noindex;
       }
-      p_idx = mi->second;
     }
     int indx_no = V_sz + (F - 1) * base.edges().size() +
                   (F * F * (m * m + m * n + n * n) - F * 3 + 2) / 2 * indx[6] +
@@ -152,29 +155,16 @@ inline int Geodesic::index_map(int i, int j, const vector<int> &indx, int p_idx)
   }
 
   if (pos.is_out()) {
-    vector<int> edge(2);
-    if (y < 0) {
-      edge[0] = indx[0];
-      edge[1] = indx[1];
-    }
-    else if (x + y > freq) {
-      edge[0] = indx[1];
-      edge[1] = indx[2];
-    }
-    else { // x<0
-      edge[0] = indx[2];
-      edge[1] = indx[0];
-    }
-
-    int nf_pos = 1;
-    if (edge[0] > edge[1]) {
-      swap(edge[0], edge[1]);
-      nf_pos = 0;
-    }
-
-    auto mi_ef = edge_faces.find(edge);
-    int nf_idx = mi_ef->second[nf_pos]; // index of neighbouring face
-    if (nf_idx == -1)                   // no neighbouring face
+    int side;
+    if (y < 0)
+      side = 0;
+    else if (x + y > freq)
+      side = 1;
+    else // x<0
+      side = 2;
+
+    int nf_idx = face_nbrs[indx[6]][side]; // index of neighbouring face
+    if (nf_idx == -1)                      // no neighbouring face
       return noindex;
 
     const vector<int> &nface = base.faces()[nf_idx];
@@ -195,8 +185,7 @@ inline int Geodesic::index_map(int i, int j, const vector<int> &indx, int p_idx)
     // if(n_crds.second < n/2)
     //   return noindex;
 
-    vector<int> n_indx = make_face_indexes(nf_idx, nface);
-    return index_map(coord_i(n_crds), coord_j(n_crds), n_indx);
+    return index_map(coord_i(n_crds), coord_j(n_crds), face_indxs[nf_idx]);
   }
 
   return noindex; // should never get here!
@@ -233,81 +222,241 @@ void Geodesic::init()
 
   F = freq / (m * m + m * n + n * n);
   make_grid_idxs();
+
+  // Index numbers and neighbours of the faces, and the highest numbered
+  // face on each edge, which sets the edge points as the last to do so
+  // when the faces were processed in order.
+  int f_sz = base.faces().size();
+  face_indxs.resize(f_sz);
+  face_nbrs.resize(f_sz);
+  edge_owners.assign(base.edges().size(), -1);
+  for (int i = 0; i < f_sz; i++) {
+    face_indxs[i] = make_face_indexes(i, base.faces(i));
+    face_nbrs[i].resize(3);
+    for (int side = 0; side < 3; side++) {
+      int v0 = face_indxs[i][side];
+      int v1 = face_indxs[i][(side + 1) % 3];
+      face_nbrs[i][side] = edge_faces[make_edge(v0, v1)][v0 < v1];
+      edge_owners[face_indxs[i][3 + side]] = i;
+    }
+  }
 }
 
-void clear_def_edges(Geometry &geom)
+vector<Vec3d> Geodesic::base_points()
 {
-  vector<int> del_edges;
-  int e_sz = geom.edges().size();
-  for (int i = 0; i < e_sz; i++) {
-    if (!geom.colors(EDGES).get(i).is_set())
-      del_edges.push_back(i);
-  }
-  geom.del(EDGES, del_edges);
+  vector<Vec3d> bverts = base.verts();
+  if (method == 's')
+    for (auto &v : bverts)
+      v = (v - centre).with_len(1.0);
+  return bverts;
 }
 
-void Geodesic::make_geo(Geometry &geo)
+long Geodesic::num_face_points()
+{
+  return (F * F * (m * m + m * n + n * n) - F * 3 + 2) / 2;
+}
+
+void Geodesic::make_geo(Geometry &geo, int num_threads)
 {
   vector<Vec3d> &gverts = geo.raw_verts();
 
-  gverts = base.verts();
+  gverts = base_points();
   geo.colors(VERTS) = base.colors(VERTS);
 
-  if (method == 's')
-    project_onto_sphere(geo, centre);
-
-  int num_verts =
-      base.faces().size() * (F * F * (m * m + m * n + n * n) - F * 3 + 2) / 2 +
-      base.edges().size() * (F - 1) + base.verts().size();
+  int num_verts = base.faces().size() * num_face_points() +
+                  base.edges().size() * (F - 1) + base.verts().size();
   // fprintf(stderr, "num_verts = %d\n", num_verts);
   // fprintf(stderr, "num_verts = %d, fs=%d, es=%d, vs=%d, F=%d, m=%d, n=%d,
   // freq=%d\n", num_verts, faces.size(), edges.size(), verts.size(), F, m, n,
   // freq);
 
   gverts.resize(num_verts);
+  const vector<Vec3d> bverts(gverts.begin(),
+                             gverts.begin() + base.verts().size());
+
+  // Each face sets its own points, and writes its triangles to its own
+  // buffer, so the faces can be processed in parallel.
+  int f_sz = base.faces().size();
+  vector<vector<int>> face_tris(f_sz);
+  vector<vector<vector<int>>> face_orig_edges(f_sz);
+  parallel_for(f_sz,
+               [&](int i) {
+                 grid_to_points(face_indxs[i], bverts,
+                                [&](int idx, const Vec3d &pt) {
+                                  gverts[idx] = pt;
+                                });
+                 grid_to_tris(face_indxs[i], face_tris[i], face_orig_edges[i]);
+               },
+               num_threads);
+
+  vector<int> tri_offsets(f_sz + 1, 0);
+  for (int i = 0; i < f_sz; i++)
+    tri_offsets[i + 1] = tri_offsets[i] + face_tris[i].size() / 3;
+  vector<vector<int>> &gfaces = geo.raw_faces();
+  gfaces.resize(tri_offsets[f_sz]);
+  parallel_for(f_sz,
+               [&](int i) {
+                 const vector<int> &tris = face_tris[i];
+                 for (unsigned int t = 0; t < tris.size() / 3; t++)
+                   gfaces[tri_offsets[i] + t].assign(&tris[3 * t],
+                                                     &tris[3 * t + 3]);
+                 vector<int>().swap(face_tris[i]);
+               },
+               num_threads);
+
+  for (int i = 0; i < f_sz; i++) {
+    Color f_col = base.colors(FACES).get(i);
+    if (f_col.is_set())
+      for (int f = tri_offsets[i]; f < tri_offsets[i + 1]; f++)
+        geo.colors(FACES).set(f, f_col);
+  }
 
-  vector<vector<int>> orig_edges;
-  for (unsigned int i = 0; i < base.faces().size(); i++) {
-    vector<int> indx = make_face_indexes(i, base.faces(i));
-    grid_to_points(indx, gverts);
-    vector<vector<int>> new_face_tris;
-    grid_to_tris(indx, new_face_tris, orig_edges);
-    vector<vector<int>> &gfaces = geo.raw_faces();
-    gfaces.insert(gfaces.end(), new_face_tris.begin(), new_face_tris.end());
-    Color f_col = base.colors(FACES).get(int(i));
-    for (unsigned int f = gfaces.size() - new_face_tris.size();
-         f < gfaces.size(); f++)
-      geo.colors(FACES).set(int(f), f_col);
+  for (const auto &edge_col : get_orig_edge_cols(face_orig_edges))
+    geo.add_edge_raw(edge_col.first, edge_col.second);
+}
+
+map<vector<int>, Color> Geodesic::get_orig_edge_cols(
+    const vector<vector<vector<int>>> &face_orig_edges)
+{
+  // The edges that lie along the original edges keep their colours, and
+  // other edges are not included. The last colour set for an edge is used.
+  map<vector<int>, Color> edge_cols;
+  for (const auto &orig_edges : face_orig_edges)
+    for (const auto &orig_edge : orig_edges)
+      edge_cols[{orig_edge[0], orig_edge[1]}] =
+          base.colors(EDGES).get(orig_edge[2]);
+  for (auto mi = edge_cols.begin(); mi != edge_cols.end();) {
+    if (mi->second.is_set())
+      ++mi;
+    else
+      mi = edge_cols.erase(mi);
   }
+  return edge_cols;
+}
 
-  geo.add_missing_impl_edges();
-  // fprintf(stderr, "orig_edges.size()= %d\n", orig_edges.size());
-  for (auto &orig_edge : orig_edges) {
-    vector<int> edge(2);
-    edge[0] = orig_edge[0];
-    edge[1] = orig_edge[1];
-    const vector<vector<int>> &gedges = geo.edges();
-    int e_idx = find(gedges.begin(), gedges.end(), edge) - gedges.begin();
-    Color e_col = base.colors(EDGES).get(orig_edge[2]);
-    geo.colors(EDGES).set(e_idx, e_col);
-    // char buf[MSG_SZ];
-    // vtostr(buf, e_col.get_Vec4d());
-    // fprintf(stderr, "adding edge (%d, %d) col=%s\n", edge[0], edge[1],
-    // buf);
+void Geodesic::write_geo(OffStreamWriter &writer, int num_threads)
+{
+  const vector<Vec3d> bverts = base_points();
+  int v_sz = bverts.size();
+  int e_sz = base.edges().size();
+  int f_sz = base.faces().size();
+  long f_pts_sz = num_face_points();
+  long num_verts = f_sz * f_pts_sz + e_sz * (F - 1) + v_sz;
+
+  // Faces are processed in batches, with a face for each thread, so only
+  // the edge points and the points and triangles of a batch are held
+  if (num_threads <= 0)
+    num_threads = std::max(1, (int)std::thread::hardware_concurrency());
+  const int batch_sz = num_threads;
+
+  // A face with all its neighbours has the full pattern of triangles, the
+  // others are counted. The triangles are also made if the original edges
+  // are needed to carry their colours to the new edges.
+  bool edge_cols_set = false;
+  for (int i = 0; i < e_sz; i++)
+    edge_cols_set |= base.colors(EDGES).get(i).is_set();
+  vector<long> tri_cnts(f_sz, (long)F * F * (m * m + m * n + n * n));
+  vector<vector<vector<int>>> face_orig_edges(f_sz);
+  parallel_for(f_sz,
+               [&](int i) {
+                 const vector<int> &nbrs = face_nbrs[i];
+                 if (edge_cols_set ||
+                     std::find(nbrs.begin(), nbrs.end(), -1) != nbrs.end()) {
+                   vector<int> tris;
+                   grid_to_tris(face_indxs[i], tris, face_orig_edges[i]);
+                   tri_cnts[i] = tris.size() / 3;
+                 }
+               },
+               num_threads);
+  map<vector<int>, Color> edge_cols = get_orig_edge_cols(face_orig_edges);
+  vector<vector<vector<int>>>().swap(face_orig_edges);
+
+  long num_elems =
+      edge_cols.size() + base.colors(VERTS).get_properties().size();
+  for (int i = 0; i < f_sz; i++)
+    num_elems += tri_cnts[i];
+  writer.write_header(num_verts, num_elems);
+
+  // Original vertices
+  for (const auto &v : bverts)
+    writer.write_vert(v);
+
+  // Edge points, set by the face that owns the edge
+  vector<Vec3d> e_pts((long)e_sz * (F - 1));
+  parallel_for(f_sz,
+               [&](int i) {
+                 grid_to_points(face_indxs[i], bverts,
+                                [&](int idx, const Vec3d &pt) {
+                                  e_pts[idx - v_sz] = pt;
+                                },
+                                true, false);
+               },
+               num_threads);
+  for (const auto &v : e_pts)
+    writer.write_vert(v);
+  vector<Vec3d>().swap(e_pts);
+
+  // Face interior points
+  long f_pts_start = v_sz + (long)e_sz * (F - 1);
+  vector<vector<Vec3d>> f_pts(batch_sz);
+  for (int start = 0; start < f_sz; start += batch_sz) {
+    int b_sz = std::min(batch_sz, f_sz - start);
+    parallel_for(b_sz,
+                 [&](int b) {
+                   int i = start + b;
+                   long offset = f_pts_start + i * f_pts_sz;
+                   f_pts[b].resize(f_pts_sz);
+                   grid_to_points(face_indxs[i], bverts,
+                                  [&](int idx, const Vec3d &pt) {
+                                    f_pts[b][idx - offset] = pt;
+                                  },
+                                  false, true);
+                 },
+                 num_threads);
+    for (int b = 0; b < b_sz; b++)
+      for (const auto &v : f_pts[b])
+        writer.write_vert(v);
   }
-  clear_def_edges(geo);
+  vector<vector<Vec3d>>().swap(f_pts);
+
+  // Triangles, coloured with the colour of their original face
+  vector<vector<int>> f_tris(batch_sz);
+  for (int start = 0; start < f_sz; start += batch_sz) {
+    int b_sz = std::min(batch_sz, f_sz - start);
+    parallel_for(b_sz,
+                 [&](int b) {
+                   vector<vector<int>> orig_edges;
+                   f_tris[b].clear();
+                   grid_to_tris(face_indxs[start + b], f_tris[b], orig_edges);
+                 },
+                 num_threads);
+    for (int b = 0; b < b_sz; b++) {
+      Color f_col = base.colors(FACES).get(start + b);
+      for (unsigned int t = 0; t < f_tris[b].size(); t += 3)
+        writer.write_face(&f_tris[b][t], 3, f_col);
+    }
+  }
+
+  for (const auto &edge_col : edge_cols)
+    writer.write_edge(edge_col.first[0], edge_col.first[1], edge_col.second);
+
+  for (const auto &v_col : base.colors(VERTS).get_properties())
+    writer.write_vert_elem(v_col.first, v_col.second);
 }
 
-void Geodesic::grid_to_points(vector<int> indx, vector<Vec3d> &gverts)
+void Geodesic::grid_to_points(
+    const vector<int> &indx, const vector<Vec3d> &bverts,
+    const std::function<void(int, const Vec3d &)> &set_pt, bool edge_pts,
+    bool face_pts)
 {
-  const vector<int> face = base.faces(indx[6]);
+  const vector<int> &face = base.faces(indx[6]);
   // fprintf(stderr, "\n+++++++\t\t\t\tface %d = (%d, %d, %d)\n", indx[6],
   // face[0], face[1], face[2]);
 
   vector<vector<Vec3d>> v(3);
   for (int vtx = 0; vtx < 3; vtx++) {
-    Vec3d A = gverts[face[vtx]];
-    Vec3d B = gverts[face[(vtx + 1) % 3]];
+    Vec3d A = bverts[face[vtx]];
+    Vec3d B = bverts[face[(vtx + 1) % 3]];
     Vec3d edge_vec = B - A;
     if (method == 'p') {
       v[vtx].push_back(Vec3d(0, 0, 0));
@@ -345,6 +494,13 @@ void Geodesic::grid_to_points(vector<int> indx, vector<Vec3d> &gverts)
       IJPos pos = get_pos(i, j);
       if (pos.is_out() || pos.is_vert())
         continue;
+      if ((pos.is_edge() && !edge_pts) || (pos.is_face() && !face_pts))
+        continue;
+      if (pos.is_edge()) {
+        int e_idx = indx[(pos == IJPos::e0) ? 3 : (pos == IJPos::e1) ? 4 : 5];
+        if (edge_owners[e_idx] != indx[6])
+          continue;
+      }
 
       int x = grid_x(i, j);
       int y = grid_y(i, j);
@@ -353,7 +509,7 @@ void Geodesic::grid_to_points(vector<int> indx, vector<Vec3d> &gverts)
       if (method == 'p') {
         Vec3d v_delta = v[0][n[0]] + v[(0 - 1 + 3) % 3][freq - n[(0 + 1) % 3]] -
                         v[(0 - 1 + 3) % 3][freq];
-        pt = gverts[face[0]] + v_delta;
+        pt = bverts[face[0]] + v_delta;
       }
       else if (method == 's') {
         Vec3d lnorms[3];
@@ -368,9 +524,7 @@ void Geodesic::grid_to_points(vector<int> indx, vector<Vec3d> &gverts)
         pt.to_unit();
       }
 
-      int idx = index_map(i, j, indx);
-      // fprintf(stderr, "gverts.size()=%d, idx=%d\n", gverts.size(), idx);
-      gverts[idx] = pt;
+      set_pt(index_map(i, j, indx), pt);
       // pt.dump("pt");
     }
 }
@@ -378,25 +532,18 @@ void Geodesic::grid_to_points(vector<int> indx, vector<Vec3d> &gverts)
 void Geodesic::make_grid_idxs()
 {
   int test_val = 2 * freq / (m + n);
+  grid_sz = std::max(test_val - 1, 0);
+  grid_idxs.assign(grid_sz * grid_sz, noindex);
   int idx = 0;
   // i and j at twice the corner angle (which lies inside the axes)
   for (int i = 0; i < test_val - 1; i++)
     for (int j = 0; j < test_val - 1; j++)
       if (get_pos(i, j).is_face())
-        grid_idxs[int_pr(i, j)] = idx++;
-}
-
-inline vector<int> make_tri(int v0, int v1, int v2)
-{
-  vector<int> tri(3);
-  tri[0] = v0;
-  tri[1] = v1;
-  tri[2] = v2;
-  return tri;
+        grid_idxs[i * grid_sz + j] = idx++;
 }
 
 int orig_edge(IJPos p0_pos, int p0_idx, IJPos p1_pos, int p1_idx,
-              vector<int> &indx, vector<int> &e_col)
+              const vector<int> &indx, vector<int> &e_col)
 {
   const int e_to_indx[] = {0, 5, 3, 1, 4, 3, 2, 7};
   int e_no = 0;
@@ -430,7 +577,7 @@ int orig_edge(IJPos p0_pos, int p0_idx, IJPos p1_pos, int p1_idx,
 }
 
 void add_orig_edges(IJPos p0_pos, int p0_idx, IJPos p1_pos, int p1_idx,
-                    IJPos p2_pos, int p2_idx, vector<int> &indx,
+                    IJPos p2_pos, int p2_idx, const vector<int> &indx,
                     vector<vector<int>> &e_cols)
 {
   vector<int> e_col;
@@ -475,7 +622,7 @@ inline bool Geodesic::tri_test(int i, int j, int di, int dj)
   return false;
 }
 
-void Geodesic::grid_to_tris(vector<int> indx, vector<vector<int>> &new_tris,
+void Geodesic::grid_to_tris(const vector<int> &indx, vector<int> &new_tris,
                             vector<vector<int>> &orig_edges)
 {
   int p0_idx, p1_idx, p2_idx, p3_idx;
@@ -494,7 +641,7 @@ void Geodesic::grid_to_tris(vector<int> indx, vector<vector<int>> &new_tris,
         if (tri_test(i, j, 1, 0)) {
           p2_idx = index_map(i + 1, j, indx);
           if (p2_idx != noindex) {
-            new_tris.push_back(make_tri(p0_idx, p1_idx, p2_idx));
+            new_tris.insert(new_tris.end(), {p0_idx, p1_idx, p2_idx});
             if (m * n == 0)
               add_orig_edges(p0_pos, p0_idx, p1_pos, p1_idx, p2_pos, p2_idx,
                              indx, orig_edges);
@@ -504,7 +651,7 @@ void Geodesic::grid_to_tris(vector<int> indx, vector<vector<int>> &new_tris,
         if (tri_test(i, j, 0, 1)) {
           p3_idx = index_map(i, j + 1, indx);
           if (p3_idx != noindex) {
-            new_tris.push_back(make_tri(p1_idx, p0_idx, p3_idx));
+            new_tris.insert(new_tris.end(), {p1_idx, p0_idx, p3_idx});
             if (m * n == 0)
               add_orig_edges(p1_pos, p1_idx, p0_pos, p0_idx, p3_pos, p3_idx,
                              indx, orig_edges);
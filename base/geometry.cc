@@ -31,6 +31,7 @@
 #include <stdlib.h>
 
 #include "coloring.h"
+#include "edgefaces.h"
 #include "geometry.h"
 #include "geometryinfo.h"
 #include "private_misc.h"
@@ -318,14 +319,14 @@ void Geometry::get_impl_edges(vector<vector<int>> &edgs) const
   edgs.erase(vit, edgs.end());
 }
 
-Status Geometry::add_hull(string qh_args, int *dim)
+Status Geometry::add_hull(string qh_args, int *dim, int engine)
 {
-  return anti::add_hull(*this, qh_args, dim);
+  return anti::add_hull(*this, qh_args, dim, engine);
 }
 
-Status Geometry::set_hull(string qh_args, int *dim)
+Status Geometry::set_hull(string qh_args, int *dim, int engine)
 {
-  return anti::set_hull(*this, qh_args, dim);
+  return anti::set_hull(*this, qh_args, dim, engine);
 }
 
 int Geometry::orient(vector<vector<int>> *parts)
@@ -348,9 +349,10 @@ void Geometry::orient_reverse() { return ::orient_reverse(*this); }
 
 void Geometry::sym_align() { transform(Symmetry(*this).get_to_std()); }
 
-void Geometry::triangulate(Color col, unsigned int winding, vector<int> *fmap)
+void Geometry::triangulate(Color col, unsigned int winding, vector<int> *fmap,
+                           int num_threads, bool simple_faces)
 {
-  anti::triangulate(*this, col, winding, fmap);
+  anti::triangulate(*this, col, winding, fmap, num_threads, simple_faces);
 }
 
 Status Geometry::read(string file_name)
@@ -475,32 +477,12 @@ bool Geometry::is_oriented() const
   return true;
 }
 
+EdgeFaces Geometry::get_edge_faces() const { return EdgeFaces(*this); }
+
 std::map<std::vector<int>, std::vector<int>>
 Geometry::get_edge_face_pairs(bool oriented) const
 {
-  map<vector<int>, vector<int>> edge2facepr;
-  vector<int> vrts(2);
-  for (unsigned int i = 0; i < faces().size(); ++i) {
-    for (unsigned int j = 0; j < faces(i).size(); ++j) {
-      vrts[0] = faces(i, j);
-      vrts[1] = faces_mod(i, j + 1);
-      int face_pos = 0;
-      if (vrts[0] > vrts[1]) {
-        swap(vrts[0], vrts[1]);
-        face_pos = 1;
-      }
-      if (oriented) {
-        if (edge2facepr.find(vrts) == edge2facepr.end()) {
-          edge2facepr[vrts].resize(2);
-          edge2facepr[vrts][(face_pos + 1) % 2] = -1;
-        }
-        edge2facepr[vrts][face_pos] = i;
-      }
-      else
-        edge2facepr[vrts].push_back(i);
-    }
-  }
-  return edge2facepr;
+  return get_edge_faces().get_map(oriented);
 }
 
 void Geometry::verts_merge(map<int, int> &vmap)
@@ -33,6 +33,7 @@
 #include <string>
 #include <vector>
 
+#include "edgefaces.h"
 #include "elemprops.h"
 #include "status.h"
 #include "trans3d.h"
@@ -304,10 +305,13 @@ public:
   /**\param qh_args additional arguments to pass to qhull (unsupported,
    *  may not work, check output.)
    * \param dim dimension of the hull 3, 2, 1 or 0.
+   * \param engine \c HULL_QHULL or \c HULL_NATIVE (which will use
+   *  qhull for degenerate hulls or \a qh_args other than \c A options.)
    * \return status, which evaluates to \c true if qhull could
    *  calculate the hull(possibly with warnings), otherwise \c false
    *  to indicate an error. */
-  Status add_hull(std::string qh_args = "", int *dim = nullptr);
+  Status add_hull(std::string qh_args = "", int *dim = nullptr,
+                  int engine = HULL_QHULL);
 
   /// Set the geometry to its convex hull.
   /** If the convex hull could not be calculated the the geometry
@@ -315,10 +319,13 @@ public:
    * \param qh_args additional arguments to pass to qhull (unsupported,
    *  may not work, check output.)
    * \param dim dimension of the hull 3, 2, 1 or 0.
+   * \param engine \c HULL_QHULL or \c HULL_NATIVE (which will use
+   *  qhull for degenerate hulls or \a qh_args other than \c A options.)
    * \return status, which evaluates to \c true if qhull could
    *  calculate the hull(possibly with warnings), otherwise \c false
    *  to indicate an error. */
-  Status set_hull(std::string qh_args = "", int *dim = nullptr);
+  Status set_hull(std::string qh_args = "", int *dim = nullptr,
+                  int engine = HULL_QHULL);
 
   /// Orient the geometry (if possible.)
   /**\param parts used to return the index numbers of the faces
@@ -360,10 +367,16 @@ public:
    *    TESS_WINDING_ABS_GEQ_TWO
    * \param fmap a vector to return the face mapping. Each old face
    *  index maps to the first index of faces it was converted to. A
-   *  final index holds the total number of new faces */
+   *  final index holds the total number of new faces
+   * \param num_threads the maximum number of threads to triangulate
+   *  the faces with, if 0 then use the number of hardware threads.
+   * \param simple_faces if \c true then simple faces are triangulated
+   *  directly, otherwise all faces are triangulated by the tesselator,
+   *  which may divide a non-convex face into different triangles. */
   void triangulate(Color col = Color(),
                    unsigned int winding = TESS_WINDING_NONZERO,
-                   std::vector<int> *fmap = nullptr);
+                   std::vector<int> *fmap = nullptr, int num_threads = 1,
+                   bool simple_faces = true);
 
   //-------------------------------------------
   // Geometric Utilities
@@ -593,6 +606,13 @@ public:
    * \param edgs the edges are returned here */
   void get_impl_edges(std::vector<std::vector<int>> &edgs) const;
 
+  /// Get the edge face adjacency
+  /** The edges of the faces, with the faces that meet each edge, in
+   *  a compact form. This is much faster to make and use than
+   *  \c get_edge_face_pairs().
+   * \return The edge face adjacency.*/
+  EdgeFaces get_edge_faces() const;
+
   /// Get faces lying on each side of an edge for all edges
   /**\param oriented \c true the geometry is oriented and the first face in
    *  the face pair has the vertices of the edge pair in order, -1 for
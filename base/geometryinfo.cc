@@ -119,6 +119,7 @@ void GeometryInfo::reset()
   genus_val = INT_MAX;
   dual.clear_all();
   sym = Symmetry();
+  edge_faces = EdgeFaces();
   efpairs.clear();
   edge_parts.clear();
   face_angles.clear();
@@ -147,6 +148,75 @@ void GeometryInfo::set_center(Vec3d center)
   f_dists.init();
 }
 
+void GeometryInfo::find_props(unsigned int props)
+{
+  // skip properties that are already set
+  if (efpairs.size())
+    props &= ~PROP_EDGE_FACE_PAIRS;
+  if (found_connectivity)
+    props &= ~PROP_CONNECTIVITY;
+  if (dihedral_angles.size())
+    props &= ~PROP_DIHEDRALS;
+  if (f_areas.size())
+    props &= ~PROP_FACE_AREAS;
+  if (f_perimeters.size())
+    props &= ~PROP_FACE_PERIMETERS;
+  if (plane_angles.size())
+    props &= ~PROP_FACE_ANGLES;
+  if (f_max_nonplanars.size())
+    props &= ~PROP_FACE_NONPLANARS;
+  if (f_dists.is_set())
+    props &= ~PROP_FACE_DISTS;
+  if (e_lengths.size())
+    props &= ~PROP_EDGE_LENGTHS;
+  if (e_dists.is_set())
+    props &= ~PROP_EDGE_DISTS;
+  if (ie_lengths.size())
+    props &= ~PROP_IEDGE_LENGTHS;
+  if (ie_dists.is_set())
+    props &= ~PROP_IEDGE_DISTS;
+  if (v_dists.is_set())
+    props &= ~PROP_VERT_DISTS;
+  if (vert_cons.size())
+    props &= ~PROP_VERT_CONS;
+  if (sol_angles.size())
+    props &= ~PROP_SOLID_ANGLES;
+
+  // edges of faces: adjacency, orientation and connectivity (the dihedral
+  // angles are found from the adjacency)
+  if (props & (PROP_EDGE_FACE_PAIRS | PROP_CONNECTIVITY | PROP_DIHEDRALS))
+    find_edge_face_data(props);
+
+  // faces: also keep the face normals to use for the dihedral angles
+  const unsigned int face_props =
+      props & (PROP_FACE_AREAS | PROP_FACE_PERIMETERS | PROP_FACE_ANGLES |
+               PROP_FACE_NONPLANARS | PROP_FACE_DISTS);
+  const bool keep_norms = (props & PROP_DIHEDRALS) && is_oriented();
+  vector<Vec3d> unit_norms;
+  if (face_props || keep_norms)
+    find_face_data(face_props, keep_norms ? &unit_norms : nullptr);
+
+  // edges
+  if (props & PROP_DIHEDRALS)
+    find_dihedral_angles(keep_norms ? &unit_norms : nullptr);
+  if (props & PROP_EDGE_LENGTHS)
+    find_e_lengths(e_lengths, geom.edges(), edge_len);
+  if (props & PROP_EDGE_DISTS)
+    find_e_dist_lims();
+  if (props & PROP_IEDGE_LENGTHS)
+    find_e_lengths(ie_lengths, get_impl_edges(), iedge_len);
+  if (props & PROP_IEDGE_DISTS)
+    find_ie_dist_lims();
+
+  // vertices
+  if (props & PROP_VERT_DISTS)
+    find_v_dist_lims();
+  if (props & PROP_VERT_CONS)
+    find_vert_cons();
+  if (props & PROP_SOLID_ANGLES)
+    find_solid_angles();
+}
+
 const Geometry &GeometryInfo::get_geom() const { return geom; }
 
 Vec3d GeometryInfo::get_center() const { return cent; }
@@ -356,6 +426,13 @@ const vector<int> &GeometryInfo::get_free_verts()
 }
 
 // edges
+const EdgeFaces &GeometryInfo::get_edge_faces()
+{
+  if (!edge_faces.num_half_edges())
+    find_edge_faces();
+  return edge_faces;
+}
+
 const map<vector<int>, vector<int>> &GeometryInfo::get_edge_face_pairs()
 {
   if (!efpairs.size())
@@ -506,43 +583,60 @@ bool GeometryInfo::is_orientable()
   return orientable;
 }
 
+void GeometryInfo::find_edge_faces() { find_edge_face_data(PROP_NONE); }
+
 void GeometryInfo::find_edge_face_pairs()
 {
-  if (is_oriented())
-    efpairs = geom.get_edge_face_pairs(true);
-  else
-    efpairs = geom.get_edge_face_pairs(false);
+  find_edge_face_data(PROP_EDGE_FACE_PAIRS);
 }
 
 void GeometryInfo::find_connectivity()
 {
-  // get a copy of edge face pairs with all faces around an edge
-  map<vector<int>, vector<int>> tmp_efpairs;
-  if (is_oriented())
-    tmp_efpairs = geom.get_edge_face_pairs(false);
-  else if (efpairs.size() == 0)
-    find_edge_face_pairs();
+  find_edge_face_data(PROP_CONNECTIVITY);
+}
 
-  const map<vector<int>, vector<int>> &pairs =
-      is_oriented() ? tmp_efpairs : efpairs;
-
-  known_connectivity = true;
-  even_connectivity = true;
-  polyhedron = true;
-  closed = true;
-  map<vector<int>, vector<int>>::const_iterator ei;
-  for (ei = pairs.begin(); ei != pairs.end(); ++ei) {
-    if (ei->second.size() == 1) // One faces at an edge
-      closed = false;
-    if (ei->second.size() != 2) // Edge not met be exactly 2 faces
-      polyhedron = false;
-    if (ei->second.size() % 2) // Odd number of faces at an edge
-      even_connectivity = false;
-    if (ei->second.size() > 2) // More than two faces at an edge
-      known_connectivity = false;
+// Find the edge face adjacency, orientation and connectivity from a single
+// walk of the face edges
+void GeometryInfo::find_edge_face_data(unsigned int props)
+{
+  if (!edge_faces.num_half_edges())
+    edge_faces.init(geom);
+  const EdgeFaces &ef = edge_faces;
+
+  // oriented if no edge is met twice in the same direction
+  if (oriented < 0) {
+    oriented = 1;
+    for (int e = 0; e < ef.num_edges() && oriented; e++) {
+      int dir_cnts[2] = {0, 0};
+      for (int i = 0; i < ef.num_faces(e); i++)
+        if (++dir_cnts[ef.half_edge_reversed(ef.edge_half_edge(e, i))] > 1) {
+          oriented = 0;
+          break;
+        }
+    }
+  }
+
+  if ((props & PROP_CONNECTIVITY) && !found_connectivity) {
+    known_connectivity = true;
+    even_connectivity = true;
+    polyhedron = true;
+    closed = true;
+    for (int e = 0; e < ef.num_edges(); e++) {
+      const int cnt = ef.num_faces(e);
+      if (cnt == 1) // One faces at an edge
+        closed = false;
+      if (cnt != 2) // Edge not met be exactly 2 faces
+        polyhedron = false;
+      if (cnt % 2) // Odd number of faces at an edge
+        even_connectivity = false;
+      if (cnt > 2) // More than two faces at an edge
+        known_connectivity = false;
+    }
+    found_connectivity = true;
   }
 
-  found_connectivity = true;
+  if ((props & PROP_EDGE_FACE_PAIRS) && !efpairs.size())
+    efpairs = ef.get_map(oriented);
 }
 
 static double face_vol(const Geometry &geom, int f_no, Vec3d *face_vol_cent)
@@ -568,117 +662,211 @@ static double face_vol(const Geometry &geom, int f_no, Vec3d *face_vol_cent)
   return f_vol / 6;
 }
 
-void GeometryInfo::find_f_areas()
-{
-  int fsz = geom.faces().size();
-  f_areas.resize(fsz);
-  area.init();
-  vol = 0;
-  vol_cent = Vec3d(0, 0, 0);
-  for (int i = 0; i < fsz; i++) {
-    f_areas[i] = geom.face_norm(i, true).len();
-    if (f_areas[i] < area.min) {
-      area.min = f_areas[i];
-      area.idx[ElementLimits::IDX_MIN] = i;
-    }
-    if (f_areas[i] > area.max) {
-      area.max = f_areas[i];
-      area.idx[ElementLimits::IDX_MAX] = i;
-    }
-    area.sum += f_areas[i];
-    Vec3d f_vol_cent;
-    double f_vol = face_vol(geom, i, &f_vol_cent);
-    vol += f_vol;
-    vol_cent += f_vol_cent * f_vol;
-  }
-  if (!double_eq(vol, 0))
-    vol_cent /= vol;
-  else
-    vol_cent.unset();
-}
+void GeometryInfo::find_f_areas() { find_face_data(PROP_FACE_AREAS, nullptr); }
 
 void GeometryInfo::find_f_perimeters()
 {
-  f_perimeters.resize(num_faces());
-  for (unsigned int i = 0; i < geom.faces().size(); i++) {
-    double perim = 0.0;
-    for (unsigned int j = 0; j < geom.faces(i).size(); j++)
-      perim += geom.edge_vec(geom.faces(i, j), geom.faces_mod(i, j + 1)).len();
-    f_perimeters[i] = perim;
-  }
+  find_face_data(PROP_FACE_PERIMETERS, nullptr);
 }
 
 void GeometryInfo::find_face_angles()
 {
-  ang.init();
-  num_angs = 0;
+  find_face_data(PROP_FACE_ANGLES, nullptr);
+}
+
+void GeometryInfo::find_f_max_nonplanars()
+{
+  find_face_data(PROP_FACE_NONPLANARS, nullptr);
+}
+
+void GeometryInfo::find_f_dist_lims()
+{
+  find_face_data(PROP_FACE_DISTS, nullptr);
+}
+
+// Find the face properties in a single pass over the faces. If unit_norms
+// is not null then the unit face normals are also returned
+void GeometryInfo::find_face_data(unsigned int props, vector<Vec3d> *unit_norms)
+{
+  const int fsz = geom.faces().size();
+  const bool areas = props & PROP_FACE_AREAS;
+  const bool perimeters = props & PROP_FACE_PERIMETERS;
+  const bool angles = props & PROP_FACE_ANGLES;
+  const bool nonplanars = props & PROP_FACE_NONPLANARS;
+  const bool dists = props & PROP_FACE_DISTS;
+
+  if (areas) {
+    f_areas.resize(fsz);
+    area.init();
+    vol = 0;
+    vol_cent = Vec3d(0, 0, 0);
+  }
+  if (perimeters)
+    f_perimeters.resize(fsz);
+  if (angles) {
+    ang.init();
+    num_angs = 0;
+  }
+  if (nonplanars)
+    f_max_nonplanars.resize(fsz);
+  if (dists)
+    f_dists.init();
+  if (unit_norms)
+    unit_norms->resize(fsz);
+
   map<vector<double>, int, AngleVectLess>::iterator fi;
   map<double, double_range_cnt, AngleLess>::iterator ai;
+  for (int i = 0; i < fsz; i++) {
+    const vector<int> &face = geom.faces(i);
+    const unsigned int f_sz = face.size();
+
+    if (areas) {
+      f_areas[i] = geom.face_norm(i, true).len();
+      if (f_areas[i] < area.min) {
+        area.min = f_areas[i];
+        area.idx[ElementLimits::IDX_MIN] = i;
+      }
+      if (f_areas[i] > area.max) {
+        area.max = f_areas[i];
+        area.idx[ElementLimits::IDX_MAX] = i;
+      }
+      area.sum += f_areas[i];
+      Vec3d f_vol_cent;
+      double f_vol = face_vol(geom, i, &f_vol_cent);
+      vol += f_vol;
+      vol_cent += f_vol_cent * f_vol;
+    }
 
-  for (unsigned int i = 0; i < geom.faces().size(); i++) {
-    unsigned int fsz = geom.faces(i).size();
-    vector<double> f1(fsz), f2(fsz), f_min(fsz);
-    geom.face_angles_lengths(i, &f1);
-    f_min = f1;
-    for (unsigned int offset = 0; offset < fsz; offset++) {
-      pair<int, int> vf_pr(geom.faces(i, offset), i);
-      const double f_ang = f1[offset];
-      vf_plane_angles[vf_pr] = f_ang;
-      ai = plane_angles.find(f_ang);
-      if (ai == plane_angles.end())
-        plane_angles[f_ang] = double_range_cnt().update(f_ang);
+    if (perimeters) {
+      double perim = 0.0;
+      for (unsigned int j = 0; j < f_sz; j++)
+        perim += geom.edge_vec(face[j], geom.faces_mod(i, j + 1)).len();
+      f_perimeters[i] = perim;
+    }
+
+    if (angles) {
+      vector<double> f1(f_sz), f2(f_sz), f_min(f_sz);
+      geom.face_angles_lengths(i, &f1);
+      f_min = f1;
+      for (unsigned int offset = 0; offset < f_sz; offset++) {
+        pair<int, int> vf_pr(face[offset], i);
+        const double f_ang = f1[offset];
+        vf_plane_angles[vf_pr] = f_ang;
+        ai = plane_angles.find(f_ang);
+        if (ai == plane_angles.end())
+          plane_angles[f_ang] = double_range_cnt().update(f_ang);
+        else
+          ai->second.update(f_ang);
+        if (ang.max < f_ang)
+          ang.max = f_ang;
+        if (ang.min > f_ang)
+          ang.min = f_ang;
+        ang.sum += f_ang;
+        num_angs++;
+
+        for (unsigned int k = 0; k < f_sz; k++)
+          f2[(k + offset) % f_sz] = f1[k];
+        if (cmp_face_angles(f2, f_min) < 0)
+          f_min = f2;
+        reverse(f2.begin(), f2.end());
+        if (cmp_face_angles(f2, f_min) < 0)
+          f_min = f2;
+      }
+      fi = face_angles.find(f_min);
+      if (fi == face_angles.end())
+        face_angles[f_min] = 1;
       else
-        ai->second.update(f_ang);
-      if (ang.max < f_ang)
-        ang.max = f_ang;
-      if (ang.min > f_ang)
-        ang.min = f_ang;
-      ang.sum += f_ang;
-      num_angs++;
-
-      for (unsigned int k = 0; k < fsz; k++)
-        f2[(k + offset) % fsz] = f1[k];
-      if (cmp_face_angles(f2, f_min) < 0)
-        f_min = f2;
-      reverse(f2.begin(), f2.end());
-      if (cmp_face_angles(f2, f_min) < 0)
-        f_min = f2;
+        fi->second += 1;
+    }
+
+    // unit normal is shared by the non-planarity and the dihedral angles
+    Vec3d norm;
+    if (unit_norms || (nonplanars && f_sz != 3))
+      norm = geom.face_norm(i).unit();
+    if (unit_norms)
+      (*unit_norms)[i] = norm;
+
+    if (nonplanars) {
+      double max = 0;
+      if (f_sz != 3) {
+        Vec3d f_cent = geom.face_cent(i);
+        for (unsigned int v = 0; v < f_sz; v++) {
+          double dist = fabs(vdot(norm, f_cent - geom.verts(face[v])));
+          if (dist > max)
+            max = dist;
+        }
+      }
+      f_max_nonplanars[i] = max;
     }
-    fi = face_angles.find(f_min);
-    if (fi == face_angles.end())
-      face_angles[f_min] = 1;
+
+    if (dists) {
+      double dist = geom.face_nearpt(i, cent).len();
+      if (dist < f_dists.min) {
+        f_dists.min = dist;
+        f_dists.idx[ElementLimits::IDX_MIN] = i;
+      }
+      if (dist > f_dists.max) {
+        f_dists.max = dist;
+        f_dists.idx[ElementLimits::IDX_MAX] = i;
+      }
+      f_dists.sum += dist;
+    }
+  }
+
+  if (areas) {
+    if (!double_eq(vol, 0))
+      vol_cent /= vol;
     else
-      fi->second += 1;
+      vol_cent.unset();
   }
 }
 
-void GeometryInfo::find_dihedral_angles()
+void GeometryInfo::find_dihedral_angles() { find_dihedral_angles(nullptr); }
+
+// Find dihedral angles from the edge face adjacency. If unit_norms is not
+// null it holds the unit face normals, which are used if the geometry is
+// oriented
+void GeometryInfo::find_dihedral_angles(const vector<Vec3d> *unit_norms)
 {
-  if (efpairs.size() == 0)
-    find_edge_face_pairs();
-  edge_dihedrals.resize(efpairs.size());
+  const EdgeFaces &ef = get_edge_faces();
+  edge_dihedrals.resize(ef.num_edges());
 
   dih_angles.init();
-  map<vector<int>, vector<int>>::iterator ei;
   map<double, double_range_cnt, AngleLess>::iterator di;
   double cos_a = 1, sign = 1;
-  int e_idx = -1;
-  for (ei = efpairs.begin(); ei != efpairs.end(); ++ei) {
-    e_idx++;
-    if (ei->second[0] >= 0 && ei->second[1] >= 0) { // pair of faces
+  for (int e = 0; e < ef.num_edges(); e++) {
+    const int v0 = ef.edge_v(e, 0);
+    const int v1 = ef.edge_v(e, 1);
+    int f_idx0, f_idx1;
+    if (is_oriented()) {
+      f_idx0 = ef.side_face(e, 0);
+      f_idx1 = ef.side_face(e, 1);
+    }
+    else {
+      f_idx0 = ef.edge_face(e, 0);
+      f_idx1 = (ef.num_faces(e) > 1) ? ef.edge_face(e, 1) : -1;
+    }
+
+    if (f_idx0 >= 0 && f_idx1 >= 0) { // pair of faces
       Vec3d n0;
       Vec3d n1;
       if (is_oriented()) {
-        n0 = geom.face_norm(ei->second[0]).unit();
-        n1 = geom.face_norm(ei->second[1]).unit();
-        Vec3d e_dir = geom.verts(ei->first[1]) - geom.verts(ei->first[0]);
+        if (unit_norms) {
+          n0 = (*unit_norms)[f_idx0];
+          n1 = (*unit_norms)[f_idx1];
+        }
+        else {
+          n0 = geom.face_norm(f_idx0).unit();
+          n1 = geom.face_norm(f_idx1).unit();
+        }
+        Vec3d e_dir = geom.verts(v1) - geom.verts(v0);
         sign = vdot(e_dir, vcross(n0, n1));
       }
       else {
-        vector<int> f0 = geom.faces(ei->second[0]);
-        vector<int> f1 = geom.faces(ei->second[1]);
-        orient_face(f0, ei->first[0], ei->first[1]);
-        orient_face(f1, ei->first[1], ei->first[0]);
+        vector<int> f0 = geom.faces(f_idx0);
+        vector<int> f1 = geom.faces(f_idx1);
+        orient_face(f0, v0, v1);
+        orient_face(f1, v1, v0);
         n0 = face_norm(geom.verts(), f0).unit();
         n1 = face_norm(geom.verts(), f1).unit();
         sign = 1;
@@ -691,22 +879,22 @@ void GeometryInfo::find_dihedral_angles()
     if (sign < 0) // in oriented polyhedron
       ang = 2 * M_PI - ang;
 
-    edge_dihedrals[e_idx] = ang;
+    edge_dihedrals[e] = ang;
 
     if (ang > dih_angles.max) {
       dih_angles.max = ang;
-      dih_angles.idx[ElementLimits::IDX_MAX] = ei->first[0];
-      dih_angles.idx[ElementLimits::IDX_MAX2] = ei->first[1];
+      dih_angles.idx[ElementLimits::IDX_MAX] = v0;
+      dih_angles.idx[ElementLimits::IDX_MAX2] = v1;
     }
     if (ang < dih_angles.min) {
       dih_angles.min = ang;
-      dih_angles.idx[ElementLimits::IDX_MIN] = ei->first[0];
-      dih_angles.idx[ElementLimits::IDX_MIN2] = ei->first[1];
+      dih_angles.idx[ElementLimits::IDX_MIN] = v0;
+      dih_angles.idx[ElementLimits::IDX_MIN2] = v1;
     }
     if (fabs(ang - M_PI) < fabs(dih_angles.zero)) {
       dih_angles.zero = ang;
-      dih_angles.idx[ElementLimits::IDX_ZERO] = ei->first[0];
-      dih_angles.idx[ElementLimits::IDX_ZERO2] = ei->first[1];
+      dih_angles.idx[ElementLimits::IDX_ZERO] = v0;
+      dih_angles.idx[ElementLimits::IDX_ZERO2] = v1;
     }
 
     di = dihedral_angles.find(ang);
@@ -810,17 +998,15 @@ void GeometryInfo::find_vert_cons()
 void GeometryInfo::find_face_cons()
 {
   face_cons.resize(num_faces(), vector<vector<int>>());
-  auto e2fs = geom.get_edge_face_pairs(false);
+  const EdgeFaces &ef = get_edge_faces();
   for (unsigned int f_idx = 0; f_idx < geom.faces().size(); f_idx++) {
     for (unsigned int v = 0; v < geom.faces(f_idx).size(); v++) {
       face_cons[f_idx].push_back(vector<int>());
-      auto ei = e2fs.find(
-          make_edge(geom.faces(f_idx, v), geom.faces_mod(f_idx, v + 1)));
-      if (ei != e2fs.end()) { // test, but shouldn't fail
-        for (int i : ei->second) {
-          if (i != (int)f_idx)
-            face_cons[f_idx][v].push_back(i);
-        }
+      const int e_idx = ef.face_edge(f_idx, v);
+      for (int n = 0; n < ef.num_faces(e_idx); n++) {
+        const int i = ef.edge_face(e_idx, n);
+        if (i != (int)f_idx)
+          face_cons[f_idx][v].push_back(i);
       }
     }
   }
@@ -830,7 +1016,7 @@ void GeometryInfo::find_vert_figs()
 {
   vert_figs.resize(num_verts());
   get_vert_cons();
-  auto ef_pairs = geom.get_edge_face_pairs(false);
+  const EdgeFaces &ef = get_edge_faces();
 
   // find set of faces that each vertex belongs to
   const int v_sz = geom.verts().size();
@@ -856,8 +1042,9 @@ void GeometryInfo::find_vert_figs()
           tri[0] = geom.faces_mod(f, n - 1);
           tri[1] = geom.faces(f, n);
           tri[2] = geom.faces_mod(f, n + 1);
-          if (ef_pairs[make_edge(tri[0], tri[1])].size() != 2 ||
-              ef_pairs[make_edge(tri[1], tri[2])].size() != 2) {
+          const int f_sz = geom.faces(f).size();
+          if (ef.num_faces(ef.face_edge(f, (n + f_sz - 1) % f_sz)) != 2 ||
+              ef.num_faces(ef.face_edge(f, n)) != 2) {
             figure_good = false;
             break; // finish processing this face from set
           }
@@ -1106,26 +1293,6 @@ void GeometryInfo::find_edge_parts()
     }
 }
 
-void GeometryInfo::find_f_max_nonplanars()
-{
-  f_max_nonplanars.resize(geom.faces().size());
-  for (unsigned int f = 0; f < geom.faces().size(); f++) {
-    if (geom.faces(f).size() == 3) {
-      f_max_nonplanars[f] = 0;
-      continue;
-    }
-    Vec3d norm = geom.face_norm(f).unit();
-    Vec3d f_cent = geom.face_cent(f);
-    double max = 0;
-    for (unsigned int v = 0; v < geom.faces(f).size(); v++) {
-      double dist = fabs(vdot(norm, f_cent - geom.verts(geom.faces(f, v))));
-      if (dist > max)
-        max = dist;
-    }
-    f_max_nonplanars[f] = max;
-  }
-}
-
 void GeometryInfo::find_symmetry() { sym.init(geom); }
 
 int GeometryInfo::genus()
@@ -1196,27 +1363,7 @@ void GeometryInfo::find_e_dist_lims()
 
 void GeometryInfo::find_ie_dist_lims()
 {
-  vector<vector<int>> edges;
-  geom.get_impl_edges(edges);
-  set_edge_dists(geom, cent, edges, ie_dists);
-}
-
-void GeometryInfo::find_f_dist_lims()
-{
-  ElementLimits &lim = f_dists;
-  lim.init();
-  for (unsigned int i = 0; i < geom.faces().size(); i++) {
-    double dist = geom.face_nearpt(i, cent).len();
-    if (dist < lim.min) {
-      lim.min = dist;
-      lim.idx[ElementLimits::IDX_MIN] = i;
-    }
-    if (dist > lim.max) {
-      lim.max = dist;
-      lim.idx[ElementLimits::IDX_MAX] = i;
-    }
-    lim.sum += dist;
-  }
+  set_edge_dists(geom, cent, get_impl_edges(), ie_dists);
 }
 
 } // namespace anti
@@ -140,6 +140,7 @@ private:
   ElementLimits f_dists;
 
   std::vector<std::vector<int>> impl_edges;
+  EdgeFaces edge_faces;
   std::map<std::vector<int>, std::vector<int>> efpairs;
   std::vector<std::vector<int>> edge_parts;
   std::map<std::vector<double>, int, AngleVectLess> face_angles;
@@ -172,6 +173,10 @@ private:
   void find_connectivity();
   void find_face_angles();
   void find_dihedral_angles();
+  void find_dihedral_angles(const std::vector<Vec3d> *unit_norms);
+  void find_edge_faces();
+  void find_edge_face_data(unsigned int props);
+  void find_face_data(unsigned int props, std::vector<Vec3d> *unit_norms);
   void find_vert_cons();
   void find_vert_cons_orig();
   void find_face_cons();
@@ -201,9 +206,40 @@ public:
    * \param center used for any properties that are relative to a centre */
   GeometryInfo(const Geometry &geo, Vec3d center = Vec3d(0, 0, 0));
 
+  /// Flags to select properties to find with \c find_props()
+  enum {
+    PROP_NONE = 0,                 ///< None
+    PROP_EDGE_FACE_PAIRS = 1 << 0, ///< Edge face pairs, and orientation
+    PROP_CONNECTIVITY = 1 << 1,    ///< Connectivity
+    PROP_DIHEDRALS = 1 << 2,       ///< Dihedral angles
+    PROP_FACE_AREAS = 1 << 3,      ///< Face areas, volume and volume centroid
+    PROP_FACE_PERIMETERS = 1 << 4, ///< Face perimeters
+    PROP_FACE_ANGLES = 1 << 5,     ///< Plane angles
+    PROP_FACE_NONPLANARS = 1 << 6, ///< Face non-planarity values
+    PROP_FACE_DISTS = 1 << 7,      ///< Face distance limits
+    PROP_EDGE_LENGTHS = 1 << 8,    ///< Explicit edge lengths
+    PROP_EDGE_DISTS = 1 << 9,      ///< Explicit edge distance limits
+    PROP_IEDGE_LENGTHS = 1 << 10,  ///< Implicit edge lengths
+    PROP_IEDGE_DISTS = 1 << 11,    ///< Implicit edge distance limits
+    PROP_VERT_DISTS = 1 << 12,     ///< Vertex distance limits
+    PROP_VERT_CONS = 1 << 13,      ///< Vertex connections
+    PROP_SOLID_ANGLES = 1 << 14,   ///< Solid angles
+    PROP_ALL = (1 << 15) - 1,      ///< All of the above
+  };
+
   /// Reset, clear all setting
   void reset();
 
+  /// Find a set of properties together
+  /** Properties that are not already cached are calculated in as few
+   *  passes over the geometry as possible, sharing intermediate values
+   *  (e.g. face normals and edge adjacency) between them. The results
+   *  are then returned by the normal access functions without further
+   *  calculation.
+   * \param props the properties to find, from \c PROP_EDGE_FACE_PAIRS,
+   *  \c PROP_CONNECTIVITY, etc, combined with bitwise OR.*/
+  void find_props(unsigned int props);
+
   /// Get the geometry being analysed
   /**\return The geometry.*/
   const Geometry &get_geom() const;
@@ -438,6 +474,10 @@ public:
   // ----------------------------------------------------------
   // Edges
 
+  /// Get the edge face adjacency
+  /**\return The edges of the faces with the faces that meet each edge.*/
+  const EdgeFaces &get_edge_faces();
+
   /// Get edge face pairs
   /** An edge has two vertices, but may be part of any number of faces,
    * \return A map of the vertex pair of an edge to the faces it lies on.*/
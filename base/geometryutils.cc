@@ -42,22 +42,33 @@ using std::vector;
 
 namespace anti {
 
-bool make_geodesic_planar(Geometry &geom, const Geometry &base, int m, int n)
+bool make_geodesic_planar(Geometry &geom, const Geometry &base, int m, int n,
+                          int num_threads)
 {
   if (m < 0 || n < 0 || (m == 0 && n == 0))
     return false; // invalid pattern
   Geodesic geod(base, m, n, 'p');
-  geod.make_geo(geom);
+  geod.make_geo(geom, num_threads);
   return true; // valid pattern
 }
 
 bool make_geodesic_sphere(Geometry &geom, const Geometry &base, int m, int n,
-                          Vec3d cent)
+                          Vec3d cent, int num_threads)
 {
   if (m < 0 || n < 0 || (m == 0 && n == 0))
     return false; // invalid pattern
   Geodesic geod(base, m, n, 's', cent);
-  geod.make_geo(geom);
+  geod.make_geo(geom, num_threads);
+  return true; // valid pattern
+}
+
+bool write_geodesic(OffStreamWriter &writer, const Geometry &base, int m,
+                    int n, char method, Vec3d cent, int num_threads)
+{
+  if (m < 0 || n < 0 || (m == 0 && n == 0))
+    return false; // invalid pattern
+  Geodesic geod(base, m, n, method, cent);
+  geod.write_geo(writer, num_threads);
   return true; // valid pattern
 }
 
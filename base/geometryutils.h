@@ -29,8 +29,11 @@
 #ifndef GEOMETRYUTILS_H
 #define GEOMETRYUTILS_H
 
+#include <functional>
+
 #include "coloring.h"
 #include "normal.h"
+#include "offstream.h"
 #include "symmetry.h"
 
 namespace anti {
@@ -48,6 +51,55 @@ Status get_voronoi_cells(const std::vector<Vec3d> &verts,
                          std::vector<Geometry> *cells,
                          std::string qh_args = "");
 
+/// Voronoi cells, held in flat arrays
+/**The cells share one pool of vertices. The faces of cell \c i are
+ * \c face_offs[i] to \c face_offs[i+1]-1, and the vertices of face \c f
+ * are \c face_verts[vert_offs[f]] to \c face_verts[vert_offs[f+1]-1].
+ * A face between two cells is included in each, with opposite
+ * orientation. Faces are oriented anticlockwise, seen from outside. */
+class VoronoiCells {
+public:
+  std::vector<Vec3d> verts;    ///< Voronoi vertices, shared by the cells
+  std::vector<int> sites;      ///< Index number of the point of each cell
+  std::vector<int> face_offs;  ///< First face of each cell, then the total
+  std::vector<int> vert_offs;  ///< First vertex of each face, then the total
+  std::vector<int> face_verts; ///< Vertex index numbers of the faces
+
+  /// Clear the cells
+  void clear();
+
+  /// Get the number of cells
+  /**\return The number of cells. */
+  int num_cells() const { return sites.size(); }
+
+  /// Get a cell
+  /**\param idx the cell index number.
+   * \return The cell, containing only the vertices that it uses. */
+  Geometry get_cell(int idx) const;
+};
+
+/// Get Voronoi cells, in flat arrays.
+/**Get the finite Voronoi cells of a set of points. The cells are made
+ * from qhull's Voronoi ridges, and are checked against the restrictions
+ * before they are stored.
+ * \param verts the points to find the Voronoi cells for
+ * \param cells to return the Voronoi cells, in point order
+ * \param vert_test if set, only include cells whose vertices all pass
+ *  this test, which is made once for each Voronoi vertex.
+ * \param centre if set, only include cells that contain this point
+ *  (including on their surface.)
+ * \param eps a small number, coordinates differing by less than eps are
+ *  the same.
+ * \param qh_args additional arguments to pass to qhull (unsupported,
+ * may not work, check output.)
+ * \return status, evaluates to \c true if the cells were calculated,
+ * otherwise false.*/
+Status get_voronoi_cells(
+    const std::vector<Vec3d> &verts, VoronoiCells &cells,
+    const std::function<bool(const Vec3d &)> &vert_test = nullptr,
+    const Vec3d *centre = nullptr, double eps = epsilon,
+    std::string qh_args = "");
+
 /// Get a star of vectors to use for making a zonohedron.
 /**\param geom geometry to get the star from
  * \param type the type of star to make can be
@@ -98,9 +150,11 @@ Status make_polar_zonohedron(Geometry &geom, const std::vector<Vec3d> &star,
  * \param base the base polyhedron
  * \param m the first pattern specifier.
  * \param n the second pattern specifier.
+ * \param num_threads the maximum number of threads, if 0 then use the
+ *  number of hardware threads.
  * \return \c true if the pattern was valid, otherwise \c false. */
 bool make_geodesic_planar(Geometry &geom, const Geometry &base, int m,
-                          int n = 0);
+                          int n = 0, int num_threads = 1);
 
 /// Set spherical geodesic division.
 /** A Class I pattern is made with m=0,n=1. A Class II pattern
@@ -110,9 +164,30 @@ bool make_geodesic_planar(Geometry &geom, const Geometry &base, int m,
  * \param m the first pattern specifier.
  * \param n the second pattern specifier.
  * \param cent the centre of projection.
+ * \param num_threads the maximum number of threads, if 0 then use the
+ *  number of hardware threads.
  * \return \c true if the pattern was valid, otherwise \c false. */
 bool make_geodesic_sphere(Geometry &geom, const Geometry &base, int m,
-                          int n = 0, Vec3d cent = Vec3d(0, 0, 0));
+                          int n = 0, Vec3d cent = Vec3d(0, 0, 0),
+                          int num_threads = 1);
+
+/// Write a geodesic division to an OFF stream.
+/** The model is written element by element, with the same output as
+ *  make_geodesic_sphere() or make_geodesic_planar(), without holding
+ *  the model in memory.
+ * \param writer the open OFF stream, the header and all the elements
+ *  are written to it.
+ * \param base the base polyhedron
+ * \param m the first pattern specifier.
+ * \param n the second pattern specifier.
+ * \param method \c s for a geodesic sphere, \c p for planar.
+ * \param cent the centre of projection, for a geodesic sphere.
+ * \param num_threads the maximum number of threads, if 0 then use the
+ *  number of hardware threads. A face is held for each thread.
+ * \return \c true if the pattern was valid, otherwise \c false. */
+bool write_geodesic(OffStreamWriter &writer, const Geometry &base, int m,
+                    int n = 0, char method = 's',
+                    Vec3d cent = Vec3d(0, 0, 0), int num_threads = 1);
 
 /// Project the vertices onto a sphere
 /**\param geom whose vertices will be projected
@@ -168,18 +243,27 @@ void transform_and_repeat(Geometry &geom, std::string sym_to,
  * \param geom input geometry containing faces.
  * \param recip_rad radius of reciprocation sphere.
  * \param centre centre of reciprocation sphere.
- * \param inf maximum distance a vertex will be placed. */
+ * \param inf maximum distance a vertex will be placed.
+ * \param num_threads the maximum number of threads to use for larger
+ *  models, if 0 then use the number of hardware threads. */
 void get_pol_recip_verts(Geometry &dual, const Geometry &geom, double recip_rad,
-                         Vec3d centre, double inf = 1e15);
+                         Vec3d centre, double inf = 1e15, int num_threads = 1);
 
 /// Convert the face planes to vertices by polar reciprocation in sphere
-/**\param dual output geometry containing polar reciprocal.
+/** When each edge has two faces that pass along it in opposite
+ *  directions, and the faces around each vertex form a single cycle,
+ *  the dual faces are found directly from the half-edges.
+ * \param dual output geometry containing polar reciprocal.
  * \param geom input geometry containing faces.
  * \param recip_rad radius of reciprocation sphere.
  * \param centre centre of reciprocation sphere.
- * \param inf maximum distance a vertex will be placed. */
+ * \param inf maximum distance a vertex will be placed.
+ * \param num_threads the maximum number of threads to use for the
+ *  vertices of larger models, if 0 then use the number of hardware
+ *  threads. */
 void get_dual(Geometry &dual, const Geometry &geom, double recip_rad = 0,
-              Vec3d centre = Vec3d(0, 0, 0), double inf = 1e20);
+              Vec3d centre = Vec3d(0, 0, 0), double inf = 1e20,
+              int num_threads = 1);
 
 /// Add extra elements when an element joined to an ideal point.
 /**An ideal point is a which is at "infinity" in, arbitrarily, either
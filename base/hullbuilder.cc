@@ -0,0 +1,112 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*!\file hullbuilder.cc
+ * \brief Convex hulls of many point sets
+*/
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hullbuilder.h"
+#include "private_misc.h"
+#include "utils.h"
+
+using std::string;
+using std::vector;
+
+namespace anti {
+
+HullBuilder::HullBuilder(string qh_args, int engine, int num_threads)
+    : qh_args(qh_args), engine(engine), num_threads(num_threads)
+{
+  contexts.emplace_back(new HullContext);
+}
+
+HullBuilder::~HullBuilder() = default;
+
+Status HullBuilder::make_hull(Geometry &geom, bool append, int *dim,
+                              int ctx_idx)
+{
+  HullContext *ctx = contexts[ctx_idx].get();
+  return (append) ? anti::add_hull(geom, qh_args, dim, engine, ctx)
+                  : anti::set_hull(geom, qh_args, dim, engine, ctx);
+}
+
+Status HullBuilder::set_hull(Geometry &geom, int *dim)
+{
+  return make_hull(geom, false, dim, 0);
+}
+
+Status HullBuilder::add_hull(Geometry &geom, int *dim)
+{
+  return make_hull(geom, true, dim, 0);
+}
+
+Status HullBuilder::make_hulls(vector<Geometry> &geoms, bool append,
+                               vector<int> *dims)
+{
+  const int num = geoms.size();
+  vector<Status> stats(num);
+  vector<int> hull_dims(num);
+
+  // threads take the sets in blocks, and each block uses its own context
+  int blocks = num_threads;
+  if (blocks <= 0)
+    blocks = std::thread::hardware_concurrency();
+  if (blocks > num)
+    blocks = num;
+  if (blocks < 1)
+    blocks = 1;
+  while ((int)contexts.size() < blocks)
+    contexts.emplace_back(new HullContext);
+
+  parallel_for(
+      blocks,
+      [&](int block) {
+        for (int i = block; i < num; i += blocks)
+          stats[i] = make_hull(geoms[i], append, &hull_dims[i], block);
+      },
+      blocks);
+
+  if (dims)
+    *dims = hull_dims;
+  for (const auto &stat : stats)
+    if (stat.is_error())
+      return stat;
+  return Status::ok();
+}
+
+Status HullBuilder::make_hulls(const vector<vector<Vec3d>> &point_sets,
+                               vector<Geometry> &hulls, vector<int> *dims)
+{
+  hulls.clear();
+  hulls.resize(point_sets.size());
+  for (unsigned int i = 0; i < point_sets.size(); i++)
+    hulls[i].add_verts(point_sets[i]);
+  return make_hulls(hulls, false, dims);
+}
+
+} // namespace anti
@@ -0,0 +1,111 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*!\file hullbuilder.h
+ * \brief Convex hulls of many point sets
+*/
+
+#ifndef HULLBUILDER_H
+#define HULLBUILDER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "geometry.h"
+#include "status.h"
+#include "vec3d.h"
+
+namespace anti {
+
+class HullContext;
+
+/// Make the convex hulls of many geometries
+/** The qhull error file and coordinate buffer are kept between hulls,
+ *  rather than being made for each one. Batches of hulls are shared out
+ *  across several threads, each with its own resources, and are returned
+ *  in input order. */
+class HullBuilder {
+private:
+  std::string qh_args;
+  int engine;
+  int num_threads;
+  std::vector<std::unique_ptr<HullContext>> contexts;
+
+  Status make_hull(Geometry &geom, bool append, int *dim, int ctx_idx);
+
+public:
+  /// Constructor
+  /**\param qh_args additional arguments to pass to qhull (unsupported,
+   *  may not work, check output.)
+   * \param engine \c HULL_QHULL or \c HULL_NATIVE.
+   * \param num_threads the maximum number of threads for a batch, if 0
+   *  then use the number of hardware threads. */
+  HullBuilder(std::string qh_args = "", int engine = HULL_QHULL,
+              int num_threads = 1);
+
+  /// Destructor
+  ~HullBuilder();
+
+  /// Set a geometry to its convex hull.
+  /** As \c Geometry::set_hull().
+   * \param geom the geometry.
+   * \param dim to return the dimension of the hull 3, 2, 1 or 0.
+   * \return status, which evaluates to \c true if the hull could be
+   *  calculated, otherwise \c false to indicate an error. */
+  Status set_hull(Geometry &geom, int *dim = nullptr);
+
+  /// Add the faces of the convex hull to a geometry.
+  /** As \c Geometry::add_hull().
+   * \param geom the geometry.
+   * \param dim to return the dimension of the hull 3, 2, 1 or 0.
+   * \return status, which evaluates to \c true if the hull could be
+   *  calculated, otherwise \c false to indicate an error. */
+  Status add_hull(Geometry &geom, int *dim = nullptr);
+
+  /// Make the convex hulls of several geometries
+  /**\param geoms the geometries, each is set to its hull, or has the
+   *  hull faces added.
+   * \param append if \c true add the hull faces, otherwise set the
+   *  geometries to their hulls.
+   * \param dims to return the dimension of each hull.
+   * \return status, which evaluates to \c false if any of the hulls could
+   *  not be calculated, with the message for the first of these. */
+  Status make_hulls(std::vector<Geometry> &geoms, bool append = false,
+                    std::vector<int> *dims = nullptr);
+
+  /// Make the convex hulls of several point sets
+  /**\param point_sets the point sets.
+   * \param hulls to return the hulls, in the order of the point sets.
+   * \param dims to return the dimension of each hull.
+   * \return status, which evaluates to \c false if any of the hulls could
+   *  not be calculated, with the message for the first of these. */
+  Status make_hulls(const std::vector<std::vector<Vec3d>> &point_sets,
+                    std::vector<Geometry> &hulls,
+                    std::vector<int> *dims = nullptr);
+};
+
+} // namespace anti
+
+#endif // HULLBUILDER_H
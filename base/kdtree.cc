@@ -0,0 +1,185 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*!\file kdtree.cc
+ * \brief Nearest point queries on a set of points
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "kdtree.h"
+
+using std::pair;
+using std::vector;
+
+namespace anti {
+
+KDTree::KDTree(const vector<Vec3d> &points)
+    : pts(points.size()), idxs(points.size()), axes(points.size())
+{
+  for (unsigned int i = 0; i < idxs.size(); i++)
+    idxs[i] = i;
+  build(points, 0, idxs.size());
+  for (unsigned int i = 0; i < idxs.size(); i++)
+    pts[i] = points[idxs[i]];
+}
+
+// Each range is split at its middle position, which holds the node point,
+// so the tree needs no child links.
+void KDTree::build(const vector<Vec3d> &points, int lo, int hi)
+{
+  if (hi - lo < 2)
+    return;
+
+  Vec3d min = points[idxs[lo]], max = min;
+  for (int i = lo + 1; i < hi; i++) {
+    const Vec3d &P = points[idxs[i]];
+    for (int j = 0; j < 3; j++) {
+      min[j] = std::min(min[j], P[j]);
+      max[j] = std::max(max[j], P[j]);
+    }
+  }
+  Vec3d spread = max - min;
+  int axis = (spread[0] >= spread[1]) ? 0 : 1;
+  if (spread[2] > spread[axis])
+    axis = 2;
+
+  int mid = (lo + hi) / 2;
+  axes[mid] = axis;
+  std::nth_element(idxs.begin() + lo, idxs.begin() + mid, idxs.begin() + hi,
+                   [&points, axis](int a, int b) {
+                     return points[a][axis] < points[b][axis];
+                   });
+
+  build(points, lo, mid);
+  build(points, mid + 1, hi);
+}
+
+// The distances below are compared as squares. The point at the middle of
+// a range is tested, then the half of the range on the side of the query
+// point, then the other half if the splitting plane is close enough.
+
+int KDTree::nearest(const Vec3d &P, double min_dist) const
+{
+  double min_d2 = (min_dist > 0) ? min_dist * min_dist : -1.0;
+  int best = -1;
+  double best_d2 = 0;
+  nearest(0, pts.size(), P, min_d2, best, best_d2);
+  return (best == -1) ? -1 : idxs[best];
+}
+
+void KDTree::nearest(int lo, int hi, const Vec3d &P, double min_d2,
+                     int &best, double &best_d2) const
+{
+  if (lo >= hi)
+    return;
+
+  int mid = (lo + hi) / 2;
+  double d2 = (pts[mid] - P).len2();
+  if (d2 >= min_d2 && (best == -1 || d2 < best_d2 ||
+                       (d2 == best_d2 && idxs[mid] < idxs[best]))) {
+    best = mid;
+    best_d2 = d2;
+  }
+
+  double diff = P[axes[mid]] - pts[mid][axes[mid]];
+  int near_lo = (diff < 0) ? lo : mid + 1;
+  int near_hi = (diff < 0) ? mid : hi;
+  int far_lo = (diff < 0) ? mid + 1 : lo;
+  int far_hi = (diff < 0) ? hi : mid;
+  nearest(near_lo, near_hi, P, min_d2, best, best_d2);
+  if (best == -1 || diff * diff <= best_d2)
+    nearest(far_lo, far_hi, P, min_d2, best, best_d2);
+}
+
+vector<int> KDTree::k_nearest(const Vec3d &P, int k) const
+{
+  // max-heap of (distance squared, index number), holding the best so far
+  vector<pair<double, int>> heap;
+  if (k > 0) {
+    heap.reserve(k + 1);
+    k_nearest(0, pts.size(), P, k, heap);
+  }
+  std::sort_heap(heap.begin(), heap.end());
+  vector<int> found(heap.size());
+  for (unsigned int i = 0; i < heap.size(); i++)
+    found[i] = heap[i].second;
+  return found;
+}
+
+void KDTree::k_nearest(int lo, int hi, const Vec3d &P, int k,
+                       vector<pair<double, int>> &heap) const
+{
+  if (lo >= hi)
+    return;
+
+  int mid = (lo + hi) / 2;
+  pair<double, int> cand((pts[mid] - P).len2(), idxs[mid]);
+  if ((int)heap.size() < k || cand < heap.front()) {
+    heap.push_back(cand);
+    std::push_heap(heap.begin(), heap.end());
+    if ((int)heap.size() > k) {
+      std::pop_heap(heap.begin(), heap.end());
+      heap.pop_back();
+    }
+  }
+
+  double diff = P[axes[mid]] - pts[mid][axes[mid]];
+  int near_lo = (diff < 0) ? lo : mid + 1;
+  int near_hi = (diff < 0) ? mid : hi;
+  int far_lo = (diff < 0) ? mid + 1 : lo;
+  int far_hi = (diff < 0) ? hi : mid;
+  k_nearest(near_lo, near_hi, P, k, heap);
+  if ((int)heap.size() < k || diff * diff <= heap.front().first)
+    k_nearest(far_lo, far_hi, P, k, heap);
+}
+
+vector<int> KDTree::in_radius(const Vec3d &P, double radius) const
+{
+  vector<int> found;
+  if (radius >= 0)
+    in_radius(0, pts.size(), P, radius * radius, found);
+  std::sort(found.begin(), found.end());
+  return found;
+}
+
+void KDTree::in_radius(int lo, int hi, const Vec3d &P, double rad2,
+                       vector<int> &found) const
+{
+  if (lo >= hi)
+    return;
+
+  int mid = (lo + hi) / 2;
+  if ((pts[mid] - P).len2() <= rad2)
+    found.push_back(idxs[mid]);
+
+  double diff = P[axes[mid]] - pts[mid][axes[mid]];
+  if (diff <= 0 || diff * diff <= rad2)
+    in_radius(lo, mid, P, rad2, found);
+  if (diff >= 0 || diff * diff <= rad2)
+    in_radius(mid + 1, hi, P, rad2, found);
+}
+
+} // namespace anti
@@ -0,0 +1,91 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*!\file kdtree.h
+ * \brief Nearest point queries on a set of points
+*/
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <vector>
+
+#include "vec3d.h"
+
+namespace anti {
+
+/// A k-d tree of points for nearest point queries
+/** The tree is built once, with a median split on the axis of greatest
+ *  spread, and holds its own copy of the points. Where points are
+ *  the same distance from the query point the lower index number is
+ *  preferred, so the results do not depend on the shape of the tree. */
+class KDTree {
+private:
+  std::vector<Vec3d> pts;  // points in tree order
+  std::vector<int> idxs;   // index number of each point in tree order
+  std::vector<char> axes;  // split axis of node at each tree position
+
+  void build(const std::vector<Vec3d> &points, int lo, int hi);
+  void nearest(int lo, int hi, const Vec3d &P, double min_d2, int &best,
+               double &best_d2) const;
+  void k_nearest(int lo, int hi, const Vec3d &P, int k,
+                 std::vector<std::pair<double, int>> &heap) const;
+  void in_radius(int lo, int hi, const Vec3d &P, double rad2,
+                 std::vector<int> &found) const;
+
+public:
+  /// Constructor
+  /**\param points the points to index. */
+  KDTree(const std::vector<Vec3d> &points);
+
+  /// Get the number of points
+  /**\return The number of points. */
+  int size() const { return (int)pts.size(); }
+
+  /// Find the nearest point
+  /**\param P the query point.
+   * \param min_dist points closer than this to \c P are not considered,
+   *  so a point of the set can be excluded with a small positive value.
+   * \return The index number of the nearest point, or \c -1 if there
+   *  is no point at a distance of at least \c min_dist. */
+  int nearest(const Vec3d &P, double min_dist = -1.0) const;
+
+  /// Find the nearest points
+  /**\param P the query point.
+   * \param k the number of points to find.
+   * \return The index numbers of the \c k nearest points (or all the
+   *  points, if there are fewer,) in order of increasing distance. */
+  std::vector<int> k_nearest(const Vec3d &P, int k) const;
+
+  /// Find the points within a distance
+  /**\param P the query point.
+   * \param radius the distance.
+   * \return The index numbers of the points whose distance from \c P is
+   *  not more than \c radius, in increasing order. */
+  std::vector<int> in_radius(const Vec3d &P, double radius) const;
+};
+
+} // namespace anti
+
+#endif // KDTREE_H
@@ -298,31 +298,32 @@ char *off_col(char *str, Color col)
   return str;
 }
 
-void off_polys_write(FILE *ofile, const Geometry &geom, int offset)
+void off_elem_write(FILE *ofile, const int *idxs, int sz, int offset,
+                    Color col)
 {
   char col_str[MSG_SZ];
-  for (unsigned int i = 0; i < geom.faces().size(); i++) {
-    fprintf(ofile, "%lu", (unsigned long)geom.faces(i).size());
-    for (unsigned int j = 0; j < geom.faces(i).size(); j++) {
-      fprintf(ofile, " %d", geom.faces(i, j) + offset);
-    }
-    fprintf(ofile, " %s", off_col(col_str, geom.colors(FACES).get(i)));
-    fprintf(ofile, "\n");
-  }
+  fprintf(ofile, "%lu", (unsigned long)sz);
+  for (int j = 0; j < sz; j++)
+    fprintf(ofile, " %d", idxs[j] + offset);
+  fprintf(ofile, " %s", off_col(col_str, col));
+  fprintf(ofile, "\n");
+}
+
+void off_polys_write(FILE *ofile, const Geometry &geom, int offset)
+{
+  for (unsigned int i = 0; i < geom.faces().size(); i++)
+    off_elem_write(ofile, geom.faces(i).data(), geom.faces(i).size(), offset,
+                   geom.colors(FACES).get(i));
+
+  for (unsigned int i = 0; i < geom.edges().size(); i++)
+    off_elem_write(ofile, geom.edges(i).data(), 2, offset,
+                   geom.colors(EDGES).get(i));
 
-  for (unsigned int i = 0; i < geom.edges().size(); i++) {
-    fprintf(ofile, "2 %d %d", geom.edges(i, 0) + offset,
-            geom.edges(i, 1) + offset);
-    fprintf(ofile, " %s", off_col(col_str, geom.colors(EDGES).get(i)));
-    fprintf(ofile, "\n");
-  }
   // print coloured vertex elements
   map<int, Color>::const_iterator mi;
   for (mi = geom.colors(VERTS).get_properties().begin();
-       mi != geom.colors(VERTS).get_properties().end(); mi++) {
-    fprintf(ofile, "1 %d %s\n", (mi->first) + offset,
-            off_col(col_str, mi->second));
-  }
+       mi != geom.colors(VERTS).get_properties().end(); mi++)
+    off_elem_write(ofile, &mi->first, 1, offset, mi->second);
 }
 
 void off_file_write(FILE *ofile, const vector<const Geometry *> &geoms,
@@ -0,0 +1,143 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*!\file offstream.cc
+ * \brief Write OFF files element by element
+*/
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "offstream.h"
+#include "private_off_file.h"
+#include "utils.h"
+
+using std::string;
+using std::vector;
+
+namespace anti {
+
+OffStreamWriter::OffStreamWriter()
+    : ofile(nullptr), sig_dgts(DEF_SIG_DGTS), num_verts(0), num_elems(0),
+      verts_written(0), elems_written(0)
+{
+}
+
+OffStreamWriter::~OffStreamWriter()
+{
+  if (ofile)
+    file_close_w(ofile);
+}
+
+Status OffStreamWriter::open(const string &file_name, int sig_dgts_val)
+{
+  if (ofile)
+    file_close_w(ofile);
+  char errmsg[MSG_SZ];
+  ofile = file_open_w(file_name, errmsg);
+  if (!ofile)
+    return Status::error(errmsg);
+
+  sig_dgts = sig_dgts_val;
+  num_verts = 0;
+  num_elems = 0;
+  verts_written = 0;
+  elems_written = 0;
+  return Status::ok();
+}
+
+void OffStreamWriter::write_header(long n_verts, long n_elems)
+{
+  num_verts = n_verts;
+  num_elems = n_elems;
+  fprintf(ofile, "OFF\n%ld %ld 0\n", num_verts, num_elems);
+}
+
+void OffStreamWriter::write_vert(const Vec3d &v)
+{
+  char line[MSG_SZ];
+  fprintf(ofile, "%s\n", vtostr(line, v, " ", sig_dgts));
+  verts_written++;
+}
+
+void OffStreamWriter::write_verts(const Geometry &geom)
+{
+  for (const auto &v : geom.verts())
+    write_vert(v);
+}
+
+void OffStreamWriter::write_face(const int *idxs, int sz, Color col)
+{
+  off_elem_write(ofile, idxs, sz, 0, col);
+  elems_written++;
+}
+
+void OffStreamWriter::write_edge(int v0, int v1, Color col)
+{
+  int idxs[] = {v0, v1};
+  off_elem_write(ofile, idxs, 2, 0, col);
+  elems_written++;
+}
+
+void OffStreamWriter::write_vert_elem(int v_idx, Color col)
+{
+  off_elem_write(ofile, &v_idx, 1, 0, col);
+  elems_written++;
+}
+
+void OffStreamWriter::write_elems(const Geometry &geom, int offset)
+{
+  off_polys_write(ofile, geom, offset);
+  elems_written += count_elems(geom);
+}
+
+long OffStreamWriter::count_elems(const Geometry &geom)
+{
+  return geom.faces().size() + geom.edges().size() +
+         geom.colors(VERTS).get_properties().size();
+}
+
+Status OffStreamWriter::close()
+{
+  if (!ofile)
+    return Status::ok();
+
+  bool write_err = fflush(ofile) != 0 || ferror(ofile);
+  file_close_w(ofile);
+  ofile = nullptr;
+  if (write_err)
+    return Status::error("error writing output file");
+  if (verts_written != num_verts || elems_written != num_elems)
+    return Status::error(
+        msg_str("output has %ld vertices and %ld elements, but the header "
+                "gives %ld vertices and %ld elements",
+                verts_written, elems_written, num_verts, num_elems));
+  if (!verts_written)
+    return Status::warning("output geometry has no vertices (empty geometry)");
+
+  return Status::ok();
+}
+
+} // namespace anti
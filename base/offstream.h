@@ -0,0 +1,138 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*!\file offstream.h
+ * \brief Write OFF files element by element
+*/
+
+#ifndef OFFSTREAM_H
+#define OFFSTREAM_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "color.h"
+#include "const.h"
+#include "geometry.h"
+#include "status.h"
+#include "vec3d.h"
+
+namespace anti {
+
+/// Write an OFF file element by element
+/** The element counts are written in the header, so they must be known
+ *  before the first vertex is written, but the model itself does not
+ *  need to be held in memory. The output is the same as writing the
+ *  model with Geometry::write() when the vertices are written in index
+ *  order, followed by the faces, the edges and the coloured vertex
+ *  elements. */
+class OffStreamWriter {
+private:
+  FILE *ofile;
+  int sig_dgts;
+  long num_verts;
+  long num_elems;
+  long verts_written;
+  long elems_written;
+
+public:
+  /// Constructor
+  OffStreamWriter();
+
+  /// Destructor, closes the file if it is open
+  ~OffStreamWriter();
+
+  OffStreamWriter(const OffStreamWriter &) = delete;
+  OffStreamWriter &operator=(const OffStreamWriter &) = delete;
+
+  /// Open the output file
+  /**\param file_name the file name, or \c "" to write to standard output.
+   * \param sig_dgts the number of significant digits to write, or if
+   *  negative then the number of digits after the decimal point.
+   * \return status, which evaluates to \c true if the file was opened,
+   *  otherwise \c false to indicate an error. */
+  Status open(const std::string &file_name, int sig_dgts = DEF_SIG_DGTS);
+
+  /// Write the header
+  /**\param n_verts the number of vertices that will be written.
+   * \param n_elems the number of face, edge and vertex elements that
+   *  will be written. */
+  void write_header(long n_verts, long n_elems);
+
+  /// Write a vertex
+  /**\param v the vertex coordinates. */
+  void write_vert(const Vec3d &v);
+
+  /// Write the vertices of a geometry
+  /**\param geom the geometry. */
+  void write_verts(const Geometry &geom);
+
+  /// Write a face
+  /**\param idxs the face index numbers.
+   * \param sz the number of index numbers.
+   * \param col the face colour. */
+  void write_face(const int *idxs, int sz, Color col = Color());
+
+  /// Write a face
+  /**\param face the face index numbers.
+   * \param col the face colour. */
+  void write_face(const std::vector<int> &face, Color col = Color())
+  {
+    write_face(face.data(), face.size(), col);
+  }
+
+  /// Write an edge
+  /**\param v0 the index number of the first vertex.
+   * \param v1 the index number of the second vertex.
+   * \param col the edge colour. */
+  void write_edge(int v0, int v1, Color col = Color());
+
+  /// Write a vertex element, to give a vertex a colour
+  /**\param v_idx the vertex index number.
+   * \param col the vertex colour. */
+  void write_vert_elem(int v_idx, Color col);
+
+  /// Write the faces, edges and coloured vertex elements of a geometry
+  /**\param geom the geometry.
+   * \param offset add this to each index number. */
+  void write_elems(const Geometry &geom, int offset = 0);
+
+  /// Get the number of elements a geometry will write
+  /**\param geom the geometry.
+   * \return The number of faces, edges and coloured vertex elements. */
+  static long count_elems(const Geometry &geom);
+
+  /// Close the output file
+  /** The file is checked for write errors, and the numbers of vertices
+   *  and elements that were written are checked against the header.
+   * \return status, which evaluates to \c true if the file was written
+   *  and closed, otherwise \c false to indicate an error. Writing no
+   *  vertices gives a warning. */
+  Status close();
+};
+
+} // namespace anti
+
+#endif // OFFSTREAM_H
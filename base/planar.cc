@@ -31,12 +31,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "planar.h"
+#include "utils.h"
 
 using std::string;
 using std::vector;
@@ -107,6 +112,147 @@ int vertex_into_geom(Geometry &geom, const Vec3d &P, Color vcol,
   return v_idx;
 }
 
+size_t VertexHash::CellHash::operator()(const Cell &c) const
+{
+  std::hash<long long> hash;
+  size_t seed = hash(c.x);
+  seed ^= hash(c.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  seed ^= hash(c.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  return seed;
+}
+
+VertexHash::VertexHash(const Geometry &geom, double eps)
+    : VertexHash(geom.verts(), eps)
+{
+}
+
+VertexHash::VertexHash(const vector<Vec3d> &verts, double eps)
+    : eps(eps), cell_sz((eps > 0) ? 2 * eps : 1.0)
+{
+  for (unsigned int i = 0; i < verts.size(); i++)
+    add(verts[i], i);
+}
+
+long long VertexHash::cell_idx(double coord) const
+{
+  // clamp, so distant points share the end cells rather than overflow.
+  // Callers reject non-finite coordinates
+  const double lim = 1e18;
+  return (long long)std::max(-lim, std::min(lim, floor(coord / cell_sz)));
+}
+
+namespace {
+bool is_finite(const Vec3d &P)
+{
+  return std::isfinite(P[0]) && std::isfinite(P[1]) && std::isfinite(P[2]);
+}
+} // namespace
+
+bool VertexHash::cell_range(const Vec3d &P, Cell &lo, Cell &hi) const
+{
+  if (!is_finite(P))
+    return false;
+  // with no tolerance only the cell holding P can hold a duplicate
+  const double rad = (eps > 0) ? eps : 0.0;
+  lo = {cell_idx(P[0] - rad), cell_idx(P[1] - rad), cell_idx(P[2] - rad)};
+  hi = {cell_idx(P[0] + rad), cell_idx(P[1] + rad), cell_idx(P[2] + rad)};
+  return true;
+}
+
+bool VertexHash::coincide(const Vec3d &P, const Vec3d &Q) const
+{
+  if (eps > 0)
+    return !compare(P, Q, eps);
+  return P[0] == Q[0] && P[1] == Q[1] && P[2] == Q[2];
+}
+
+void VertexHash::add(const Vec3d &P, int v_idx)
+{
+  if (!is_finite(P)) // can never be found
+    return;
+  // keep the index numbers in a cell in order
+  auto &cell = cells[{cell_idx(P[0]), cell_idx(P[1]), cell_idx(P[2])}];
+  if (cell.empty() || cell.back() < v_idx)
+    cell.push_back(v_idx);
+  else
+    cell.insert(std::upper_bound(cell.begin(), cell.end(), v_idx), v_idx);
+}
+
+void VertexHash::remove(const Vec3d &P, int v_idx)
+{
+  if (!is_finite(P))
+    return;
+  auto cell = cells.find({cell_idx(P[0]), cell_idx(P[1]), cell_idx(P[2])});
+  if (cell == cells.end())
+    return;
+  auto it = std::lower_bound(cell->second.begin(), cell->second.end(), v_idx);
+  if (it != cell->second.end() && *it == v_idx)
+    cell->second.erase(it);
+}
+
+int VertexHash::find(const vector<Vec3d> &verts, const Vec3d &P) const
+{
+  int v_idx = -1;
+  Cell lo, hi;
+  if (!cell_range(P, lo, hi))
+    return v_idx;
+
+  for (long long x = lo.x; x <= hi.x; x++)
+    for (long long y = lo.y; y <= hi.y; y++)
+      for (long long z = lo.z; z <= hi.z; z++) {
+        auto cell = cells.find({x, y, z});
+        if (cell == cells.end())
+          continue;
+        // the index numbers in a cell are in order
+        for (int idx : cell->second) {
+          if (v_idx != -1 && idx > v_idx)
+            break;
+          if (coincide(verts[idx], P)) {
+            v_idx = idx;
+            break;
+          }
+        }
+      }
+
+  return v_idx;
+}
+
+vector<int> VertexHash::find_all(const vector<Vec3d> &verts,
+                                 const Vec3d &P) const
+{
+  vector<int> v_idxs;
+  Cell lo, hi;
+  if (!cell_range(P, lo, hi))
+    return v_idxs;
+
+  for (long long x = lo.x; x <= hi.x; x++)
+    for (long long y = lo.y; y <= hi.y; y++)
+      for (long long z = lo.z; z <= hi.z; z++) {
+        auto cell = cells.find({x, y, z});
+        if (cell == cells.end())
+          continue;
+        for (int idx : cell->second)
+          if (coincide(verts[idx], P))
+            v_idxs.push_back(idx);
+      }
+
+  std::sort(v_idxs.begin(), v_idxs.end());
+  return v_idxs;
+}
+
+int vertex_into_geom(Geometry &geom, VertexHash &vhash, const Vec3d &P,
+                     Color vcol)
+{
+  int v_idx = vhash.find(geom.verts(), P);
+  if (v_idx == -1) {
+    geom.add_vert(P, vcol);
+    v_idx = geom.verts().size() - 1;
+    vhash.add(P, v_idx);
+  }
+
+  return v_idx;
+}
+
 // if edge already exists, do not create another one and return false. return
 // true if new edge created
 // check if edge1 and edge2 indexes are equal. If so do not allow an edge length
@@ -128,7 +274,7 @@ bool edge_into_geom(Geometry &geom, const int v_idx1, const int v_idx2,
 }
 
 // input seperate networks of overlapping edges and merge them into one network
-bool mesh_edges(Geometry &geom, const double eps)
+bool mesh_edges(Geometry &geom, const double eps, bool exact, Vec3d normal)
 {
   const vector<Vec3d> &verts = geom.verts();
   const vector<vector<int>> &edges = geom.edges();
@@ -144,48 +290,166 @@ bool mesh_edges(Geometry &geom, const double eps)
   int vsz = verts.size();
   int esz = edges.size();
 
-  vector<int> deleted_edges;
-  vector<pair<pair<int, int>, int>> new_verts;
+  // broad phase: a uniform grid over the bounding box of the vertices.
+  // Each edge is entered in every cell that lies within the margin of it,
+  // so two edges can only intersect if they share a cell. About sqrt(esz)
+  // cells on a side keeps the cell lists short for a planar diagram
+  const double margin = 2 * fabs(eps);
+  const double big = std::numeric_limits<double>::max();
+  Vec3d grid_org(big, big, big);
+  Vec3d grid_max(-big, -big, -big);
+  for (int i = 0; i < vsz; i++)
+    for (int k = 0; k < 3; k++)
+      if (std::isfinite(verts[i][k])) {
+        grid_org[k] = std::min(grid_org[k], verts[i][k]);
+        grid_max[k] = std::max(grid_max[k], verts[i][k]);
+      }
+  double grid_width = 0.0;
+  for (int k = 0; k < 3; k++)
+    if (grid_org[k] <= grid_max[k])
+      grid_width = std::max(grid_width, grid_max[k] - grid_org[k]);
+    else
+      grid_org[k] = 0.0;
+  const int grid_sz = std::min(1024, std::max(1, (int)ceil(sqrt(esz))));
+  double cell_sz = grid_width / grid_sz;
+  if (!(cell_sz > 0))
+    cell_sz = 1.0;
+  cell_sz = std::max(cell_sz, 2 * margin);
+  // a little extra, so rounding of the steps cannot miss a cell
+  const double pad = margin + cell_sz * 1e-6;
+  auto grid_idx = [&](double coord, int k) {
+    double idx = floor((coord - grid_org[k]) / cell_sz);
+    return (int)std::max(0.0, std::min(grid_sz - 1.0, idx));
+  };
+
+  // the keys of the cells of an edge, in order. The edge is taken in
+  // steps no longer than a cell, and each step covers the cells of its
+  // bounding box widened by pad. No cells for a non-finite edge
+  auto edge_cells = [&](int e, vector<uint64_t> &keys) {
+    keys.clear();
+    const Vec3d &P0 = verts[edges[e][0]];
+    const Vec3d &P1 = verts[edges[e][1]];
+    const double len = (P1 - P0).len();
+    if (!std::isfinite(len) || !std::isfinite(P0[0]) ||
+        !std::isfinite(P0[1]) || !std::isfinite(P0[2]))
+      return;
+    const int steps = std::max(1, (int)ceil(len / cell_sz));
+    for (int st = 0; st < steps; st++) {
+      Vec3d A = P0 + (P1 - P0) * ((double)st / steps);
+      Vec3d B = P0 + (P1 - P0) * ((st + 1.0) / steps);
+      int lo[3], hi[3];
+      for (int k = 0; k < 3; k++) {
+        lo[k] = grid_idx(std::min(A[k], B[k]) - pad, k);
+        hi[k] = grid_idx(std::max(A[k], B[k]) + pad, k);
+      }
+      for (int x = lo[0]; x <= hi[0]; x++)
+        for (int y = lo[1]; y <= hi[1]; y++)
+          for (int z = lo[2]; z <= hi[2]; z++)
+            keys.push_back(((uint64_t)x * grid_sz + y) * grid_sz + z);
+    }
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+  };
 
-  // compare only existing edges
+  // the edges are added in order, so each cell list is in order
+  std::unordered_map<uint64_t, vector<int>> grid;
+  vector<uint64_t> keys;
   for (int i = 0; i < esz; i++) {
-    vector<pair<double, int>> line_intersections;
-    for (int j = 0; j < esz; j++) {
-      // don't compare to self
-      if (i == j)
-        continue;
+    edge_cells(i, keys);
+    for (auto key : keys)
+      grid[key].push_back(i);
+  }
+
+  // the exact tests are made in the coordinate projection of the plane. Pairs
+  // of edges may be parallel, so without a normal use the most crossing pair
+  // of directions with the first edge
+  int proj_idx = 0;
+  if (exact) {
+    if (!normal.is_set() && esz) {
+      const Vec3d dir0 = verts[edges[0][1]] - verts[edges[0][0]];
+      normal = Vec3d(0, 0, 0);
+      for (int i = 1; i < esz; i++) {
+        Vec3d cross = vcross(dir0, verts[edges[i][1]] - verts[edges[i][0]]);
+        if (cross.len2() > normal.len2())
+          normal = cross;
+      }
+    }
+    int sign;
+    if (normal.is_set())
+      project_using_normal(normal, proj_idx, sign);
+  }
+
+  VertexHash vhash(geom, eps);
+
+  std::unordered_set<uint64_t> edge_keys;
+  auto edge_key = [](int v_idx1, int v_idx2) {
+    return ((uint64_t)std::min(v_idx1, v_idx2) << 32) |
+           (uint32_t)std::max(v_idx1, v_idx2);
+  };
+  for (const auto &edge : edges)
+    edge_keys.insert(edge_key(edge[0], edge[1]));
 
+  // as edge_into_geom(), with the existing edges found by key
+  auto add_edge = [&](int v_idx1, int v_idx2) {
+    if (v_idx1 != v_idx2 && edge_keys.insert(edge_key(v_idx1, v_idx2)).second)
+      geom.add_edge(make_edge(v_idx1, v_idx2), Color::invisible);
+  };
+
+  vector<int> deleted_edges;
+  // new vertices at i,j are stored with edge j as (i, vertex index). The
+  // edges are processed in order, so these are in order of i
+  vector<vector<pair<int, int>>> new_verts(esz);
+
+  // compare only existing edges. The candidates for edge i are the edges
+  // that share a cell with it, and cand_of marks those already taken
+  vector<int> cands;
+  vector<int> cand_of(esz, -1);
+  for (int i = 0; i < esz; i++) {
+    vector<pair<double, int>> line_intersections;
+    cands.clear();
+    edge_cells(i, keys);
+    for (auto key : keys)
+      for (int j : grid[key])
+        if (j != i && cand_of[j] != i) {
+          cand_of[j] = i;
+          cands.push_back(j);
+        }
+    sort(cands.begin(), cands.end());
+    auto new_vert = new_verts[i].begin();
+    for (int j : cands) {
       // see if the new vertex was already created
       int v_idx = -1;
-      for (auto &new_vert : new_verts) {
-        if (new_vert.first.first == i && new_vert.first.second == j) {
-          v_idx = new_vert.second;
-          break;
-        }
-      }
+      while (new_vert != new_verts[i].end() && new_vert->first < j)
+        ++new_vert;
+      if (new_vert != new_verts[i].end() && new_vert->first == j)
+        v_idx = new_vert->second;
 
       // if it doesn't already exist, see if it needs to be created
       if (v_idx == -1) {
         // compare segements P0,P1 with Q0,Q1
-        Vec3d intersection_point =
-            segments_intersection(verts[edges[i][0]], verts[edges[i][1]],
-                                  verts[edges[j][0]], verts[edges[j][1]], eps);
+        const Vec3d &P0 = verts[edges[i][0]];
+        const Vec3d &P1 = verts[edges[i][1]];
+        const Vec3d &Q0 = verts[edges[j][0]];
+        const Vec3d &Q1 = verts[edges[j][1]];
+        Vec3d intersection_point;
+        if (exact) {
+          // decide in the plane of the edges, then find the point
+          if (segments_meet_exact(P0, P1, Q0, Q1, proj_idx))
+            intersection_point = lines_intersection(P0, P1, Q0, Q1, eps);
+        }
+        else
+          intersection_point = segments_intersection(P0, P1, Q0, Q1, eps);
         if (intersection_point.is_set()) {
           // find (or create) index of this vertex
-          v_idx =
-              vertex_into_geom(geom, intersection_point, Color::invisible, eps);
+          v_idx = vertex_into_geom(geom, vhash, intersection_point,
+                                   Color::invisible);
           // don't include existing vertices
           if (v_idx < vsz)
             v_idx = -1;
-          else {
-            // store index of vert at i,j. Reverse index i,j so it will be found
-            // when encountering edges j,i
-            pair<pair<int, int>, int> new_vert;
-            new_vert.first.first = j;
-            new_vert.first.second = i;
-            new_vert.second = v_idx;
-            new_verts.push_back(new_vert);
-          }
+          else
+            // store index of vert so it will be found when encountering
+            // edges j,i
+            new_verts[j].push_back(make_pair(i, v_idx));
         }
       }
 
@@ -196,6 +460,7 @@ bool mesh_edges(Geometry &geom, const double eps)
         line_intersections.push_back(
             make_pair((verts[edges[i][0]] - verts[v_idx]).len(), v_idx));
     }
+    vector<pair<int, int>>().swap(new_verts[i]);
 
     if (line_intersections.size()) {
       // edge i will be replaced. mark it for deletion
@@ -204,14 +469,12 @@ bool mesh_edges(Geometry &geom, const double eps)
       sort(line_intersections.begin(), line_intersections.end());
       // create edgelets from P0 through intersection points to P1 (using
       // indexes)
-      edge_into_geom(geom, edges[i][0], line_intersections[0].second,
-                     Color::invisible);
+      add_edge(edges[i][0], line_intersections[0].second);
       for (unsigned int k = 0; k < line_intersections.size() - 1; k++)
-        edge_into_geom(geom, line_intersections[k].second,
-                       line_intersections[k + 1].second, Color::invisible);
-      edge_into_geom(geom,
-                     line_intersections[line_intersections.size() - 1].second,
-                     edges[i][1], Color::invisible);
+        add_edge(line_intersections[k].second,
+                 line_intersections[k + 1].second);
+      add_edge(line_intersections[line_intersections.size() - 1].second,
+               edges[i][1]);
     }
   }
 
@@ -514,8 +777,9 @@ void color_stellation_diagram(Geometry &diagram, const Geometry &geom,
 }
 
 // facelets have unresolved color map numbers
-Geometry make_stellation_diagram(Geometry &geom, int f_idx, string sym_string,
-                                 int projection_width, const double eps)
+Geometry make_stellation_diagram(const Geometry &geom, int f_idx,
+                                 string sym_string, int projection_width,
+                                 const double eps, bool exact)
 {
   const vector<vector<int>> &faces = geom.faces();
   const vector<Vec3d> &verts = geom.verts();
@@ -576,7 +840,7 @@ Geometry make_stellation_diagram(Geometry &geom, int f_idx, string sym_string,
     }
   }
 
-  mesh_edges(diagram, eps);
+  mesh_edges(diagram, eps, exact, face0_normal);
 
   // trim off edges with only one connection
   vector<int> del_verts;
@@ -599,6 +863,36 @@ Geometry make_stellation_diagram(Geometry &geom, int f_idx, string sym_string,
   return diagram;
 }
 
+void make_stellation_diagrams(map<int, Geometry> &diagrams,
+                              const Geometry &geom, const vector<int> &f_idxs,
+                              string sym_string, int projection_width,
+                              double eps, bool exact, int num_threads)
+{
+  // list the faces which do not have a diagram yet
+  vector<int> todo;
+  for (int f_idx : f_idxs) {
+    if (diagrams.count(f_idx) && diagrams[f_idx].verts().size())
+      continue;
+    if (std::find(todo.begin(), todo.end(), f_idx) == todo.end())
+      todo.push_back(f_idx);
+  }
+  if (!todo.size())
+    return;
+
+  // the diagrams for different faces are independent
+  vector<Geometry> made(todo.size());
+  parallel_for(
+      todo.size(),
+      [&](int i) {
+        made[i] = make_stellation_diagram(geom, todo[i], sym_string,
+                                          projection_width, eps, exact);
+      },
+      num_threads);
+
+  for (unsigned int i = 0; i < todo.size(); i++)
+    diagrams[todo[i]] = made[i];
+}
+
 void split_pinched_faces(Geometry &geom, double eps)
 {
   vector<vector<int>> &faces = geom.raw_faces();
@@ -978,22 +1272,11 @@ Geometry make_stellation(const Geometry &geom, map<int, Geometry> &diagrams,
 // isLeft( Point P0, Point P1, Point P2 )
 
 // RK - this works with wn_PnPoly better if a double is passed back
+// the coordinates are already projected to 2D
 
-static double isLeft(const Vec3d &P0, const Vec3d &P1, const Vec3d &P2,
-                     const int idx)
+static inline double isLeft(double P0_x, double P0_y, double P1_x,
+                            double P1_y, double P2_x, double P2_y)
 {
-  int idx1 = (idx + 1) % 3;
-  int idx2 = (idx + 2) % 3;
-
-  double P0_x = P0[idx1];
-  double P0_y = P0[idx2];
-
-  double P1_x = P1[idx1];
-  double P1_y = P1[idx2];
-
-  double P2_x = P2[idx1];
-  double P2_y = P2[idx2];
-
   return ((P1_x - P0_x) * (P2_y - P0_y) - (P2_x - P0_x) * (P1_y - P0_y));
 }
 
@@ -1066,72 +1349,199 @@ intersect
 // bool
 // wn_PnPoly( Point P, Point* V, int n )
 
-// RK - try to use same variable names as original pnpoly
 // RK - there is proof that there are mistakes when epsilon is not considered
-// RK - wn is n time too large. winding_number = wn/n
+// the edges are held in slabs of y, only edges in the slab of P are tested.
+// An edge can only cross P.y if P.y is within eps of its y-range
 
-static bool wn_PnPoly(const Geometry &polygon, const Vec3d &P, const int idx,
-                      int &winding_number, double eps)
+PolygonWinding::PolygonWinding(const vector<Vec3d> &verts,
+                               const vector<int> &face, int idx, double eps)
+    : idx1((idx + 1) % 3), idx2((idx + 2) % 3), eps(eps), exact(false),
+      use_trans(false)
 {
-  winding_number = 0;
-  if (!P.is_set() || !polygon.faces().size())
-    return false;
-
-  const vector<Vec3d> &verts = polygon.verts();
-
-  int idx2 = (idx + 2) % 3;
+  init(verts, face);
+}
 
-  double testy = P[idx2]; // P.y
+// the winding number is correct when the faces are placed on the xy-plane
+// facing z-positive
+PolygonWinding::PolygonWinding(const Geometry &polygon,
+                               const Normal &face_normal, bool find_direction,
+                               double eps)
+    : idx1(0), idx2(1), eps(eps), exact(false), use_trans(true)
+{
+  Vec3d norm = face_normal.outward().unit();
+  double z = 1;
+  if (find_direction) {
+    double test = 0.0;
+    for (int i = 2; i >= 0; i--) {
+      test = norm[i];
+      if (!double_eq(test, 0.0, eps))
+        break;
+    }
+    z = (test > 0.0) ? 1 : -1;
+  }
 
+  // rotate polygon to face forward
   const vector<int> &face = polygon.faces()[0];
+  trans = Trans3d::rotate(norm + polygon.face_cent(0), Vec3d(0, 0, z));
+  vector<Vec3d> verts(polygon.verts().size());
+  for (int v_idx : face)
+    verts[v_idx] = trans * polygon.verts(v_idx);
+  init(verts, face);
+}
+
+void PolygonWinding::init(const vector<Vec3d> &verts, const vector<int> &face)
+{
   int n = face.size();
+  slabs = 1;
+  slab_offs.assign(2, 0);
+  if (!n)
+    return;
+
+  y_min = std::numeric_limits<double>::max();
+  y_max = -std::numeric_limits<double>::max();
+  for (int v_idx : face) {
+    y_min = std::min(y_min, verts[v_idx][idx2]);
+    y_max = std::max(y_max, verts[v_idx][idx2]);
+  }
+  // allow for the eps tests, and for rounding in the tests
+  double margin = 2 * eps;
+  y_min -= margin;
+  y_max += margin;
+
+  // a few edges per slab, with a single slab for small polygons
+  slabs = (n < 32) ? 1 : std::min(n / 4, 1024);
+  vector<int> counts;
+  for (int attempt = 0; attempt < 2; attempt++) {
+    slab_scale = (y_max > y_min) ? slabs / (y_max - y_min) : 0.0;
+    counts.assign(slabs, 0);
+    long total = 0;
+    for (int i = 0; i < n; i++) {
+      double y_i = verts[face[i]][idx2];
+      double y_j = verts[face[(i + 1) % n]][idx2];
+      int first = slab_idx(std::min(y_i, y_j) - margin);
+      int last = slab_idx(std::max(y_i, y_j) + margin);
+      for (int s = first; s <= last; s++)
+        counts[s]++;
+      total += last - first + 1;
+    }
+    // long edges across many slabs, as in star polygons, give no benefit
+    if (slabs == 1 || total <= 8L * n)
+      break;
+    slabs = 1;
+  }
 
-  int wn = 0; // the winding number counter
+  slab_offs.assign(slabs + 1, 0);
+  for (int s = 0; s < slabs; s++)
+    slab_offs[s + 1] = slab_offs[s] + counts[s];
+
+  int sz = slab_offs.back();
+  x0s.resize(sz);
+  y0s.resize(sz);
+  x1s.resize(sz);
+  y1s.resize(sz);
+  vector<int> pos(slab_offs.begin(), slab_offs.end() - 1);
+  for (int i = 0; i < n; i++) {
+    const Vec3d &vert_i = verts[face[i]];           // V[i]
+    const Vec3d &vert_j = verts[face[(i + 1) % n]]; // V[[i+1]
+    int first = slab_idx(std::min(vert_i[idx2], vert_j[idx2]) - margin);
+    int last = slab_idx(std::max(vert_i[idx2], vert_j[idx2]) + margin);
+    for (int s = first; s <= last; s++) {
+      int k = pos[s]++;
+      x0s[k] = vert_i[idx1];
+      y0s[k] = vert_i[idx2];
+      x1s[k] = vert_j[idx1];
+      y1s[k] = vert_j[idx2];
+    }
+  }
+}
 
-  // loop through all edges of the polygon
-  for (int i = 0; i < n; i++) { // edge from face[i] to face[i+1]
-    int j = (i + 1) % n;
+// monotonic in y, so an edge is in every slab between those of its ends
+int PolygonWinding::slab_idx(double y) const
+{
+  int s = (int)((y - y_min) * slab_scale);
+  return std::max(0, std::min(s, slabs - 1));
+}
 
-    Vec3d vert_i = verts[face[i]]; // V[i]
-    Vec3d vert_j = verts[face[j]]; // V[[i+1]
+int PolygonWinding::winding_number_2D(double testx, double testy) const
+{
+  // no edge can cross P.y outside of the range (includes NaN)
+  if (!(testy >= y_min && testy <= y_max))
+    return 0;
 
-    double verty_i = vert_i[idx2]; // V[i].y
-    double verty_j = vert_j[idx2]; // V[i+1].y
+  int s = slab_idx(testy);
+  int wn = 0; // the winding number counter
 
-    for (int i = 0; i < n; i++) { // edge from face[i] to face[i+1]
-      // if (verty_i <= testy) {   // start y <= P.y
-      if (double_le(verty_i, testy, eps)) {
-        // if (verty_j > testy)     // an upward crossing
-        if (double_gt(verty_j, testy, eps))
-          // if (isLeft( vert_i, vert_j, P, idx ) > eps)  // P left of edge
-          if (double_gt(isLeft(vert_i, vert_j, P, idx), 0, eps))
-            ++wn; // have a valid up intersect
-      }
-      else { // start y > P.y (no test needed)
-        // if (verty_j <= testy)              // a downward crossing
-        if (double_le(verty_j, testy, eps))
-          // if (isLeft( vert_i, vert_j, P, idx ) < -eps)  // P right of edge
-          if (double_lt(isLeft(vert_i, vert_j, P, idx), 0, eps))
-            --wn; // have a valid down intersect
-      }
+  if (exact) {
+    for (int k = slab_offs[s]; k < slab_offs[s + 1]; k++) {
+      double left = orient2d(x0s[k], y0s[k], x1s[k], y1s[k], testx, testy);
+      bool start_le = y0s[k] <= testy;
+      int up = start_le && y1s[k] > testy && left > 0;
+      int down = !start_le && y1s[k] <= testy && left < 0;
+      wn += up - down;
     }
+    return wn;
   }
 
-  if (n)
-    winding_number = wn / n;
+  // loop through the edges in the slab, without branches
+  for (int k = slab_offs[s]; k < slab_offs[s + 1]; k++) {
+    double verty_i = y0s[k]; // V[i].y
+    double verty_j = y1s[k]; // V[i+1].y
+    double left = isLeft(x0s[k], verty_i, x1s[k], verty_j, testx, testy);
+    // start y <= P.y
+    bool start_le = double_le(verty_i, testy, eps);
+    // an upward crossing with P left of edge: have a valid up intersect
+    int up = start_le && double_gt(verty_j, testy, eps) &&
+             double_gt(left, 0, eps);
+    // a downward crossing with P right of edge: have a valid down intersect
+    int down = !start_le && double_le(verty_j, testy, eps) &&
+               double_lt(left, 0, eps);
+    wn += up - down;
+  }
 
-  return (wn ? true : false);
+  return wn;
 }
 
-int get_winding_number(const Geometry &polygon, const Vec3d &point, double eps)
+int PolygonWinding::get_winding_number(const Vec3d &point) const
 {
-  int winding_number;
-  wn_PnPoly(polygon, point, 2, winding_number, eps);
+  if (!point.is_set() || !x0s.size())
+    return 0;
+
+  if (use_trans) {
+    Vec3d P = trans * point;
+    return winding_number_2D(P[idx1], P[idx2]);
+  }
+  return winding_number_2D(point[idx1], point[idx2]);
+}
+
+void PolygonWinding::get_winding_numbers(const vector<Vec3d> &points,
+                                         vector<int> &winding_numbers) const
+{
+  winding_numbers.resize(points.size());
+  for (unsigned int i = 0; i < points.size(); i++)
+    winding_numbers[i] = get_winding_number(points[i]);
+}
+
+int PolygonWinding::get_max_winding_number(const vector<Vec3d> &points) const
+{
+  int winding_number = 0;
+  for (const auto &point : points) {
+    int wn = get_winding_number(point);
+    if ((abs(wn) > abs(winding_number)) ||
+        ((wn > 0) && (wn == -winding_number)))
+      winding_number = wn;
+  }
   return winding_number;
 }
 
-// the winding number is correct when the faces are placed on the xy-plane
-// facing z-positive
+int get_winding_number(const Geometry &polygon, const Vec3d &point, double eps)
+{
+  if (!polygon.faces().size())
+    return 0;
+  // projection index = 2;
+  return PolygonWinding(polygon.verts(), polygon.faces()[0], 2, eps)
+      .get_winding_number(point);
+}
+
 // geom contains one polygon
 // if points is empty, all serial triads of points in a face are tested and the
 // highest magnitude winding number is returned
@@ -1141,64 +1551,24 @@ int get_winding_number_polygon(const Geometry &polygon,
                                const Normal &face_normal, bool find_direction,
                                double eps)
 {
-  // make copies
-  Geometry pgon = polygon;
-  vector<Vec3d> pts = points;
-
-  int psz = (int)pts.size();
-  if (!psz) {
-    const vector<Vec3d> &verts = pgon.verts();
-    const vector<int> &face = pgon.faces()[0];
-
-    vector<Vec3d> triangle;
-    int fsz = (int)face.size();
-    for (int i = 0; i < fsz; i++) {
-      triangle.push_back(verts[face[i]]);
-      triangle.push_back(verts[face[(i + 1) % fsz]]);
-      triangle.push_back(verts[face[(i + 2) % fsz]]);
-      pts.push_back(centroid(triangle));
-      triangle.clear();
-    }
-    psz = (int)pts.size();
-  }
+  PolygonWinding winding(polygon, face_normal, find_direction, eps);
+  if (points.size())
+    return winding.get_max_winding_number(points);
 
-  Vec3d norm = face_normal.outward().unit();
-  double z = 1;
-  if (find_direction) {
-    double test = 0.0;
-    for (int i = 2; i >= 0; i--) {
-      test = norm[i];
-      if (!double_eq(test, 0.0, eps))
-        break;
-    }
-    z = (test > 0.0) ? 1 : -1;
-  }
-
-  // rotate polygon to face forward
-  Trans3d trans = Trans3d::rotate(norm + pgon.face_cent(0), Vec3d(0, 0, z));
-  pgon.transform(trans);
-
-  // also rotate points per matrix
-  Geometry vgeom;
-  ;
-  for (int i = 0; i < psz; i++)
-    vgeom.add_vert(pts[i]);
-  vgeom.transform(trans);
-  pts.clear();
-  for (int i = 0; i < psz; i++)
-    pts.push_back(vgeom.verts()[i]);
-  vgeom.clear_all();
+  const vector<Vec3d> &verts = polygon.verts();
+  const vector<int> &face = polygon.faces()[0];
 
-  int winding_number = 0;
-  for (int i = 0; i < psz; i++) {
-    // projection index = 2;
-    int wn = 0;
-    wn_PnPoly(pgon, pts[i], 2, wn, eps);
-    if ((abs(wn) > abs(winding_number)) ||
-        ((wn > 0) && (wn == -winding_number)))
-      winding_number = wn;
+  vector<Vec3d> pts;
+  vector<Vec3d> triangle;
+  int fsz = (int)face.size();
+  for (int i = 0; i < fsz; i++) {
+    triangle.push_back(verts[face[i]]);
+    triangle.push_back(verts[face[(i + 1) % fsz]]);
+    triangle.push_back(verts[face[(i + 2) % fsz]]);
+    pts.push_back(centroid(triangle));
+    triangle.clear();
   }
-  return winding_number;
+  return winding.get_max_winding_number(pts);
 }
 
 int find_polygon_denominator_signed(const Geometry &geom, int face_idx,
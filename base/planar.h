@@ -36,6 +36,8 @@
 #include "geometryutils.h"
 #include "vec3d.h"
 
+#include <unordered_map>
+
 using std::string;
 using std::vector;
 using std::map;
@@ -59,6 +61,84 @@ Geometry faces_to_geom(const Geometry &geom, const std::vector<int> &face_idxs);
 int vertex_into_geom(Geometry &geom, const Vec3d &P, Color vcol,
                      const double eps);
 
+/// Spatial hash of vertex coordinates, for finding coincident vertices
+/** Points are coincident if each of their coordinates differs by less
+ *  than \c eps, as for \c find_vert_by_coords(). The vertices are held
+ *  in cells of a grid, so a search only checks the few cells that are
+ *  within \c eps of the point. If \c eps is not positive only identical
+ *  coordinates coincide. Points with a non-finite coordinate are not
+ *  held, and never coincide. */
+class VertexHash {
+private:
+  struct Cell {
+    long long x, y, z;
+    bool operator==(const Cell &c) const
+    {
+      return x == c.x && y == c.y && z == c.z;
+    }
+  };
+  struct CellHash {
+    size_t operator()(const Cell &c) const;
+  };
+
+  double eps;
+  double cell_sz;
+  std::unordered_map<Cell, std::vector<int>, CellHash> cells;
+
+  long long cell_idx(double coord) const;
+  bool cell_range(const Vec3d &P, Cell &lo, Cell &hi) const;
+  bool coincide(const Vec3d &P, const Vec3d &Q) const;
+
+public:
+  /// Constructor
+  /**\param geom geometry whose vertices are added to the hash.
+   * \param eps value for contolling the limit of precision. */
+  VertexHash(const Geometry &geom, double eps);
+
+  /// Constructor
+  /**\param verts vertices which are added to the hash, with their index
+   *  numbers.
+   * \param eps value for contolling the limit of precision. */
+  VertexHash(const std::vector<Vec3d> &verts, double eps);
+
+  /// Add a vertex
+  /**\param P the vertex coordinates.
+   * \param v_idx the vertex index number, adding them in increasing
+   *  order is fastest. */
+  void add(const Vec3d &P, int v_idx);
+
+  /// Remove a vertex
+  /**\param P the vertex coordinates, as they were added.
+   * \param v_idx the vertex index number. */
+  void remove(const Vec3d &P, int v_idx);
+
+  /// Find a vertex
+  /**\param verts the vertices that were added to the hash.
+   * \param P the coordinates to find.
+   * \return The lowest index number of a vertex that coincides with
+   *  \c P, or \c -1 if there is no such vertex. */
+  int find(const std::vector<Vec3d> &verts, const Vec3d &P) const;
+
+  /// Find all vertices
+  /**\param verts the vertices that were added to the hash.
+   * \param P the coordinates to find.
+   * \return The index numbers of the vertices that coincide with \c P,
+   *  in increasing order. */
+  std::vector<int> find_all(const std::vector<Vec3d> &verts,
+                            const Vec3d &P) const;
+};
+
+/// add a vector P into the geom unless a point already occupies that point
+/** The hash must hold the vertices of \c geom, and any new vertex
+ *  is added to it.
+ * \param geom the geometry.
+ * \param vhash the spatial hash of the vertices of the geometry.
+ * \param P a point.
+ * \param vcol color of the new point.
+ * \return the index of the new point, or the occupying point. */
+int vertex_into_geom(Geometry &geom, VertexHash &vhash, const Vec3d &P,
+                     Color vcol);
+
 /// add an edge v1, v2 into the geom unless an edge of v1, v2 already exists
 /**\param geom the geometry.
  * \param v_idx1 is the first index.
@@ -71,8 +151,13 @@ bool edge_into_geom(Geometry &geom, const int v_idx1, const int v_idx2,
 /// add intersection points to all crossing edges. The input contains on faces
 /**\param geom the geometry.
  * \param eps value for contolling the limit of precision.
+ * \param exact if \c true then decide if edges cross with exact
+ *  predicates, eps is still used to place the intersection points.
+ * \param normal the normal of the plane of the edges, used with \a exact.
+ *  If it is not set then it is found from the edges.
  * \return the true if original edges were replaced. */
-bool mesh_edges(Geometry &geom, const double eps);
+bool mesh_edges(Geometry &geom, const double eps, bool exact = false,
+                Vec3d normal = Vec3d());
 
 /// Project a normal from 3D -> 2D
 /**\param normal input normal.
@@ -106,11 +191,33 @@ Vec3d calc_stellation_point(Geometry &geom, int f_idx, double eps=epsilon);
  * \param f_idx is face to make diagram.
  * \param sym_string is sub-symmetry of stellation.
  * \param projection_width is length of line extents of diagram.
- * \param eps value for contolling the limit of precision. */
-Geometry make_stellation_diagram(Geometry &geom, int f_idx,
+ * \param eps value for contolling the limit of precision.
+ * \param exact if \c true then decide if lines cross with exact
+ *  predicates. */
+Geometry make_stellation_diagram(const Geometry &geom, int f_idx,
                                  string sym_string = "",
                                  int projection_width = 500,
-                                 double eps = epsilon);
+                                 double eps = epsilon, bool exact = false);
+
+/// make stellation diagrams for several faces of a geom
+/**The diagrams are built in parallel.
+ * \param diagrams a map of stellation diagrams, diagrams are added for any
+ *  faces in \a f_idxs which are not already included.
+ * \param geom the geometry.
+ * \param f_idxs the faces to make diagrams for.
+ * \param sym_string is sub-symmetry of stellation.
+ * \param projection_width is length of line extents of diagram.
+ * \param eps value for contolling the limit of precision.
+ * \param exact if \c true then decide if lines cross with exact
+ *  predicates.
+ * \param num_threads the maximum number of threads, if 0 then use the
+ *  number of hardware threads. */
+void make_stellation_diagrams(map<int, Geometry> &diagrams,
+                              const Geometry &geom, const vector<int> &f_idxs,
+                              string sym_string = "",
+                              int projection_width = 500,
+                              double eps = epsilon, bool exact = false,
+                              int num_threads = 1);
 
 /// if faces are pinched (revisited vertices) in a geom, split them
 /**\param geom the geometry.
@@ -198,6 +305,80 @@ int get_winding_number_polygon(const Geometry &polygon,
                                bool find_direction = false,
                                const double eps = epsilon);
 
+/// Winding numbers of many points in one polygon
+/** The polygon is projected into 2D once, and its edges are held in
+ *  horizontal slabs, so a query only tests the edges whose y-range,
+ *  widened by \c eps, includes the point. The tests are the same as
+ *  those made by \c get_winding_number() and
+ *  \c get_winding_number_polygon(). */
+class PolygonWinding {
+private:
+  int idx1;
+  int idx2;
+  double eps;
+  bool exact;
+  bool use_trans;
+  Trans3d trans;
+  double y_min;
+  double y_max;
+  double slab_scale;
+  int slabs;
+  std::vector<int> slab_offs;
+  std::vector<double> x0s, y0s, x1s, y1s;
+
+  void init(const std::vector<Vec3d> &verts, const std::vector<int> &face);
+  int slab_idx(double y) const;
+  int winding_number_2D(double tx, double ty) const;
+
+public:
+  /// Constructor for a polygon projected onto a coordinate plane
+  /**\param verts the polygon vertices.
+   * \param face the polygon, as index numbers into \c verts.
+   * \param idx projection index, the polygon is projected onto the
+   *  coordinates \c idx+1 (x) and \c idx+2 (y).
+   * \param eps a small number, coordinates differing by less than eps are
+   *  the same. */
+  PolygonWinding(const std::vector<Vec3d> &verts,
+                 const std::vector<int> &face, int idx = 2,
+                 double eps = epsilon);
+
+  /// Constructor for a polygon rotated to face forward
+  /** The rotation is the one made by \c get_winding_number_polygon().
+   * \param polygon geometry containing the polygon
+   * \param face_normal the face normal
+   * \param find_direction \c true find suitable z-orientation for normal,
+   *  \c false don't reorient
+   * \param eps a small number, coordinates differing by less than eps are
+   *  the same. */
+  PolygonWinding(const Geometry &polygon, const Normal &face_normal,
+                 bool find_direction = false, double eps = epsilon);
+
+  /// Set exact tests
+  /** The edge crossing tests are made with exact predicates, rather than
+   *  to within eps. The winding number of a point on an edge then depends
+   *  on which side of the edge it is rounded to.
+   * \param exact_tests \c true for exact tests. */
+  void set_exact(bool exact_tests = true) { exact = exact_tests; }
+
+  /// Get the winding number of a point
+  /**\param point the point to test.
+   * \return The winding number. */
+  int get_winding_number(const Vec3d &point) const;
+
+  /// Get the winding numbers of several points
+  /**\param points the points to test.
+   * \param winding_numbers the winding numbers, in the order of
+   *  \c points. */
+  void get_winding_numbers(const std::vector<Vec3d> &points,
+                           std::vector<int> &winding_numbers) const;
+
+  /// Get the largest winding number of several points
+  /**\param points the points to test.
+   * \return The winding number with the largest magnitude, or +W
+   *  if both -W and +W occur. */
+  int get_max_winding_number(const std::vector<Vec3d> &points) const;
+};
+
 /// Find the (signed) denominator of a wound polygon
 /**\param geom the geometry.
  * \param face_idx face index.
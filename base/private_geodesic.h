@@ -31,12 +31,14 @@
 #ifndef GEODESIC_H
 #define GEODESIC_H
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "geometry.h"
 #include "geometryutils.h"
+#include "offstream.h"
 
 typedef std::pair<int, int> int_pr;
 inline int_pr mk_int_pr(int x, int y)
@@ -79,7 +81,11 @@ private:
   std::map<std::vector<int>, int> edge_idx;
   std::map<std::vector<int>, std::vector<int>> edge_faces;
   // std::map<std::vector<int>, int> face_idx;
-  std::map<int_pr, int> grid_idxs;
+  std::vector<int> grid_idxs;                // by i * grid_sz + j
+  int grid_sz;                               // grid_idxs rows and columns
+  std::vector<std::vector<int>> face_indxs;  // make_face_indexes() by face
+  std::vector<std::vector<int>> face_nbrs;   // neighbours by face and side
+  std::vector<int> edge_owners;              // face to set edge points
 
   void init();
   void sphere_projection(anti::Geometry &geom);
@@ -105,11 +111,18 @@ private:
     return ((m + n) * crds.first + n * crds.second) / (m * m + m * n + n * n);
   }
 
-  void grid_to_points(std::vector<int> indx, std::vector<anti::Vec3d> &gverts);
+  std::vector<anti::Vec3d> base_points();
+  long num_face_points();
+  void
+  grid_to_points(const std::vector<int> &indx,
+                 const std::vector<anti::Vec3d> &bverts,
+                 const std::function<void(int, const anti::Vec3d &)> &set_pt,
+                 bool edge_pts = true, bool face_pts = true);
   bool tri_test(int i, int j, int di, int dj);
-  void grid_to_tris(std::vector<int> indx,
-                    std::vector<std::vector<int>> &new_tris,
+  void grid_to_tris(const std::vector<int> &indx, std::vector<int> &new_tris,
                     std::vector<std::vector<int>> &orig_edges);
+  std::map<std::vector<int>, anti::Color> get_orig_edge_cols(
+      const std::vector<std::vector<std::vector<int>>> &face_orig_edges);
   std::vector<int> make_face_indexes(int i, const std::vector<int> &face);
   int index_map(int i, int j, const std::vector<int> &indx,
                 int p_idx = noindex);
@@ -130,7 +143,8 @@ public:
   enum { err_not_tri = 1 };
   Geodesic(const anti::Geometry &base_poly, int mm, int nn = 0, char mthd = 's',
            anti::Vec3d cen = anti::Vec3d(0, 0, 0));
-  void make_geo(anti::Geometry &geo);
+  void make_geo(anti::Geometry &geo, int num_threads = 1);
+  void write_geo(anti::OffStreamWriter &writer, int num_threads = 1);
 };
 
 #endif // GEODESIC_H
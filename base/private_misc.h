@@ -31,6 +31,8 @@
 #ifndef PRIVATE_MISC_H
 #define PRIVATE_MISC_H
 
+#include <stdio.h>
+
 #include <map>
 #include <string>
 #include <vector>
@@ -42,12 +44,29 @@ namespace anti {
 // triangulate.cc
 int triangulate(Geometry &geom, Color inv = Color(),
                 unsigned int winding_rule = TESS_WINDING_NONZERO,
-                std::vector<int> *fmap = nullptr);
+                std::vector<int> *fmap = nullptr, int num_threads = 1,
+                bool simple_faces = true);
 void triangulate_basic(Geometry &geom, bool sq_diag = true, Color inv = Color(),
                        std::vector<int> *fmap = nullptr);
 
-Status add_hull(Geometry &geom, std::string qh_args = "", int *dim = nullptr);
-Status set_hull(Geometry &geom, std::string qh_args = "", int *dim = nullptr);
+// c_hull.cc
+
+/// Resources kept between convex hull calculations
+class HullContext {
+public:
+  HullContext();
+  HullContext(const HullContext &) = delete;
+  HullContext &operator=(const HullContext &) = delete;
+  ~HullContext();
+
+  FILE *errfile;              ///< qhull error messages are written here
+  std::vector<double> points; ///< qhull coordinate buffer
+};
+
+Status add_hull(Geometry &geom, std::string qh_args = "", int *dim = nullptr,
+                int engine = HULL_QHULL, HullContext *ctx = nullptr);
+Status set_hull(Geometry &geom, std::string qh_args = "", int *dim = nullptr,
+                int engine = HULL_QHULL, HullContext *ctx = nullptr);
 
 /// Get Voronoi cells.
 /**Get all Voronoi cells of the vertex points which are finite polyhedra.
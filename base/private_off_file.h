@@ -58,6 +58,13 @@ bool off_file_read(std::string file_name, anti::Geometry &geom,
                    char *errmsg = nullptr);
 bool off_file_read(FILE *ifile, anti::Geometry &geom, char *errmsg = nullptr);
 
+FILE *file_open_w(std::string file_name, char *errmsg = nullptr);
+void file_close_w(FILE *ofile);
+
+void off_elem_write(FILE *ofile, const int *idxs, int sz, int offset,
+                    anti::Color col);
+void off_polys_write(FILE *ofile, const anti::Geometry &geom, int offset = 0);
+
 bool off_file_write(std::string file_name, const anti::Geometry &geom,
                     char *errmsg = nullptr, int sig_dgts = DEF_SIG_DGTS);
 void off_file_write(FILE *ofile, const anti::Geometry &geom,
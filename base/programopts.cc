@@ -36,6 +36,7 @@
 #include <string.h>
 
 using std::string;
+using std::vector;
 using std::map;
 
 namespace anti {
@@ -46,30 +47,44 @@ const char *ProgramOpts::help_ver_text =
 
 const char *ProgramOpts::prog_name() const { return program_name.c_str(); }
 
-void ProgramOpts::message(string msg, const char *msg_type, string opt) const
+string ProgramOpts::message_text(const string &msg, const char *msg_type,
+                                 const string &opt) const
 {
-  fprintf(stderr, "%s: ", prog_name());
+  string text = msg_str("%s: ", prog_name());
   if (msg_type)
-    fprintf(stderr, "%s: ", msg_type);
+    text += msg_str("%s: ", msg_type);
   if (opt != "") {
     if (opt.size() == 1 || opt[0] == '\0')
-      fprintf(stderr, "option -%s: ", opt.c_str());
+      text += msg_str("option -%s: ", opt.c_str());
     else
-      fprintf(stderr, "%s: ", opt.c_str());
+      text += msg_str("%s: ", opt.c_str());
   }
 
-  fprintf(stderr, "%s\n", msg.c_str());
+  return text + msg + "\n";
+}
+
+void ProgramOpts::message(string msg, const char *msg_type, string opt) const
+{
+  report(message_text(msg, msg_type, opt));
+}
+
+void ProgramOpts::report(const string &text) const
+{
+  if (msg_buf)
+    *msg_buf += text;
+  else
+    fputs(text.c_str(), stderr);
 }
 
 void ProgramOpts::error(std::string msg, std::string opt, int exit_num) const
 {
-  message(msg, "error", opt);
+  fputs(message_text(msg, "error", opt).c_str(), stderr);
   exit(exit_num);
 }
 
 void ProgramOpts::error(std::string msg, char opt, int exit_num) const
 {
-  message(msg, "error", std::string() + opt);
+  fputs(message_text(msg, "error", std::string() + opt).c_str(), stderr);
   exit(exit_num);
 }
 
@@ -242,4 +257,50 @@ void ProgramOpts::write_or_error(const Geometry &geom, const string &name,
     warning("output geometry has no vertices (empty geometry)");
 }
 
+string batch_file_name(const string &ofile, int model_no)
+{
+  size_t dot = ofile.find_last_of('.');
+  size_t slash = ofile.find_last_of('/');
+  if (dot == string::npos || (slash != string::npos && dot < slash))
+    dot = ofile.length();
+  return ofile.substr(0, dot) + "_" + itostr(model_no) + ofile.substr(dot);
+}
+
+Status read_batch_file(const string &batch_file, vector<vector<string>> &args,
+                       vector<int> &line_nos)
+{
+  args.clear();
+  line_nos.clear();
+  FILE *ifile = stdin;
+  if (batch_file != "-") {
+    ifile = fopen(batch_file.c_str(), "r");
+    if (!ifile)
+      return Status::error(
+          msg_str("could not open batch file '%s'", batch_file.c_str()));
+  }
+
+  char *line;
+  int line_no = 0;
+  while (read_line(ifile, &line) == 0) {
+    line_no++;
+    char *comment = strchr(line, '#');
+    if (comment)
+      *comment = '\0';
+
+    vector<char *> parts;
+    split_line(line, parts);
+    if (parts.size()) {
+      args.push_back(vector<string>(parts.begin(), parts.end()));
+      line_nos.push_back(line_no);
+    }
+    free(line);
+  }
+  free(line);
+
+  if (ifile != stdin)
+    fclose(ifile);
+
+  return Status::ok();
+}
+
 } // namespace anti
@@ -32,7 +32,11 @@
 #include "geometry.h"
 #include "getopt.h"
 #include "status.h"
+#include "utils.h"
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace anti {
 
@@ -40,6 +44,10 @@ namespace anti {
 class ProgramOpts : public GetOpt {
 private:
   std::string program_name;
+  std::string *msg_buf = nullptr;
+
+  std::string message_text(const std::string &msg, const char *msg_type,
+                           const std::string &opt) const;
 
 public:
   enum {
@@ -85,6 +93,17 @@ public:
   void message(std::string msg, const char *msg_type = nullptr,
                std::string opt = "") const;
 
+  /// Print a report (to standard error).
+  /** The text is printed as given, with no program name.
+   * \param text the text to print. */
+  void report(const std::string &text) const;
+
+  /// Collect messages and reports in a buffer rather than printing them
+  /** Messages from error() are always printed.
+   * \param buf the buffer to append the text to, or \c nullptr to print
+   *  the text to standard error. */
+  void set_message_buffer(std::string *buf) { msg_buf = buf; }
+
   /// Print an error message (to standard error) and exit.
   /** The message will be preceded by the program name, and the
    *  option letter or argument name (if given).
@@ -173,6 +192,115 @@ public:
                       int sig_dgts = DEF_SIG_DGTS);
 };
 
+/// Get the output file name of a model in a batch
+/** The model number is inserted before the file name extension, e.g.
+ *  for model 3 \c model.off becomes \c model_3.off
+ * \param ofile the output file name of the batch.
+ * \param model_no the model number.
+ * \return the output file name of the model. */
+std::string batch_file_name(const std::string &ofile, int model_no);
+
+/// Read the option lines of a batch file
+/** Each line holds the options for one model, separated by whitespace,
+ *  and a '#' starts a comment. Lines without options are skipped.
+ * \param batch_file the file name, or "-" to read standard input.
+ * \param args to return the options of each model.
+ * \param line_nos to return the line number of each model.
+ * \return status, evaluates to \c true if the file was read. */
+Status read_batch_file(const std::string &batch_file,
+                       std::vector<std::vector<std::string>> &args,
+                       std::vector<int> &line_nos);
+
+/// Make a batch of models, one for each line of options in a batch file
+/** The options of every line are processed before any model is made, so
+ *  an option error ends the program before any output is written. A line
+ *  without an output file writes to \a ofile with the model number
+ *  inserted. The models are made and written in parallel. The messages
+ *  and reports of each model are collected, and printed after all the
+ *  models are made, in line order. A model that fails does not stop the
+ *  other models being made.
+ *
+ *  \c OPTS is the options class of the program. It must have a
+ *  constructor taking the program name, and an \c ofile member holding
+ *  the output file name.
+ * \param opts the options of the program running the batch.
+ * \param batch_file the batch file name, or "-" to read standard input.
+ * \param ofile the output file name pattern, if "" then the program name
+ *  with extension \c .off is used.
+ * \param num_threads the maximum number of threads, if 0 then use the
+ *  number of hardware threads.
+ * \param make_model make a model from the options of a line. It must not
+ *  exit, but return an error status if the model cannot be made, and
+ *  print its messages and reports through the options of the line. The
+ *  code of a status that is not an error is the exit value of the model.
+ * \param check_opts if set, called with the options of each line, e.g. to
+ *  reject options that are not valid in a batch.
+ * \return the exit values of the models, combined with bitwise or. The
+ *  exit value of a model that could not be made or written is 1. */
+template <class OPTS>
+int make_batch(const ProgramOpts &opts, const std::string &batch_file,
+               const std::string &ofile, int num_threads,
+               const std::function<Status(Geometry &, OPTS &)> &make_model,
+               const std::function<void(OPTS &)> &check_opts = nullptr)
+{
+  std::vector<std::vector<std::string>> args;
+  std::vector<int> line_nos;
+  opts.print_status_or_exit(read_batch_file(batch_file, args, line_nos));
+  if (!args.size())
+    opts.warning("no models found in batch file");
+
+  std::string prog_name = opts.prog_name();
+  std::string batch_ofile = ofile.length() ? ofile : prog_name + ".off";
+  std::vector<std::unique_ptr<OPTS>> batch;
+  for (unsigned int i = 0; i < args.size(); i++) {
+    batch.push_back(std::unique_ptr<OPTS>(new OPTS(
+        msg_str("%s: batch line %d", prog_name.c_str(), line_nos[i]))));
+    OPTS &item = *batch.back();
+    std::vector<char *> argv(1, &prog_name[0]);
+    for (auto &arg : args[i])
+      argv.push_back(&arg[0]);
+    item.process_command_line(argv.size(), argv.data());
+    if (check_opts)
+      check_opts(item);
+    if (!item.ofile.length())
+      item.ofile = batch_file_name(batch_ofile, i + 1);
+  }
+
+  std::vector<std::string> msgs(batch.size());
+  std::vector<Status> stats(batch.size());
+  auto build_model = [&](int i) {
+    OPTS &item = *batch[i];
+    item.set_message_buffer(&msgs[i]);
+    Geometry geom;
+    stats[i] = make_model(geom, item);
+    if (!stats[i].is_error()) {
+      Status stat = geom.write(item.ofile);
+      if (stat.is_error())
+        stats[i] = stat;
+      else {
+        item.print_status_or_exit(stat); // not an error, so will not exit
+        if (!geom.is_set())
+          item.warning("output geometry has no vertices (empty geometry)");
+      }
+    }
+    item.set_message_buffer(nullptr);
+  };
+  parallel_for(batch.size(), build_model, num_threads);
+
+  int ret = 0;
+  for (unsigned int i = 0; i < batch.size(); i++) {
+    fputs(msgs[i].c_str(), stderr);
+    if (stats[i].is_error()) {
+      batch[i]->message(stats[i].msg(), "error");
+      ret |= 1;
+    }
+    else
+      ret |= stats[i].code();
+  }
+
+  return ret;
+}
+
 } // namespace anti
 
 #endif // PROGRAMOPTS_H
@@ -147,6 +147,7 @@ int Wenninger::get_poly(Geometry &geom, int sym)
   vector<vector<int>> idx_lists(sz);
 
   map<int, Geometry> diagrams;
+  vector<int> stellation_face_idxs;
 
   // data sizes are verified
   for (unsigned int i = 0; i < diagram_list_strings.size(); i++) {
@@ -157,14 +158,13 @@ int Wenninger::get_poly(Geometry &geom, int sym)
                   INT_MAX, false);
 
     // stellation face index is in the first position
-    int stellation_face_idx = idx_lists[i][0];
-
-    // construct the diagrams
-    if (!diagrams[stellation_face_idx].verts().size())
-      diagrams[stellation_face_idx] =
-          make_stellation_diagram(geom, stellation_face_idx, sym_str);
+    stellation_face_idxs.push_back(idx_lists[i][0]);
   }
 
+  // construct the diagrams
+  make_stellation_diagrams(diagrams, geom, stellation_face_idxs, sym_str, 500,
+                           epsilon, false, 1);
+
   bool merge_faces = true;
   bool remove_inline_verts = Wenninger_items[sym].remove_inline_verts;
   bool split_pinched = true;
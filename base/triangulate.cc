@@ -29,15 +29,20 @@
 #include <algorithm>
 #include <map>
 #include <math.h>
+#include <memory>
+#include <set>
 #include <stdio.h>
 #include <stdlib.h>
+#include <thread>
 #include <vector>
 
 #include "geometry.h"
 #include "tesselator/glu.h"
+#include "utils.h"
 
 using std::vector;
 using std::map;
+using std::set;
 
 #ifdef HAVE_CONFIG_H
 #include "../config.h"
@@ -98,39 +103,36 @@ void triangulate_basic(Geometry &geom, bool sq_diag, Color inv,
   geom.del(FACES, del_faces);
 }
 
+// The triangles of a face. New vertices made by the tesselator are held
+// with the face, and referred to in the triangles by index numbers
+// -1, -2, ... so that faces can be triangulated independently.
 struct face_tris {
-  Geometry *geom;
-  Color col;
-  Color inv;
   vector<int> idxs;
-  int e_idx;
-  vector<Vec3d *> extra_verts;
-  vector<int *> extra_idxs;
+  vector<Vec3d> new_verts;
+  vector<std::unique_ptr<int>> new_idxs; // index data for the tesselator
 
-  face_tris(Geometry *geo, Color c, Color i)
-      : geom(geo), col(c), inv(i), e_idx(-1)
-  {
-  }
-  ~face_tris()
-  {
-    update_faces();
-    for (auto &extra_vert : extra_verts)
-      delete extra_vert;
-    for (auto &extra_idx : extra_idxs)
-      delete extra_idx;
-  }
-  void update_faces();
+  void add_to_geom(Geometry &geom, Color col, Color inv,
+                   set<vector<int>> &edge_set);
 };
 
-void face_tris::update_faces()
+void face_tris::add_to_geom(Geometry &geom, Color col, Color inv,
+                            set<vector<int>> &edge_set)
 {
+  int first_new = geom.verts().size();
+  for (const auto &v : new_verts) {
+    int v_idx = geom.add_vert(v);
+    geom.colors(VERTS).set(v_idx, inv);
+  }
+
   map<vector<int>, int> edge_cnts;
+  vector<int> face(3);
   for (unsigned int i = 0; i < idxs.size() / 3; ++i) {
-    vector<int> face(3);
-    for (int j = 0; j < 3; ++j)
-      face[j] = idxs[i * 3 + j];
-    int idx = geom->add_face(face);
-    geom->colors(FACES).set(idx, col);
+    for (int j = 0; j < 3; ++j) {
+      int v_idx = idxs[i * 3 + j];
+      face[j] = (v_idx < 0) ? first_new - v_idx - 1 : v_idx;
+    }
+    int idx = geom.add_face(face);
+    geom.colors(FACES).set(idx, col);
 
     if (inv.is_set())
       for (int j = 0; j < 3; ++j)
@@ -138,15 +140,12 @@ void face_tris::update_faces()
   }
 
   if (inv.is_set()) {
-    const vector<vector<int>> &edges = geom->edges();
     map<vector<int>, int>::const_iterator mi;
     for (mi = edge_cnts.begin(); mi != edge_cnts.end(); ++mi) {
       if (mi->second == 2) { // new edge internal to a face
-        if (find(edges.begin(), edges.end(), mi->first) == edges.end()) {
-          // new edge is not an explicit edge so add as an invisible edge
-          int eidx = geom->add_edge(mi->first);
-          geom->colors(EDGES).set(eidx, inv);
-        }
+        // if new edge is not an explicit edge then add as an invisible edge
+        if (edge_set.insert(mi->first).second)
+          geom.add_edge_raw(mi->first, inv);
       }
     }
   }
@@ -165,13 +164,10 @@ extern "C" APIENTRY void tri_vert(void *vdata, void *data)
 extern "C" APIENTRY void tri_combine(localGLdouble coords[3], localGLdouble **,
                                      localGLfloat *, void **dataOut, void *data)
 {
-  auto *v = new Vec3d(coords[0], coords[1], coords[2]);
   face_tris *f_tris = (face_tris *)data;
-  auto *pidx = new int(f_tris->geom->add_vert(*v));
-  f_tris->geom->colors(VERTS).set(*pidx, f_tris->inv);
-  *dataOut = pidx;
-  f_tris->extra_verts.push_back(v);
-  f_tris->extra_idxs.push_back(pidx);
+  f_tris->new_verts.push_back(Vec3d(coords[0], coords[1], coords[2]));
+  f_tris->new_idxs.emplace_back(new int(-(int)f_tris->new_verts.size()));
+  *dataOut = f_tris->new_idxs.back().get();
 }
 
 class anti_tesselator {
@@ -209,11 +205,165 @@ bool anti_tesselator::set_winding_rule(unsigned int winding_rule)
   return true;
 }
 
+// Triangulate a face without the tesselator, if the face is simple when
+// projected onto the plane perpendicular to its Newell normal. A convex
+// face is triangulated as a fan, and other faces by ear clipping. Faces
+// with repeated vertices, collinear edges or crossing edges are left for
+// the tesselator. The triangles keep the orientation of the face. Return
+// true if the face was triangulated, with the vertex index numbers of the
+// triangles in tri_idxs.
+static bool triangulate_simple(const vector<Vec3d> &verts,
+                               const vector<int> &face, vector<int> &tri_idxs)
+{
+  const double tol = 1e-10;
+  const int fsz = face.size();
+  tri_idxs.clear();
+
+  vector<int> sorted_face = face;
+  std::sort(sorted_face.begin(), sorted_face.end());
+  if (std::adjacent_find(sorted_face.begin(), sorted_face.end()) !=
+      sorted_face.end())
+    return false;
+
+  // Newell normal, and an axis pair for the projection that makes the face
+  // turn anticlockwise
+  Vec3d norm(0, 0, 0);
+  for (int i = 0; i < fsz; i++) {
+    const Vec3d &P0 = verts[face[i]];
+    const Vec3d &P1 = verts[face[(i + 1) % fsz]];
+    norm += Vec3d((P0[1] - P1[1]) * (P0[2] + P1[2]),
+                  (P0[2] - P1[2]) * (P0[0] + P1[0]),
+                  (P0[0] - P1[0]) * (P0[1] + P1[1]));
+  }
+  if (norm.len() < tol)
+    return false;
+  norm.to_unit();
+  Vec3d x_ax = vcross(norm, (fabs(norm[0]) < 0.5) ? Vec3d::X : Vec3d::Y);
+  x_ax.to_unit();
+  Vec3d y_ax = vcross(norm, x_ax);
+
+  vector<double> xs(fsz), ys(fsz);
+  for (int i = 0; i < fsz; i++) {
+    xs[i] = vdot(verts[face[i]], x_ax);
+    ys[i] = vdot(verts[face[i]], y_ax);
+  }
+
+  // turn at each vertex, positive for a convex vertex
+  auto turn = [&](int i0, int i1, int i2) {
+    return (xs[i1] - xs[i0]) * (ys[i2] - ys[i1]) -
+           (ys[i1] - ys[i0]) * (xs[i2] - xs[i1]);
+  };
+  auto seg_len = [&](int i0, int i1) {
+    return sqrt((xs[i1] - xs[i0]) * (xs[i1] - xs[i0]) +
+                (ys[i1] - ys[i0]) * (ys[i1] - ys[i0]));
+  };
+
+  bool convex = true;
+  double ang_sum = 0;
+  for (int i = 0; i < fsz; i++) {
+    int i0 = (i + fsz - 1) % fsz;
+    int i2 = (i + 1) % fsz;
+    double len0 = seg_len(i0, i);
+    double len1 = seg_len(i, i2);
+    double trn = turn(i0, i, i2);
+    if (fabs(trn) <= tol * len0 * len1 || len0 < tol || len1 < tol)
+      return false;
+    if (trn < 0)
+      convex = false;
+    double dot = (xs[i] - xs[i0]) * (xs[i2] - xs[i]) +
+                 (ys[i] - ys[i0]) * (ys[i2] - ys[i]);
+    ang_sum += atan2(trn, dot);
+  }
+  // a simple face turns through one revolution, a star polygon through more
+  if (fabs(ang_sum - 2 * M_PI) > 0.5)
+    return false;
+
+  if (convex) {
+    tri_idxs.reserve(3 * (fsz - 2));
+    for (int i = 1; i < fsz - 1; i++) {
+      tri_idxs.push_back(face[0]);
+      tri_idxs.push_back(face[i]);
+      tri_idxs.push_back(face[i + 1]);
+    }
+    return true;
+  }
+
+  // non-adjacent edges may not meet, including at their ends
+  auto side = [&](int i0, int i1, double x, double y) {
+    return (xs[i1] - xs[i0]) * (y - ys[i0]) - (ys[i1] - ys[i0]) * (x - xs[i0]);
+  };
+  for (int i = 0; i < fsz; i++) {
+    int i1 = (i + 1) % fsz;
+    for (int j = i + 2; j < fsz; j++) {
+      int j1 = (j + 1) % fsz;
+      if (j1 == i)
+        continue;
+      double s0 = side(i, i1, xs[j], ys[j]);
+      double s1 = side(i, i1, xs[j1], ys[j1]);
+      if ((s0 > 0 && s1 > 0) || (s0 < 0 && s1 < 0))
+        continue;
+      double s2 = side(j, j1, xs[i], ys[i]);
+      double s3 = side(j, j1, xs[i1], ys[i1]);
+      if ((s2 > 0 && s3 > 0) || (s2 < 0 && s3 < 0))
+        continue;
+      return false;
+    }
+  }
+
+  // ear clipping, on a linked list of the remaining vertices
+  vector<int> prev(fsz), next(fsz);
+  for (int i = 0; i < fsz; i++) {
+    prev[i] = (i + fsz - 1) % fsz;
+    next[i] = (i + 1) % fsz;
+  }
+  auto in_tri = [&](int i0, int i1, int i2, int p) {
+    return side(i0, i1, xs[p], ys[p]) >= 0 && side(i1, i2, xs[p], ys[p]) >= 0 &&
+           side(i2, i0, xs[p], ys[p]) >= 0;
+  };
+  tri_idxs.reserve(3 * (fsz - 2));
+  int remain = fsz;
+  int cur = 0;
+  int since_ear = 0;
+  while (remain > 3) {
+    int i0 = prev[cur];
+    int i2 = next[cur];
+    bool ear = turn(i0, cur, i2) > 0;
+    for (int p = next[i2]; ear && p != i0; p = next[p])
+      if (in_tri(i0, cur, i2, p))
+        ear = false;
+    if (ear) {
+      tri_idxs.push_back(face[i0]);
+      tri_idxs.push_back(face[cur]);
+      tri_idxs.push_back(face[i2]);
+      next[i0] = i2;
+      prev[i2] = i0;
+      remain--;
+      cur = i2;
+      since_ear = 0;
+    }
+    else {
+      cur = i2;
+      if (++since_ear > remain) { // no ear found, numerical difficulty
+        tri_idxs.clear();
+        return false;
+      }
+    }
+  }
+  tri_idxs.push_back(face[prev[cur]]);
+  tri_idxs.push_back(face[cur]);
+  tri_idxs.push_back(face[next[cur]]);
+
+  return true;
+}
+
 void triangulate(Geometry &geom, Color inv, unsigned int winding,
-                 vector<int> *fmap)
+                 vector<int> *fmap, int num_threads, bool simple_faces)
 {
-  anti_tesselator tess;
-  tess.set_winding_rule(winding);
+  // A simple face has the same triangles under these rules, otherwise
+  // it has no triangles, which is left to the tesselator.
+  bool try_simple = simple_faces && (winding == TESS_WINDING_ODD ||
+                                     winding == TESS_WINDING_NONZERO ||
+                                     winding == TESS_WINDING_POSITIVE);
   vector<vector<int>> faces = geom.faces();
   vector<vector<int>> impl_edges;
   geom.get_impl_edges(impl_edges);
@@ -221,7 +371,45 @@ void triangulate(Geometry &geom, Color inv, unsigned int winding,
   fcolmap = geom.colors(FACES).get_properties();
   geom.clear(FACES);
 
+  // Triangulate the faces in blocks, each with its own tesselator, then
+  // add the triangles to the geometry in face order.
   const vector<Vec3d> &verts = geom.verts();
+  vector<face_tris> f_tris(faces.size());
+  if (num_threads <= 0)
+    num_threads = std::thread::hardware_concurrency();
+  int blocks = std::min(num_threads, (int)faces.size() / 64);
+  if (blocks < 1)
+    blocks = 1;
+  parallel_for(
+      blocks,
+      [&](int block) {
+        anti_tesselator tess;
+        tess.set_winding_rule(winding);
+        for (unsigned int i = block; i < faces.size(); i += blocks) {
+          if (faces[i].size() < 3)
+            continue;
+          vector<int> &tri_idxs = f_tris[i].idxs;
+          if (try_simple && triangulate_simple(verts, faces[i], tri_idxs))
+            continue;
+
+          localgluTessBeginPolygon(tess, &f_tris[i]);
+          for (int &j : faces[i]) {
+            double vtx[3]; // tesselator sometimes fails with doubles (?)
+            vtx[0] = (float)verts[j][0];
+            vtx[1] = (float)verts[j][1];
+            vtx[2] = (float)verts[j][2];
+            localgluTessVertex(tess, vtx, &j);
+          }
+          localgluTessEndPolygon(tess);
+          f_tris[i].new_idxs.clear();
+        }
+      },
+      blocks);
+
+  set<vector<int>> edge_set;
+  if (inv.is_set())
+    edge_set.insert(geom.edges().begin(), geom.edges().end());
+
   if (fmap)
     fmap->clear();
   for (unsigned int i = 0; i < faces.size(); i++) {
@@ -235,16 +423,8 @@ void triangulate(Geometry &geom, Color inv, unsigned int winding,
     if (mi != fcolmap.end())
       col = mi->second;
 
-    face_tris f_tris(&geom, col, inv);
-    localgluTessBeginPolygon(tess, &f_tris);
-    for (int &j : faces[i]) {
-      double vtx[3]; // tesselator sometimes fails when using doubles (?)
-      vtx[0] = (float)verts[j][0];
-      vtx[1] = (float)verts[j][1];
-      vtx[2] = (float)verts[j][2];
-      localgluTessVertex(tess, vtx, &j);
-    }
-    localgluTessEndPolygon(tess);
+    f_tris[i].add_to_geom(geom, col, inv, edge_set);
+    f_tris[i] = face_tris(); // release the memory
   }
 }
 
@@ -31,6 +31,7 @@
 #include "../config.h"
 #endif
 
+#include <atomic>
 #include <ctype.h>
 #include <limits.h>
 #include <map>
@@ -43,6 +44,7 @@
 #include <string>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <thread>
 #include <vector>
 
 #include "utils.h"
@@ -131,7 +133,8 @@ Status read_int_list(char *str, vector<int> &nums, bool is_index, int len,
 {
   nums.clear();
   int vec_idx;
-  char *v_str = strtok(str, sep);
+  char *tok_ptr;
+  char *v_str = strtok_r(str, sep, &tok_ptr);
   int i = 0;
   while (v_str) {
     i++;
@@ -145,7 +148,7 @@ Status read_int_list(char *str, vector<int> &nums, bool is_index, int len,
       return Status::error(msg_str("more than %d integers given", len));
 
     nums.push_back(vec_idx);
-    v_str = strtok(nullptr, sep);
+    v_str = strtok_r(nullptr, sep, &tok_ptr);
   }
 
   return Status::ok();
@@ -179,7 +182,8 @@ Status read_idx_list(char *str, vector<int> &nums, int num_idxs,
   nums.clear();
   int idx, idx2;
   char *p;
-  char *v_str = strtok(str, ",");
+  char *tok_ptr;
+  char *v_str = strtok_r(str, ",", &tok_ptr);
   while (v_str) {
     if ((p = strchr(v_str, '-'))) { // process a range
       *p = '\0';                    // terminate first index
@@ -218,7 +222,7 @@ Status read_idx_list(char *str, vector<int> &nums, int num_idxs,
       }
       nums.push_back(idx + extra * num_idxs);
     }
-    v_str = strtok(nullptr, ",");
+    v_str = strtok_r(nullptr, ",", &tok_ptr);
   }
 
   return Status::ok();
@@ -255,7 +259,8 @@ static Status read_double_list(char *str, vector<double> &nums, int len,
 {
   nums.clear();
   double num;
-  char *num_str = strtok(str, sep);
+  char *tok_ptr;
+  char *num_str = strtok_r(str, sep, &tok_ptr);
   int i = 0;
   while (num_str) {
     i++;
@@ -268,7 +273,7 @@ static Status read_double_list(char *str, vector<double> &nums, int len,
       return Status::error(msg_str("more than %d numbers given", len));
 
     nums.push_back(num);
-    num_str = strtok(nullptr, sep);
+    num_str = strtok_r(nullptr, sep, &tok_ptr);
   }
 
   return Status::ok();
@@ -363,12 +368,12 @@ int split_line(char *line, vector<char *> &parts, const char *delims,
     }*/
   }
   else {
-    char *val;
-    if (!(val = strtok(line, delims)))
+    char *val, *tok_ptr;
+    if (!(val = strtok_r(line, delims, &tok_ptr)))
       return 0;
 
     parts.push_back(val);
-    while ((val = strtok(nullptr, delims)))
+    while ((val = strtok_r(nullptr, delims, &tok_ptr)))
       parts.push_back(val);
   }
 
@@ -462,12 +467,12 @@ string find_alt_name(FILE *afile, const char *a_name)
     if (first_hash)
       *first_hash = '\0';
 
-    char *altname, *name;
+    char *altname, *name, *tok_ptr;
     // skip lines without =
-    if (!(altname = strtok(line, "=")))
+    if (!(altname = strtok_r(line, "=", &tok_ptr)))
       continue;
 
-    if ((name = strtok(nullptr, "\n"))) {
+    if ((name = strtok_r(nullptr, "\n", &tok_ptr))) {
       if (strcasecmp(clear_extra_whitespace(altname), aname) == 0) {
         clear_extra_whitespace(name);
         for (char *p = name; *p; p++)
@@ -606,4 +611,31 @@ string msg_str(const char *fmt, ...)
   return message;
 }
 
+void parallel_for(int num, const std::function<void(int)> &func,
+                  int num_threads)
+{
+  if (num_threads <= 0)
+    num_threads = std::thread::hardware_concurrency();
+  if (num_threads > num)
+    num_threads = num;
+  if (num_threads <= 1) {
+    for (int i = 0; i < num; i++)
+      func(i);
+    return;
+  }
+
+  std::atomic<int> next(0);
+  auto worker = [&]() {
+    for (int i = next++; i < num; i = next++)
+      func(i);
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < num_threads; i++)
+    threads.push_back(std::thread(worker));
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+}
+
 } // namespace anti
@@ -35,6 +35,7 @@
 #include "vec4d.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -302,6 +303,16 @@ inline char *vtostr(char *buf, Vec4d v, const char *sep = ", ",
 char *strcpy_msg(char *dest, const char *src);
 char *strcat_msg(char *dest, const char *src);
 
+/// Call a function for a range of indexes, using several threads
+/**The calls are shared out dynamically, so they may be made in any order.
+ * The function must only modify data that belongs to its own index.
+ * \param num the number of indexes, \a func is called for 0 to \a num-1.
+ * \param func the function to call with an index.
+ * \param num_threads the maximum number of threads, if 0 then use the
+ *  number of hardware threads. */
+void parallel_for(int num, const std::function<void(int)> &func,
+                  int num_threads = 1);
+
 // inline function definitions
 
 inline std::string itostr(int i)
@@ -195,6 +195,58 @@ bool in_segment(const Vec3d &P, const Vec3d &Q0, const Vec3d &Q1,
 Vec3d point_in_segment(const Vec3d &P, const Vec3d &Q0, const Vec3d &Q1,
                        double eps = epsilon);
 
+/// Get the orientation of three points in a plane
+/** A floating point evaluation is used when its error bound shows that
+ *  the sign is correct, otherwise the determinant is evaluated exactly.
+ * \param ax x-coordinate of the first point.
+ * \param ay y-coordinate of the first point.
+ * \param bx x-coordinate of the second point.
+ * \param by y-coordinate of the second point.
+ * \param cx x-coordinate of the third point.
+ * \param cy y-coordinate of the third point.
+ * \return A value which is positive if the points turn anticlockwise,
+ *  negative if they turn clockwise and zero if they are collinear. Only
+ *  the sign is exact. */
+double orient2d(double ax, double ay, double bx, double by, double cx,
+                double cy);
+
+/// Get the orientation of a point to the plane of three points
+/** A floating point evaluation is used when its error bound shows that
+ *  the sign is correct, otherwise the determinant is evaluated exactly.
+ * \param A first point of the plane.
+ * \param B second point of the plane.
+ * \param C third point of the plane.
+ * \param D the point to test.
+ * \return A value which is positive if \a A, \a B and \a C turn
+ *  anticlockwise when viewed from \a D, negative if they turn clockwise
+ *  and zero if the four points are coplanar. Only the sign is exact. */
+double orient3d(const Vec3d &A, const Vec3d &B, const Vec3d &C,
+                const Vec3d &D);
+
+/// Check exactly if a point of a plane lies on a segment.
+/**\param P a point.
+ * \param Q0 one end of the segment.
+ * \param Q1 the other end of the segment.
+ * \param idx the point and segment are projected onto the coordinates
+ *  \c idx+1 and \c idx+2 (the coordinate \c idx should vary least over
+ *  the plane.)
+ * \return \c true if the projected point is on the projected segment,
+ *  otherwise \c false. */
+bool in_segment_exact(const Vec3d &P, const Vec3d &Q0, const Vec3d &Q1,
+                      int idx);
+
+/// Check exactly if two segments of a plane meet.
+/**\param P0 one end of first segment.
+ * \param P1 other end of first segment.
+ * \param Q0 one end of second segment.
+ * \param Q1 other end of second segment.
+ * \param idx the segments are projected onto the coordinates \c idx+1
+ *  and \c idx+2 (the coordinate \c idx should vary least over the plane.)
+ * \return \c true if the projected segments have a point in common,
+ *  otherwise \c false. */
+bool segments_meet_exact(const Vec3d &P0, const Vec3d &P1, const Vec3d &Q0,
+                         const Vec3d &Q1, int idx);
+
 /// Get a face normal and face area
 /**\param verts a set of vertices
  * \param face the index numbers of the vertices in \a verts that make the face.
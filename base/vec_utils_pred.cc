@@ -0,0 +1,222 @@
+/*
+   Copyright (c) 2017, Adrian Rossiter
+
+   Antiprism - http://www.antiprism.com
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+      The above copyright notice and this permission notice shall be included
+      in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+*/
+
+/*
+   Name: vec_utils_pred.cc
+   Description: exact geometric predicates
+   Project: Antiprism - http://www.antiprism.com
+*/
+
+#include <float.h>
+#include <math.h>
+
+#include <algorithm>
+
+#include "vec_utils.h"
+
+namespace anti {
+
+// Expansion arithmetic after J. R. Shewchuk, "Adaptive Precision
+// Floating-Point Arithmetic and Fast Robust Geometric Predicates". An
+// expansion is a sum of doubles which do not overlap, held in order of
+// increasing magnitude, so its sign is the sign of its last term.
+namespace {
+
+// x + y = a + b exactly, with x the rounded sum
+inline void two_sum(double a, double b, double &x, double &y)
+{
+  x = a + b;
+  double b_virt = x - a;
+  double a_virt = x - b_virt;
+  y = (a - a_virt) + (b - b_virt);
+}
+
+// x + y = a * b exactly, with x the rounded product
+inline void two_product(double a, double b, double &x, double &y)
+{
+  x = a * b;
+  y = fma(a, b, -x);
+}
+
+// an expansion with space for N terms. Adding a double adds at most one
+// term, so N only needs to be the number of doubles added.
+template <int N> struct Expansion {
+  double terms[N];
+  int size = 0;
+
+  // add a double, dropping zero terms. The new terms are written in
+  // place, never ahead of the term being read.
+  void grow(double b)
+  {
+    double q = b;
+    int h_sz = 0;
+    for (int i = 0; i < size; i++) {
+      double err;
+      two_sum(q, terms[i], q, err);
+      if (err != 0.0)
+        terms[h_sz++] = err;
+    }
+    if (q != 0.0 || h_sz == 0)
+      terms[h_sz++] = q;
+    size = h_sz;
+  }
+
+  // add the product of two expansions, times sign (two doubles are added
+  // for each pair of terms)
+  template <int N0, int N1>
+  void add_product(const Expansion<N0> &e, const Expansion<N1> &f,
+                   double sign)
+  {
+    for (int i = 0; i < e.size; i++)
+      for (int j = 0; j < f.size; j++) {
+        double x, y;
+        two_product(e.terms[i], sign * f.terms[j], x, y);
+        grow(y);
+        grow(x);
+      }
+  }
+
+  // the sign of the expansion is the sign of this value
+  double sign_term() const { return terms[size - 1]; }
+};
+
+// the difference a - b as an expansion
+Expansion<2> diff_expansion(double a, double b)
+{
+  Expansion<2> e;
+  double x, y;
+  two_sum(a, -b, x, y);
+  e.grow(y);
+  e.grow(x);
+  return e;
+}
+
+// relative error bounds of the floating point orientation determinants
+const double half_eps = DBL_EPSILON / 2;
+const double orient2d_err_bound = (3.0 + 16.0 * half_eps) * half_eps;
+const double orient3d_err_bound = (7.0 + 56.0 * half_eps) * half_eps;
+
+} // namespace
+
+double orient2d(double ax, double ay, double bx, double by, double cx,
+                double cy)
+{
+  double det_left = (bx - ax) * (cy - ay);
+  double det_right = (cx - ax) * (by - ay);
+  double det = det_left - det_right;
+
+  // the sign is certain when the determinant is larger than its error
+  double err_bound = orient2d_err_bound * (fabs(det_left) + fabs(det_right));
+  if (det > err_bound || -det > err_bound)
+    return det;
+
+  Expansion<16> exact;
+  exact.add_product(diff_expansion(bx, ax), diff_expansion(cy, ay), 1.0);
+  exact.add_product(diff_expansion(cx, ax), diff_expansion(by, ay), -1.0);
+  return exact.sign_term();
+}
+
+double orient3d(const Vec3d &A, const Vec3d &B, const Vec3d &C,
+                const Vec3d &D)
+{
+  Vec3d U = B - A;
+  Vec3d V = C - A;
+  Vec3d W = D - A;
+  double det_x = U[0] * (V[1] * W[2] - V[2] * W[1]);
+  double det_y = U[1] * (V[2] * W[0] - V[0] * W[2]);
+  double det_z = U[2] * (V[0] * W[1] - V[1] * W[0]);
+  double det = det_x + det_y + det_z;
+
+  // the sign is certain when the determinant is larger than its error
+  double permanent =
+      fabs(U[0]) * (fabs(V[1] * W[2]) + fabs(V[2] * W[1])) +
+      fabs(U[1]) * (fabs(V[2] * W[0]) + fabs(V[0] * W[2])) +
+      fabs(U[2]) * (fabs(V[0] * W[1]) + fabs(V[1] * W[0]));
+  double err_bound = orient3d_err_bound * permanent;
+  if (det > err_bound || -det > err_bound)
+    return det;
+
+  Expansion<2> u[3], v[3], w[3];
+  for (int i = 0; i < 3; i++) {
+    u[i] = diff_expansion(B[i], A[i]);
+    v[i] = diff_expansion(C[i], A[i]);
+    w[i] = diff_expansion(D[i], A[i]);
+  }
+  Expansion<192> exact;
+  for (int i = 0; i < 3; i++) {
+    int i1 = (i + 1) % 3;
+    int i2 = (i + 2) % 3;
+    Expansion<8> uv1, uv2;
+    uv1.add_product(u[i], v[i1], 1.0);
+    uv2.add_product(u[i], v[i2], 1.0);
+    exact.add_product(uv1, w[i2], 1.0);
+    exact.add_product(uv2, w[i1], -1.0);
+  }
+  return exact.sign_term();
+}
+
+bool in_segment_exact(const Vec3d &P, const Vec3d &Q0, const Vec3d &Q1,
+                      int idx)
+{
+  int idx1 = (idx + 1) % 3;
+  int idx2 = (idx + 2) % 3;
+  if (orient2d(Q0[idx1], Q0[idx2], Q1[idx1], Q1[idx2], P[idx1], P[idx2]) !=
+      0.0)
+    return false;
+
+  for (int d : {idx1, idx2})
+    if (P[d] < std::min(Q0[d], Q1[d]) || P[d] > std::max(Q0[d], Q1[d]))
+      return false;
+  return true;
+}
+
+bool segments_meet_exact(const Vec3d &P0, const Vec3d &P1, const Vec3d &Q0,
+                         const Vec3d &Q1, int idx)
+{
+  int idx1 = (idx + 1) % 3;
+  int idx2 = (idx + 2) % 3;
+  auto side = [idx1, idx2](const Vec3d &A, const Vec3d &B, const Vec3d &C) {
+    double det = orient2d(A[idx1], A[idx2], B[idx1], B[idx2], C[idx1], C[idx2]);
+    return (det > 0.0) - (det < 0.0);
+  };
+
+  int P_Q0 = side(P0, P1, Q0);
+  int P_Q1 = side(P0, P1, Q1);
+  int Q_P0 = side(Q0, Q1, P0);
+  int Q_P1 = side(Q0, Q1, P1);
+  if (P_Q0 * P_Q1 > 0 || Q_P0 * Q_P1 > 0)
+    return false;
+
+  // collinear segments meet if their ranges overlap
+  if (!P_Q0 && !P_Q1 && !Q_P0 && !Q_P1) {
+    for (int d : {idx1, idx2})
+      if (std::max(P0[d], P1[d]) < std::min(Q0[d], Q1[d]) ||
+          std::max(Q0[d], Q1[d]) < std::min(P0[d], P1[d]))
+        return false;
+  }
+
+  return true;
+}
+
+} // namespace anti
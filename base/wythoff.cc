@@ -479,7 +479,8 @@ Status Wythoff::read_symbol(const char *sym)
   Status stat;
   char fracs_str[MSG_SZ];
   strncpy(fracs_str, sym_norm2.c_str(), MSG_SZ);
-  char *frac_p = strtok(fracs_str, " ");
+  char *tok_ptr;
+  char *frac_p = strtok_r(fracs_str, " ", &tok_ptr);
   for (int f = 0; f < 3; f++) {
     if (!frac_p)
       return Status::error("internal symbol parsing error");
@@ -511,7 +512,7 @@ Status Wythoff::read_symbol(const char *sym)
     fracs[2 * f] = numerator;
     fracs[2 * f + 1] = denominator % numerator;
 
-    frac_p = strtok(nullptr, " ");
+    frac_p = strtok_r(nullptr, " ", &tok_ptr);
   }
 
   bar_pos = bar_pstn; // clears failure value
@@ -909,12 +910,10 @@ static Status normalize_meta(Geometry &geom)
 
   // int part_num = 0;
   const int done = -1;
-  auto edges = geom.get_edge_face_pairs(false);
+  EdgeFaces ef(geom);
   vector<int> cur_idx(geom.faces().size(), 0);
   vector<int> prev_face(geom.faces().size(), 0);
-  vector<int> e_verts(2);
   vector<int> orig_e_verts(2);
-  vector<int> e_faces(2);
   for (unsigned int i = 0; i < geom.faces().size(); i++) {
     if (geom.faces(i).size() != 3)
       return Status::error(msg_str("face %d is not a triangle", i));
@@ -940,17 +939,15 @@ static Status normalize_meta(Geometry &geom)
 
       // read off the next edge
       const vector<int> &face = geom.faces(cur_fidx);
+      const int e_idx = ef.find(face[idx], face[(idx + 1) % face.size()]);
       orig_e_verts[0] = face[idx];
       idx = (idx + 1) % face.size();
       orig_e_verts[1] = face[idx];
       cur_idx[cur_fidx] = idx ? idx : done; // set to next idx, or mark done
 
-      e_verts = orig_e_verts;
-      if (e_verts[0] > e_verts[1])
-        swap(e_verts[0], e_verts[1]);
-      e_faces = edges.find(e_verts)->second;
-
-      int next_face = (e_faces[0] != cur_fidx) ? e_faces[0] : e_faces[1];
+      int next_face = ef.edge_face(e_idx, 0);
+      if (next_face == cur_fidx)
+        next_face = (ef.num_faces(e_idx) > 1) ? ef.edge_face(e_idx, 1) : -1;
       if (next_face >= 0 && cur_idx[next_face] == 0) { // face not looked at yet
         Color cur_col = geom.colors(FACES).get(cur_fidx);
         // Adjacent faces must be coloured differently
@@ -1188,25 +1185,18 @@ ConwayOperator conway_operator_list[]{
 
 bool Tiling::find_nbrs()
 {
-  auto ef_pairs = meta.get_edge_face_pairs(false);
+  EdgeFaces ef(meta);
 
   // Find the neighbour face opposite each VEF vertex
   nbrs.resize(meta.faces().size(), vector<int>(3));
   for (unsigned int f = 0; f < meta.faces().size(); f++)
     for (int i = 0; i < 3; i++) {
-      vector<int> e(2);
-      e[0] = meta.faces_mod(f, i + 1);
-      e[1] = meta.faces_mod(f, i + 2);
-      if (e[0] > e[1])
-        swap(e[0], e[1]);
-      auto ef_i = ef_pairs.find(e);
-      if (ef_i == ef_pairs.end())
-        return false;
-      else if (ef_i->second.size() != 2)
+      const int e_idx = ef.face_edge(f, (i + 1) % 3);
+      if (ef.num_faces(e_idx) != 2)
         nbrs[f][i] = -1; // only allow connection for two faces at an edge
       else {
-        nbrs[f][i] =
-            (ef_i->second[0] != (int)f) ? ef_i->second[0] : ef_i->second[1];
+        const int f0 = ef.edge_face(e_idx, 0);
+        nbrs[f][i] = (f0 != (int)f) ? f0 : ef.edge_face(e_idx, 1);
       }
     }
   return true;
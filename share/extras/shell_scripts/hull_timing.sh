@@ -0,0 +1,44 @@
+# Antiprism Example File - http://www.antiprism.com
+# This file may be copied, modified and redistributed
+#
+# Compare the times of the Qhull and built in convex hull engines
+#
+# Usage: hull_timing.sh [repeats]
+#
+# Each test model is hulled by conv_hull and by conv_hull -n, the given
+# number of times (default: 10). The total times are printed in seconds,
+# with the vertex, face and edge counts of each hull, which should match.
+# The times include reading the model, so the larger models show the
+# difference between the engines best.
+
+REPEATS=${1:-10}
+TIMEFORMAT=%R
+
+lat_grid -c s fcc 400 > tmp_fcc_ball.off
+lat_grid -c s fcc 400 | off_trans -R 13,27,41 > tmp_fcc_ball_rot.off
+lat_grid sc 14 > tmp_sc_cube.off
+geodesic -f 60 ico > tmp_geo_sphere.off
+off_util U75 > tmp_u75.off
+
+run_hulls()
+{
+  for i in `seq $REPEATS`; do
+    conv_hull "$@" > tmp_hull.off
+  done
+}
+
+printf "%-22s %10s %10s  %s\n" model qhull native counts
+for model in fcc_ball fcc_ball_rot sc_cube geo_sphere u75; do
+  file=tmp_$model.off
+  q_time=`{ time run_hulls $file; } 2>&1`
+  q_counts=`sed -n 2p tmp_hull.off`
+  n_time=`{ time run_hulls -n $file; } 2>&1`
+  n_counts=`sed -n 2p tmp_hull.off`
+  if [ "$q_counts" != "$n_counts" ]; then
+    n_counts="$n_counts (qhull: $q_counts)"
+  fi
+  printf "%-22s %10s %10s  %s\n" $model $q_time $n_time "$n_counts"
+done
+
+rm -f tmp_fcc_ball.off tmp_fcc_ball_rot.off tmp_sc_cube.off \
+      tmp_geo_sphere.off tmp_u75.off tmp_hull.off
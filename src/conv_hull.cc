@@ -46,8 +46,11 @@ public:
   string ifile;
   string ofile;
   string qh_args;
+  int engine;
 
-  ch_opts() : ProgramOpts("conv_hull"), append_flg(false) {}
+  ch_opts() : ProgramOpts("conv_hull"), append_flg(false), engine(HULL_QHULL)
+  {
+  }
   void process_command_line(int argc, char **argv);
   void usage();
 };
@@ -67,6 +70,8 @@ void ch_opts::usage()
 "  -a        append the convex hull to the input file\n"
 "  -Q <args> additional arguments to pass to qhull (unsupported, may not\n"
 "            work, check output)\n"
+"  -n        use the built in hull calculation, qhull is still used for\n"
+"            degenerate hulls and for -Q arguments other than A options\n"
 "  -o <file> write output to file (default: write to standard output)\n"
 "\n"
 "\n", prog_name(), help_ver_text);
@@ -80,7 +85,7 @@ void ch_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":haQ:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":haQ:no:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -97,6 +102,10 @@ void ch_opts::process_command_line(int argc, char **argv)
       qh_args = optarg;
       break;
 
+    case 'n':
+      engine = HULL_NATIVE;
+      break;
+
     default:
       error("unknown command line error");
     }
@@ -118,8 +127,9 @@ int main(int argc, char *argv[])
   opts.read_or_error(geom, opts.ifile);
 
   int dimension;
-  Status stat = (opts.append_flg) ? geom.add_hull(opts.qh_args, &dimension)
-                                  : geom.set_hull(opts.qh_args, &dimension);
+  Status stat = (opts.append_flg)
+                    ? geom.add_hull(opts.qh_args, &dimension, opts.engine)
+                    : geom.set_hull(opts.qh_args, &dimension, opts.engine);
 
   if (stat.is_error())
     opts.error(stat.msg());
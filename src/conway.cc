@@ -38,6 +38,8 @@
 
 #include <ctype.h>
 
+#include <algorithm>
+#include <chrono>
 #include <map>
 #include <set>
 #include <string>
@@ -480,6 +482,7 @@ public:
   bool planarize_method_set;
   int num_iters_planar;
   int rep_count;
+  bool defer_planarize;
   bool unitize;
   bool verbosity;
   char face_coloring_method;
@@ -503,10 +506,11 @@ public:
       : ProgramOpts("conway"), cn_string(""), resolve_ops(false),
         hart_mode(false), tile_mode(false), reverse_ops(false), operand('\0'),
         poly_size(0), planarize_method('p'), planarize_method_set(false),
-        num_iters_planar(1000), rep_count(-1), unitize(false), verbosity(false),
-        face_coloring_method('n'), face_opacity(-1), face_pattern("1"),
-        epsilon(0), vert_col(Color(255, 215, 0)), // gold
-        edge_col(Color(211, 211, 211))            // lightgrey
+        num_iters_planar(1000), rep_count(-1), defer_planarize(false),
+        unitize(false), verbosity(false), face_coloring_method('n'),
+        face_opacity(-1), face_pattern("1"), epsilon(0),
+        vert_col(Color(255, 215, 0)),  // gold
+        edge_col(Color(211, 211, 211)) // lightgrey
   {
   }
 
@@ -794,6 +798,10 @@ void cn_opts::usage()
 "               u - make faces into unit-edged regular polygons (minmax -a u)\n"
 "               x - none\n"
 "  -i <itrs> maximum inter-step planarization iterations (default: 1000)\n"
+"  -F        defer planarization. apply the operations in turn without\n"
+"               inter-step planarization, then planarize once at the end.\n"
+"               Each intermediate model is still built (-v reports time\n"
+"               and largest model size)\n"
 "  -z <n>    status reporting every n iterations, -1 for no status (default: -1)\n"
 "  -l <lim>  minimum distance change to terminate planarization, as negative\n"
 "               exponent (default: %d giving %.0e)\n"
@@ -834,7 +842,7 @@ void cn_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hHsgtruvc:p:l:i:z:f:V:E:T:O:m:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":hHsgtruvFc:p:l:i:z:f:V:E:T:O:m:o:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -977,6 +985,10 @@ void cn_opts::process_command_line(int argc, char **argv)
         error("number of planarization iterations 0 or greater", c);
       break;
 
+    case 'F':
+      defer_planarize = true;
+      break;
+
     case 'z':
       print_status_or_exit(read_int(optarg, &rep_count), c);
       if (rep_count < -1)
@@ -1158,7 +1170,7 @@ void verbose(char operation, int op_var, const cn_opts &opts)
       }
     }
 
-    string hart_operators = "agkp";
+    string hart_operators = "adgkp";
     string hart_string;
     if (opts.hart_mode && (hart_operators.find(operation) != string::npos))
       hart_string = "(hart)";
@@ -1331,30 +1343,108 @@ void get_operand(Geometry &geom, const cn_opts &opts)
   Coloring(&geom).vef_one_col(col, col, col);
 }
 
-// RK - for hart code
-void build_new_faces(map<string, map<string, string>> &faces_table,
-                     map<string, int> verts_table,
-                     vector<vector<int>> &faces_new)
+// Half-edge engine for the Hart operators
+//
+// The Hart operators name the vertices and faces they make, e.g. vertex
+// "3_17" on the edge between seed vertices 3 and 17, and face "f5" on seed
+// face 5. The order of the new faces, and the vertex that each new face
+// starts at, follow the order of these names as strings. Each name is
+// given an integer code that sorts in the same order, and an operator is
+// a rewrite of the seed half-edges into the half-edges of the new faces.
+
+// Sort codes for the names of Hart vertices and faces. A name is a lead
+// character ('0' for a name that starts with a number) followed by one
+// number, or by two numbers with a separator that sorts after the digits.
+class HartNames {
+private:
+  vector<int> end_rank; // string order of numbers that end a name
+  vector<int> sep_rank; // string order of numbers followed by a separator
+
+  void set_ranks(long n, long sz, int &end_pos, int &sep_pos)
+  {
+    // a number comes before its extensions when it ends a name, and
+    // after them when it is followed by the separator
+    end_rank[n] = end_pos++;
+    for (long d = 0; n > 0 && d < 10 && n * 10 + d < sz; d++)
+      set_ranks(n * 10 + d, sz, end_pos, sep_pos);
+    sep_rank[n] = sep_pos++;
+  }
+
+public:
+  HartNames(int sz) : end_rank(sz), sep_rank(sz)
+  {
+    int end_pos = 0;
+    int sep_pos = 0;
+    for (int d = 0; d < 10 && d < sz; d++)
+      set_ranks(d, sz, end_pos, sep_pos);
+  }
+
+  uint64_t code(char lead, int n) const
+  {
+    return ((uint64_t)lead << 56) | ((uint64_t)end_rank[n] << 28);
+  }
+
+  uint64_t code(char lead, int n0, int n1) const
+  {
+    return ((uint64_t)lead << 56) | ((uint64_t)sep_rank[n0] << 28) |
+           end_rank[n1];
+  }
+};
+
+// a new vertex, with the code of its name
+struct HartVert {
+  uint64_t name;
+  int idx;
+};
+
+// a half-edge of a new face, with the codes of the face and vertex names
+struct HartEdge {
+  uint64_t face;
+  uint64_t from;
+  HartVert to;
+};
+
+// join the half-edges into faces. If a face has several half-edges from
+// the same vertex then the last one is used
+void build_new_faces(vector<HartEdge> &hes, vector<vector<int>> &faces_new)
 {
-  map<string, map<string, string>>::iterator ft;
-  map<string, string>::iterator ftm;
-  string face_name;
-  for (ft = faces_table.begin(); ft != faces_table.end(); ft++) {
-    for (ftm = ft->second.begin(); ftm != ft->second.end(); ftm++) {
-      if (face_name != ft->first) {
-        face_name = ft->first;
-        string v0 = faces_table[face_name][ftm->first];
-        string v = v0;
-        vector<int> face;
-        do {
-          face.push_back(verts_table[v]);
-          v = faces_table[face_name][v];
-        } while (v != v0);
-        if (face.size() > 2) // make sure face is valid
-          faces_new.push_back(face);
-        face.clear();
+  std::stable_sort(hes.begin(), hes.end(),
+                   [](const HartEdge &he0, const HartEdge &he1) {
+                     return he0.face < he1.face ||
+                            (he0.face == he1.face && he0.from < he1.from);
+                   });
+
+  auto f_beg = hes.begin();
+  while (f_beg != hes.end()) {
+    auto f_end = f_beg;
+    while (f_end != hes.end() && f_end->face == f_beg->face)
+      ++f_end;
+
+    auto find_from = [&](uint64_t v) {
+      auto it = std::upper_bound(
+          f_beg, f_end, v,
+          [](uint64_t v, const HartEdge &he) { return v < he.from; });
+      return (it != f_beg && (it - 1)->from == v) ? it - 1 : f_end;
+    };
+
+    // start at the vertex that follows the first vertex name in the face
+    auto he = find_from(f_beg->from);
+    const uint64_t v0 = he->to.name;
+    vector<int> face;
+    bool closed = true;
+    do {
+      face.push_back(he->to.idx);
+      he = find_from(he->to.name);
+      if (he == f_end || face.size() > (size_t)(f_end - f_beg)) {
+        closed = false;
+        break;
       }
-    }
+    } while (he->to.name != v0);
+
+    if (closed && face.size() > 2) // make sure face is valid
+      faces_new.push_back(face);
+
+    f_beg = f_end;
   }
 }
 
@@ -1364,42 +1454,78 @@ void hart_ambo(Geometry &geom)
   vector<vector<int>> &faces = geom.raw_faces();
   vector<Vec3d> &verts = geom.raw_verts();
 
-  map<string, int> verts_table;
-  map<string, map<string, string>> faces_table;
-  vector<Vec3d> verts_new;
+  EdgeFaces ef(geom);
+  HartNames names(std::max(verts.size(), faces.size()));
 
-  char buf1[MSG_SZ], buf2[MSG_SZ], buf3[MSG_SZ];
-  unsigned int vert_num = 0;
+  // vertex "v1_v2" on each edge, made from the side where v1 < v2
+  vector<int> e_verts(ef.num_edges(), 0);
+  vector<Vec3d> verts_new;
   for (unsigned int i = 0; i < faces.size(); i++) {
-    int v1 = faces[i].at(faces[i].size() - 2);
-    int v2 = faces[i].at(faces[i].size() - 1);
-    for (unsigned int j = 0; j < faces[i].size(); j++) {
-      int v3 = faces[i].at(j);
-      if (v1 < v2) {
-        sprintf(buf1, "%d_%d", (v1 < v2) ? v1 : v2, (v1 > v2) ? v1 : v2);
-        verts_table[buf1] = vert_num++;
-        verts_new.push_back((verts[v1] + verts[v2]) * 0.5);
+    int sz = faces[i].size();
+    for (int j = 0; j < sz; j++) {
+      int he = ef.face_start(i) + (j + 2 * sz - 2) % sz;
+      if (!ef.half_edge_reversed(he)) {
+        int e = ef.half_edge_edge(he);
+        e_verts[e] = verts_new.size();
+        verts_new.push_back((verts[ef.edge_v(e, 0)] + verts[ef.edge_v(e, 1)]) *
+                            0.5);
       }
-      sprintf(buf1, "f%d", i);
-      sprintf(buf2, "%d_%d", (v1 < v2) ? v1 : v2, (v1 > v2) ? v1 : v2);
-      sprintf(buf3, "%d_%d", (v2 < v3) ? v2 : v3, (v2 > v3) ? v2 : v3);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf1, "v%d", v2);
-      sprintf(buf2, "%d_%d", (v2 < v3) ? v2 : v3, (v2 > v3) ? v2 : v3);
-      sprintf(buf3, "%d_%d", (v1 < v2) ? v1 : v2, (v1 > v2) ? v1 : v2);
-      faces_table[buf1][buf2] = buf3;
-      v1 = v2;
-      v2 = v3;
+    }
+  }
+
+  auto e_vert = [&](int he) {
+    int e = ef.half_edge_edge(he);
+    return HartVert{names.code('0', ef.edge_v(e, 0), ef.edge_v(e, 1)),
+                    e_verts[e]};
+  };
+
+  vector<HartEdge> hes;
+  hes.reserve(2 * ef.num_half_edges());
+  for (unsigned int i = 0; i < faces.size(); i++) {
+    int sz = faces[i].size();
+    for (int j = 0; j < sz; j++) {
+      int he12 = ef.face_start(i) + (j + 2 * sz - 2) % sz;
+      int he23 = ef.face_start(i) + (j + sz - 1) % sz;
+      HartVert v12 = e_vert(he12);
+      HartVert v23 = e_vert(he23);
+      int v2 = faces[i][(j + sz - 1) % sz];
+      hes.push_back({names.code('f', i), v12.name, v23});
+      hes.push_back({names.code('v', v2), v23.name, v12});
     }
   }
 
   geom.clear_all();
   verts = verts_new;
-  verts_new.clear();
+  build_new_faces(hes, faces);
+}
 
-  build_new_faces(faces_table, verts_table, faces);
-  faces_table.clear();
-  verts_table.clear();
+// index number of the directed vertex "v1~v2" for a half-edge v1 to v2,
+// and the directed vertex "v2~v1" for the same edge is this number xor 1
+static int directed_idx(const EdgeFaces &ef, int he)
+{
+  return 2 * ef.half_edge_edge(he) + ef.half_edge_reversed(he);
+}
+
+// add the directed vertices "v1~v2" at approx. (2/3)v1 + (1/3)v2, one for
+// each side of each face, and return their index numbers
+static vector<int> add_directed_verts(const Geometry &geom,
+                                      const EdgeFaces &ef,
+                                      vector<Vec3d> &verts_new)
+{
+  const vector<vector<int>> &faces = geom.faces();
+  const vector<Vec3d> &verts = geom.verts();
+  vector<int> d_verts(2 * ef.num_edges(), 0);
+  for (unsigned int i = 0; i < faces.size(); i++) {
+    int sz = faces[i].size();
+    for (int j = 0; j < sz; j++) {
+      int v1 = faces[i][(j + 2 * sz - 2) % sz];
+      int v2 = faces[i][(j + sz - 1) % sz];
+      int he12 = ef.face_start(i) + (j + 2 * sz - 2) % sz;
+      d_verts[directed_idx(ef, he12)] = verts_new.size();
+      verts_new.push_back(verts[v1] * 0.7 + verts[v2] * 0.3);
+    }
+  }
+  return d_verts;
 }
 
 void hart_gyro(Geometry &geom)
@@ -1407,66 +1533,48 @@ void hart_gyro(Geometry &geom)
   vector<vector<int>> &faces = geom.raw_faces();
   vector<Vec3d> &verts = geom.raw_verts();
 
-  map<string, int> verts_table;
-  map<string, map<string, string>> faces_table;
-  vector<Vec3d> verts_new;
+  EdgeFaces ef(geom);
+  HartNames names(std::max(verts.size(), faces.size()));
 
-  char buf1[MSG_SZ], buf2[MSG_SZ], buf3[MSG_SZ];
-  unsigned int vert_num = 0;
+  // vertices "f" on the face centres, then "v" on the seed vertices
+  vector<Vec3d> verts_new;
   vector<Vec3d> centers;
   geom.face_cents(centers);
-  for (unsigned int i = 0; i < faces.size(); i++) {
-    sprintf(buf1, "f%d", i);
-    verts_table[buf1] = vert_num++;
+  for (unsigned int i = 0; i < faces.size(); i++)
     verts_new.push_back(centers[i].unit());
-  }
   centers.clear();
 
-  for (unsigned int i = 0; i < verts.size(); i++) {
-    sprintf(buf1, "v%d", i);
-    verts_table[buf1] = vert_num++;
-    verts_new.push_back(verts[i]);
-  }
+  verts_new.insert(verts_new.end(), verts.begin(), verts.end());
+  vector<int> d_verts = add_directed_verts(geom, ef, verts_new);
 
+  vector<HartEdge> hes;
+  hes.reserve(5 * ef.num_half_edges());
   for (unsigned int i = 0; i < faces.size(); i++) {
-    int v1 = faces[i].at(faces[i].size() - 2);
-    int v2 = faces[i].at(faces[i].size() - 1);
-    for (unsigned int j = 0; j < faces[i].size(); j++) {
-      int v3 = faces[i].at(j);
-      sprintf(buf1, "%d~%d", v1, v2);
-      verts_table[buf1] = vert_num++;
-      // approx. (2/3)v1 + (1/3)v2
-      verts_new.push_back(verts[v1] * 0.7 + verts[v2] * 0.3);
-
-      sprintf(buf1, "%df%d", i, v1);
-      sprintf(buf2, "f%d", i);
-      sprintf(buf3, "%d~%d", v1, v2);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf2, "%d~%d", v1, v2);
-      sprintf(buf3, "%d~%d", v2, v1);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf2, "%d~%d", v2, v1);
-      sprintf(buf3, "v%d", v2);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf2, "v%d", v2);
-      sprintf(buf3, "%d~%d", v2, v3);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf2, "%d~%d", v2, v3);
-      sprintf(buf3, "f%d", i);
-      faces_table[buf1][buf2] = buf3;
-
-      v1 = v2;
-      v2 = v3;
+    int sz = faces[i].size();
+    for (int j = 0; j < sz; j++) {
+      int v1 = faces[i][(j + 2 * sz - 2) % sz];
+      int v2 = faces[i][(j + sz - 1) % sz];
+      int v3 = faces[i][j];
+      int d12 = directed_idx(ef, ef.face_start(i) + (j + 2 * sz - 2) % sz);
+      int d23 = directed_idx(ef, ef.face_start(i) + (j + sz - 1) % sz);
+      HartVert f_i = {names.code('f', i), (int)i};
+      HartVert v_v2 = {names.code('v', v2), (int)faces.size() + v2};
+      HartVert v12 = {names.code('0', v1, v2), d_verts[d12]};
+      HartVert v21 = {names.code('0', v2, v1), d_verts[d12 ^ 1]};
+      HartVert v23 = {names.code('0', v2, v3), d_verts[d23]};
+
+      uint64_t face = names.code('0', i, v1);
+      hes.push_back({face, f_i.name, v12});
+      hes.push_back({face, v12.name, v21});
+      hes.push_back({face, v21.name, v_v2});
+      hes.push_back({face, v_v2.name, v23});
+      hes.push_back({face, v23.name, f_i});
     }
   }
 
   geom.clear_all();
   verts = verts_new;
-  verts_new.clear();
-
-  build_new_faces(faces_table, verts_table, faces);
-  faces_table.clear();
-  verts_table.clear();
+  build_new_faces(hes, faces);
 }
 
 void hart_kisN(Geometry &geom, int n)
@@ -1513,65 +1621,65 @@ void hart_kisN(Geometry &geom, int n)
   }
 }
 
+// dual with the new vertices at the face centroids, the faces are made
+// from the half-edges of the model
+void hart_dual(Geometry &geom)
+{
+  Geometry dual;
+  get_dual(dual, geom);
+
+  vector<Vec3d> centers;
+  geom.face_cents(centers);
+
+  geom.clear_all();
+  geom.raw_verts() = centers;
+  geom.raw_faces() = dual.faces();
+}
+
 void hart_propellor(Geometry &geom)
 {
   vector<vector<int>> &faces = geom.raw_faces();
   vector<Vec3d> &verts = geom.raw_verts();
 
-  map<string, int> verts_table;
-  map<string, map<string, string>> faces_table;
-  vector<Vec3d> verts_new;
+  EdgeFaces ef(geom);
+  HartNames names(std::max(verts.size(), faces.size()));
 
-  char buf1[MSG_SZ], buf2[MSG_SZ], buf3[MSG_SZ];
-  unsigned int vert_num = 0;
-  for (unsigned int i = 0; i < verts.size(); i++) {
-    sprintf(buf1, "v%d", i);
-    verts_table[buf1] = vert_num++;
+  // vertices "v" on the seed vertices
+  vector<Vec3d> verts_new;
+  for (unsigned int i = 0; i < verts.size(); i++)
     verts_new.push_back(verts[i].unit());
-  }
 
-  for (unsigned int i = 0; i < faces.size(); i++) {
-    int v1 = faces[i].at(faces[i].size() - 2);
-    int v2 = faces[i].at(faces[i].size() - 1);
-    for (unsigned int j = 0; j < faces[i].size(); j++) {
-      int v3 = faces[i].at(j);
-      sprintf(buf1, "%d~%d", v1, v2);
-      verts_table[buf1] = vert_num++;
-      // approx. (2/3)v1 + (1/3)v2
-      verts_new.push_back(verts[v1] * 0.7 + verts[v2] * 0.3);
+  vector<int> d_verts = add_directed_verts(geom, ef, verts_new);
 
-      sprintf(buf1, "v%d", i);
-      sprintf(buf2, "%d~%d", v1, v2);
-      sprintf(buf3, "%d~%d", v2, v3);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf1, "%df%d", i, v2);
-      sprintf(buf2, "%d~%d", v1, v2);
-      sprintf(buf3, "%d~%d", v2, v1);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf2, "%d~%d", v2, v1);
-      sprintf(buf3, "v%d", v2);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf2, "v%d", v2);
-      sprintf(buf3, "%d~%d", v2, v3);
-      faces_table[buf1][buf2] = buf3;
-      sprintf(buf2, "%d~%d", v2, v3);
-      sprintf(buf3, "%d~%d", v1, v2);
-      faces_table[buf1][buf2] = buf3;
-
-      v1 = v2;
-      v2 = v3;
+  vector<HartEdge> hes;
+  hes.reserve(5 * ef.num_half_edges());
+  for (unsigned int i = 0; i < faces.size(); i++) {
+    int sz = faces[i].size();
+    for (int j = 0; j < sz; j++) {
+      int v1 = faces[i][(j + 2 * sz - 2) % sz];
+      int v2 = faces[i][(j + sz - 1) % sz];
+      int v3 = faces[i][j];
+      int d12 = directed_idx(ef, ef.face_start(i) + (j + 2 * sz - 2) % sz);
+      int d23 = directed_idx(ef, ef.face_start(i) + (j + sz - 1) % sz);
+      HartVert v_v2 = {names.code('v', v2), v2};
+      HartVert v12 = {names.code('0', v1, v2), d_verts[d12]};
+      HartVert v21 = {names.code('0', v2, v1), d_verts[d12 ^ 1]};
+      HartVert v23 = {names.code('0', v2, v3), d_verts[d23]};
+
+      hes.push_back({names.code('v', i), v12.name, v23});
+
+      uint64_t face = names.code('0', i, v2);
+      hes.push_back({face, v12.name, v21});
+      hes.push_back({face, v21.name, v_v2});
+      hes.push_back({face, v_v2.name, v23});
+      hes.push_back({face, v23.name, v12});
     }
   }
 
   geom.clear_all();
   verts = verts_new;
-  verts_new.clear();
-
-  build_new_faces(faces_table, verts_table, faces);
-  faces_table.clear();
-  verts_table.clear();
+  build_new_faces(hes, faces);
 }
-
 /*
 // chamfer for hart code
 void hart_chamfer(Geometry &geom, const cn_opts &opts)
@@ -1648,7 +1756,8 @@ void antiprism_truncate(Geometry &geom, double ratio, int n)
 }
 
 void orient_planar(Geometry &geom, bool &is_orientable,
-                   bool &orientation_positive, const cn_opts &opts)
+                   bool &orientation_positive, const cn_opts &opts,
+                   bool planarize = true)
 {
   // local copy
   char planarize_method = opts.planarize_method;
@@ -1667,14 +1776,20 @@ void orient_planar(Geometry &geom, bool &is_orientable,
     // orientation is reversed if reflected 1=positive 2=negative
     geom.orient((orientation_positive) ? 1 : 2);
 
-  // planarize after each step
-  cn_planarize(geom, planarize_method, opts);
+  // planarize after each step, unless it is deferred to the end. A deferred
+  // step only keeps the model in shape for the final planarization, so
+  // leave the model unchanged if there won't be one
+  if (planarize)
+    cn_planarize(geom, planarize_method, opts);
+  else if (opts.num_iters_planar != 0 && opts.planarize_method != 'x' &&
+           planarize_method != 'u' && !opts.tile_mode)
+    project_onto_sphere(geom);
 }
 
 // is_orientable and orientation_positive can change
 void wythoff(Geometry &geom, char operation, int op_var, int &operation_number,
              bool &is_orientable, bool &orientation_positive,
-             const cn_opts &opts)
+             const cn_opts &opts, bool planarize)
 {
   operation_number++;
 
@@ -1766,10 +1881,9 @@ void wythoff(Geometry &geom, char operation, int op_var, int &operation_number,
     geom.del(VERTS, geom.get_info().get_free_verts());
 
     // check for 3 faces at an edge
-    auto efpairs = geom.get_edge_face_pairs(false);
-    map<vector<int>, vector<int>>::const_iterator ei;
-    for (ei = efpairs.begin(); ei != efpairs.end(); ++ei) {
-      if (ei->second.size() > 2) {
+    EdgeFaces ef(geom);
+    for (int e = 0; e < ef.num_edges(); e++) {
+      if (ef.num_faces(e) > 2) {
         opts.warning("3 or more faces to an edge");
         break;
       }
@@ -1801,7 +1915,7 @@ void wythoff(Geometry &geom, char operation, int op_var, int &operation_number,
     }
   }
 
-  orient_planar(geom, is_orientable, orientation_positive, opts);
+  orient_planar(geom, is_orientable, orientation_positive, opts, planarize);
 }
 
 void do_operations(Geometry &geom, cn_opts &opts)
@@ -1822,6 +1936,13 @@ void do_operations(Geometry &geom, cn_opts &opts)
 
   centroid_to_origin(geom);
 
+  // with deferred planarization each operation is still applied in turn,
+  // but the model is planarized once, after the last operation
+  bool planarize = !opts.defer_planarize;
+  auto start_time = std::chrono::steady_clock::now();
+  unsigned int max_verts = geom.verts().size();
+  unsigned int max_faces = geom.faces().size();
+
   for (auto operation : opts.operations) {
     verbose(operation->op, operation->op_var, opts);
 
@@ -1837,6 +1958,11 @@ void do_operations(Geometry &geom, cn_opts &opts)
         hart_ambo(geom);
         break;
 
+      // dual
+      case 'd':
+        hart_dual(geom);
+        break;
+
       // gyro
       case 'g':
         hart_gyro(geom);
@@ -1860,21 +1986,38 @@ void do_operations(Geometry &geom, cn_opts &opts)
     if (hart_operation_done) {
       // these steps are needed for hart_mode
       operation_number++;
-      orient_planar(geom, is_orientable, orientation_positive, opts);
+      orient_planar(geom, is_orientable, orientation_positive, opts,
+                    planarize);
     }
     else {
       // wythoff mode
       if (opts.alpha_user.find(operation->op) == string::npos)
         wythoff(geom, operation->op, operation->op_var, operation_number,
-                is_orientable, orientation_positive, opts);
+                is_orientable, orientation_positive, opts, planarize);
       else {
         for (auto operation_user : opts.operations_user[operation->op]) {
           verbose(operation_user->op, operation_user->op_var, opts);
           wythoff(geom, operation_user->op, operation_user->op_var,
-                  operation_number, is_orientable, orientation_positive, opts);
+                  operation_number, is_orientable, orientation_positive, opts,
+                  planarize);
         }
       }
     }
+
+    max_verts = std::max(max_verts, (unsigned int)geom.verts().size());
+    max_faces = std::max(max_faces, (unsigned int)geom.faces().size());
+  }
+
+  if (!planarize && opts.operations.size())
+    orient_planar(geom, is_orientable, orientation_positive, opts);
+
+  if (opts.verbosity) {
+    std::chrono::duration<double> secs =
+        std::chrono::steady_clock::now() - start_time;
+    fprintf(stderr,
+            "operations took %.3f seconds, largest model %u vertices, "
+            "%u faces\n",
+            secs.count(), max_verts, max_faces);
   }
 }
 
@@ -51,12 +51,15 @@ public:
   char method;
   bool keep_flat;
   bool equal_len_div;
+  bool stream;
+  int num_threads;
   string ifile;
   string ofile;
 
   geo_opts()
       : ProgramOpts("geodesic"), centre(Vec3d(0, 0, 0)), m(1), n(0),
-        pat_freq(1), use_step_freq(false), method('s')
+        pat_freq(1), use_step_freq(false), method('s'), stream(false),
+        num_threads(0)
   {
   }
   void process_command_line(int argc, char **argv);
@@ -95,6 +98,10 @@ void geo_opts::usage()
 "                surface of the original polyhedron.\n"
 "  -C <cent> centre of points, in form \"x_val,y_val,z_val\" (default: 0,0,0)\n"
 "            used for geodesic spheres\n"
+"  -S        stream the output, writing the model as it is made rather than\n"
+"            holding it in memory (for very high frequencies)\n"
+"  -j <thr>  number of threads, the base faces are divided in parallel\n"
+"            (default: 0, use all hardware threads)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
 "\n"
 "\n", prog_name(), help_ver_text);
@@ -108,7 +115,7 @@ void geo_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hf:F:c:M:C:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":hf:F:c:M:C:Sj:o:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -166,6 +173,16 @@ void geo_opts::process_command_line(int argc, char **argv)
               c);
       break;
 
+    case 'S':
+      stream = true;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     case 'o':
       ofile = optarg;
       break;
@@ -207,11 +224,21 @@ int main(int argc, char **argv)
   Geometry geom;
   opts.read_or_error(geom, opts.ifile);
 
+  if (opts.stream) {
+    OffStreamWriter writer;
+    opts.print_status_or_exit(writer.open(opts.ofile));
+    write_geodesic(writer, geom, opts.m, opts.n, opts.method, opts.centre,
+                   opts.num_threads);
+    opts.print_status_or_exit(writer.close());
+    return 0;
+  }
+
   Geometry geo;
   if (opts.method == 's')
-    make_geodesic_sphere(geo, geom, opts.m, opts.n, opts.centre);
+    make_geodesic_sphere(geo, geom, opts.m, opts.n, opts.centre,
+                         opts.num_threads);
   else if (opts.method == 'p')
-    make_geodesic_planar(geo, geom, opts.m, opts.n);
+    make_geodesic_planar(geo, geom, opts.m, opts.n, opts.num_threads);
 
   opts.write_or_error(geo, opts.ofile);
 
@@ -257,6 +257,7 @@ private:
 
 public:
   id_poly();
+  string poly_line(int idx);
   void list_poly(int idx, FILE *fp = stderr);
   void list_polys(FILE *fp = stderr);
   int lookup_sym_no(string sym);
@@ -278,11 +279,16 @@ id_poly::id_poly()
   last_iso_delta = sizeof(iso_delta_item_list) / sizeof(iso_delta_item_list[0]);
 }
 
+string id_poly::poly_line(int idx)
+{
+  return msg_str("%2d) %-7s %-2s %13s %-45s\n", idx + 1,
+                 iso_delta_items[idx].name, iso_delta_items[idx].sym_type,
+                 iso_delta_items[idx].symbol, iso_delta_items[idx].comment);
+}
+
 void id_poly::list_poly(int idx, FILE *fp)
 {
-  fprintf(fp, "%2d) %-7s %-2s %13s %-45s\n", idx + 1, iso_delta_items[idx].name,
-          iso_delta_items[idx].sym_type, iso_delta_items[idx].symbol,
-          iso_delta_items[idx].comment);
+  fputs(poly_line(idx).c_str(), fp);
 }
 
 void id_poly::list_polys(FILE *fp)
@@ -400,11 +406,14 @@ public:
   ColorMapMulti map;
   string case_type;
 
-  id_opts()
-      : ProgramOpts("iso_delta"), list_polys(false), make_dipyramid(false),
+  string batch_file;
+  int num_threads;
+
+  id_opts(const string &prog_name = "iso_delta")
+      : ProgramOpts(prog_name), list_polys(false), make_dipyramid(false),
         triangle_only(false), verbose(false), allow_angles(false),
         angle(INFINITY), n(0), d(1), k(0), s(1), coloring_method('c'),
-        face_opacity(-1)
+        face_opacity(-1), num_threads(0)
   {
   }
 
@@ -433,6 +442,13 @@ void id_opts::usage()
 "  -t        generate triangle only (Isohedral Deltahedra 1 to 44 and option -d)\n"
 "  -v        verbose output (Isohedral Deltahedra 1 thru 44 and option -d)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
+"  -B <file> batch mode. Read the options above, less -l and -v, and the\n"
+"            options below for one model per line of file ('-' for standard\n"
+"            input, '#' starts a comment). Models are made in parallel and\n"
+"            written to the -o of their line, or else to a file numbered by\n"
+"            model based on the -o of the command line (default:\n"
+"            iso_delta.off)\n"
+"  -j <thr>  number of threads for batch mode (default: 0, use all cores)\n"
 // undocumented switch
 //"  -w        allow angle on b,e,f,m,n,o,p,q creates bi-hedral forms\n"
 "\nIsohedral Deltahedra Options\n"
@@ -514,7 +530,7 @@ void id_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hldtvwc:n:a:k:s:f:T:m:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":hldtvwc:n:a:k:s:f:T:m:o:B:j:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -607,11 +623,29 @@ void id_opts::process_command_line(int argc, char **argv)
       ofile = optarg;
       break;
 
+    case 'B':
+      batch_file = optarg;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     default:
       error("unknown command line error");
     }
   }
 
+  // batch mode, the model options are processed for each line
+  if (batch_file.length()) {
+    if (argc != optind)
+      error("not valid with batch mode, give it in a batch line",
+            "polyhedron");
+    return;
+  }
+
   if (case_type == "c" || case_type == "k" || case_type == "l" ||
       make_dipyramid) {
     if (n <= 0)
@@ -1008,16 +1042,17 @@ void make_poly(Geometry &geom, const string &sym_type, const bool triangle_only,
   }
 }
 
-void make_delta_dipyramid(Geometry &geom, const int n, const int d,
-                          bool triangle_only = false, bool verbose = false)
+void make_delta_dipyramid(Geometry &geom, const id_opts &opts, const int n,
+                          const int d, bool triangle_only = false,
+                          bool verbose = false)
 {
   char buf1[MSG_SZ];
   char buf2[MSG_SZ];
 
   sprintf(buf1, "D%dh", n);
   sprintf(buf2, "[%d/%d,1/2,1/2]", d, n);
-  fprintf(stderr, "Dihedral Group:  %s  %s  %d/%d %sdipyramid\n", buf1, buf2, n,
-          d, ((d == 1) ? "" : "star "));
+  opts.report(msg_str("Dihedral Group:  %s  %s  %d/%d %sdipyramid\n", buf1,
+                      buf2, n, d, ((d == 1) ? "" : "star ")));
 
   string sym_type = buf1;
 
@@ -1071,15 +1106,16 @@ void case_b_5_or_10_tetrahedra(Geometry &geom, double angle, const int k)
   }
 }
 
-void case_c_2_dipyramids(Geometry &geom, double angle, const int n, const int d)
+void case_c_2_dipyramids(Geometry &geom, const id_opts &opts, double angle,
+                         const int n, const int d)
 {
   if (angle == INFINITY) {
     angle = (M_PI / 2) / n; // 90/n degrees
-    fprintf(stderr, "angle calculated is %g\n", rad2deg(angle));
+    opts.report(msg_str("angle calculated is %g\n", rad2deg(angle)));
   }
 
-  fprintf(stderr, "Using: ");
-  make_delta_dipyramid(geom, n, d);
+  opts.report("Using: ");
+  make_delta_dipyramid(geom, opts, n, d);
 
   char sym_from[MSG_SZ];
   sprintf(sym_from, "D%dh", n);
@@ -1103,14 +1139,14 @@ void case_d_6_octahedra(Geometry &geom, double angle)
   transform_and_repeat(geom, "T", "D2h");
 }
 
-void case_e_4_or_8_triangular_dipyramids(Geometry &geom, double angle,
-                                         const int k)
+void case_e_4_or_8_triangular_dipyramids(Geometry &geom, const id_opts &opts,
+                                         double angle, const int k)
 {
   if (angle == INFINITY)
     angle = 0;
 
-  fprintf(stderr, "Using: ");
-  make_delta_dipyramid(geom, 3, 1);
+  opts.report("Using: ");
+  make_delta_dipyramid(geom, opts, 3, 1);
 
   // to construct in one statement for Oh
   // transform_and_repeat(&geom, (k == 1 ? "O" : "Oh"), "D3h",
@@ -1129,17 +1165,17 @@ void case_e_4_or_8_triangular_dipyramids(Geometry &geom, double angle,
   }
 }
 
-void case_f_6_or_12_pentagonal_dipyramids(Geometry &geom, double angle,
-                                          const int k)
+void case_f_6_or_12_pentagonal_dipyramids(Geometry &geom, const id_opts &opts,
+                                          double angle, const int k)
 {
   if (angle == INFINITY)
     angle = 0;
 
-  fprintf(stderr, "Using: ");
+  opts.report("Using: ");
   if (k == 1 || k == 2)
-    make_delta_dipyramid(geom, 5, 1);
+    make_delta_dipyramid(geom, opts, 5, 1);
   else if (k == 3 || k == 4)
-    make_delta_dipyramid(geom, 5, 2);
+    make_delta_dipyramid(geom, opts, 5, 2);
 
   // to construct in one statement for Ih
   // transform_and_repeat(&geom, ((k == 1 || k == 3) ? "I" : "Ih"), "D5h",
@@ -1200,14 +1236,14 @@ void case_j_12_tetrahedra(Geometry &geom, double angle)
   transform_and_repeat(geom, "T", "Oh", Trans3d::rotate(0, 0, angle));
 }
 
-void case_k_2k_dipyramids(Geometry &geom, double angle, const int k,
-                          const int n, const int d)
+void case_k_2k_dipyramids(Geometry &geom, const id_opts &opts, double angle,
+                          const int k, const int n, const int d)
 {
   if (angle == INFINITY)
     angle = deg2rad(1.0);
 
-  fprintf(stderr, "Using: ");
-  make_delta_dipyramid(geom, n, d);
+  opts.report("Using: ");
+  make_delta_dipyramid(geom, opts, n, d);
 
   char sym_from[MSG_SZ];
   sprintf(sym_from, "D%dh", n);
@@ -1219,10 +1255,11 @@ void case_k_2k_dipyramids(Geometry &geom, double angle, const int k,
   transform_and_repeat(geom, sym_to, sym_from);
 }
 
-void case_l_k_dipyramids(Geometry &geom, const int k, const int n, const int d)
+void case_l_k_dipyramids(Geometry &geom, const id_opts &opts, const int k,
+                         const int n, const int d)
 {
-  fprintf(stderr, "Using: ");
-  make_delta_dipyramid(geom, n, d);
+  opts.report("Using: ");
+  make_delta_dipyramid(geom, opts, n, d);
 
   char sym_from[MSG_SZ];
   sprintf(sym_from, "D%dh", n);
@@ -1232,14 +1269,15 @@ void case_l_k_dipyramids(Geometry &geom, const int k, const int n, const int d)
   transform_and_repeat(geom, sym_to, sym_from);
 }
 
-void case_m_10_or_20_triangular_dipyramids(Geometry &geom, double angle,
+void case_m_10_or_20_triangular_dipyramids(Geometry &geom,
+                                           const id_opts &opts, double angle,
                                            const int k)
 {
   if (angle == INFINITY)
     angle = 0;
 
-  fprintf(stderr, "Using: ");
-  make_delta_dipyramid(geom, 3, 1);
+  opts.report("Using: ");
+  make_delta_dipyramid(geom, opts, 3, 1);
 
   // to construct in one statement for Ih
   // transform_and_repeat(&geom, (k == 1 ? "I" : "Ih"), "D3h",
@@ -1260,13 +1298,14 @@ void case_m_10_or_20_triangular_dipyramids(Geometry &geom, double angle,
   }
 }
 
-void case_n_6_10_3_star_dipyramids(Geometry &geom, double angle)
+void case_n_6_10_3_star_dipyramids(Geometry &geom, const id_opts &opts,
+                                   double angle)
 {
   if (angle == INFINITY)
     angle = 0;
 
-  fprintf(stderr, "Using: ");
-  make_delta_dipyramid(geom, 10, 3);
+  opts.report("Using: ");
+  make_delta_dipyramid(geom, opts, 10, 3);
 
   transform_and_repeat(geom, "I", "D10h",
                        Trans3d::rotate(Vec3d(0, 0, 1), Vec3d(0, 1, phi)) *
@@ -1359,20 +1398,11 @@ void compound_coloring(Geometry &geom, const id_opts &opts)
   }
 }
 
-int main(int argc, char *argv[])
+Status make_iso_delta(Geometry &geom, const id_opts &opts)
 {
-  id_opts opts;
-  opts.process_command_line(argc, argv);
   id_poly id_polys;
-
-  if (opts.list_polys) {
-    id_polys.list_polys();
-    exit(0);
-  }
-
-  Geometry geom;
   if (opts.make_dipyramid)
-    make_delta_dipyramid(geom, opts.n, opts.d, opts.triangle_only,
+    make_delta_dipyramid(geom, opts, opts.n, opts.d, opts.triangle_only,
                          opts.verbose);
   else if (opts.case_type.length()) {
     if (opts.case_type == "a")
@@ -1380,13 +1410,13 @@ int main(int argc, char *argv[])
     else if (opts.case_type == "b")
       case_b_5_or_10_tetrahedra(geom, opts.angle, opts.s);
     else if (opts.case_type == "c")
-      case_c_2_dipyramids(geom, opts.angle, opts.n, opts.d);
+      case_c_2_dipyramids(geom, opts, opts.angle, opts.n, opts.d);
     else if (opts.case_type == "d")
       case_d_6_octahedra(geom, opts.angle);
     else if (opts.case_type == "e")
-      case_e_4_or_8_triangular_dipyramids(geom, opts.angle, opts.s);
+      case_e_4_or_8_triangular_dipyramids(geom, opts, opts.angle, opts.s);
     else if (opts.case_type == "f")
-      case_f_6_or_12_pentagonal_dipyramids(geom, opts.angle, opts.s);
+      case_f_6_or_12_pentagonal_dipyramids(geom, opts, opts.angle, opts.s);
     else if (opts.case_type == "g")
       case_g_2_tetrahedra(geom, opts.angle);
     else if (opts.case_type == "h")
@@ -1396,13 +1426,13 @@ int main(int argc, char *argv[])
     else if (opts.case_type == "j")
       case_j_12_tetrahedra(geom, opts.angle);
     else if (opts.case_type == "k")
-      case_k_2k_dipyramids(geom, opts.angle, opts.k, opts.n, opts.d);
+      case_k_2k_dipyramids(geom, opts, opts.angle, opts.k, opts.n, opts.d);
     else if (opts.case_type == "l")
-      case_l_k_dipyramids(geom, opts.k, opts.n, opts.d);
+      case_l_k_dipyramids(geom, opts, opts.k, opts.n, opts.d);
     else if (opts.case_type == "m")
-      case_m_10_or_20_triangular_dipyramids(geom, opts.angle, opts.s);
+      case_m_10_or_20_triangular_dipyramids(geom, opts, opts.angle, opts.s);
     else if (opts.case_type == "n")
-      case_n_6_10_3_star_dipyramids(geom, opts.angle);
+      case_n_6_10_3_star_dipyramids(geom, opts, opts.angle);
     else if (opts.case_type == "o") {
       int sym_no = 3;
       string sym_type = id_polys.get_sym_type(sym_no);
@@ -1431,11 +1461,12 @@ int main(int argc, char *argv[])
   else {
     int sym_no = id_polys.lookup_sym_no(opts.poly);
     if (sym_no >= id_polys.get_last_iso_delta())
-      opts.error("polyhedron number '" + opts.poly + "' out of range");
+      return Status::error("polyhedron number '" + opts.poly +
+                           "' out of range");
     if (sym_no < 0)
-      opts.error("unknown polyhedron '" + opts.poly + "'");
+      return Status::error("unknown polyhedron '" + opts.poly + "'");
 
-    id_polys.list_poly(sym_no);
+    opts.report(id_polys.poly_line(sym_no));
 
     // patch for 9 and 14. Made with make_poly they will have merged vertices
     // between constituents
@@ -1443,7 +1474,8 @@ int main(int argc, char *argv[])
     if (sym_no + 1 == 9 || sym_no + 1 == 14) {
       geom.clear_all();
       if (sym_no + 1 == 9) {
-        make_delta_dipyramid(geom, 8, 3, opts.triangle_only, opts.verbose);
+        make_delta_dipyramid(geom, opts, 8, 3, opts.triangle_only,
+                             opts.verbose);
         if (!opts.triangle_only)
           transform_and_repeat(geom, "Oh", "D8h");
       }
@@ -1476,6 +1508,35 @@ int main(int argc, char *argv[])
 
   compound_coloring(geom, opts);
 
+  return Status::ok();
+}
+
+int main(int argc, char *argv[])
+{
+  id_opts opts;
+  opts.process_command_line(argc, argv);
+
+  if (opts.batch_file.length()) {
+    auto check_opts = [](id_opts &item) {
+      if (item.batch_file.length())
+        item.error("batch mode is not valid in a batch line", 'B');
+      if (item.list_polys)
+        item.error("listing is not valid in batch mode", 'l');
+      if (item.verbose)
+        item.error("verbose output is not valid in batch mode", 'v');
+    };
+    return make_batch<id_opts>(opts, opts.batch_file, opts.ofile,
+                               opts.num_threads, make_iso_delta, check_opts);
+  }
+
+  if (opts.list_polys) {
+    id_poly id_polys;
+    id_polys.list_polys();
+    exit(0);
+  }
+
+  Geometry geom;
+  opts.print_status_or_exit(make_iso_delta(geom, opts));
   opts.write_or_error(geom, opts.ofile);
 
   return 0;
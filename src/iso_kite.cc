@@ -162,10 +162,13 @@ public:
   int verb; // verbosity - 0:no report, 1:print report
 
   string ofile;
+  string batch_file;
+  int num_threads;
 
-  kt_opts()
-      : ProgramOpts("iso_kite"), heights_set(0), angle(NAN), num_parts(0),
-        color_type(-1), list_idx(-1), kite_only(false), verb(1)
+  kt_opts(const string &prog_name = "iso_kite")
+      : ProgramOpts(prog_name), heights_set(0), angle(NAN), num_parts(0),
+        color_type(-1), list_idx(-1), kite_only(false), verb(1),
+        num_threads(0)
   {
     for (double &height : heights)
       height = 1.0;
@@ -235,6 +238,12 @@ void kt_opts::usage()
 "  -k        output a single kite (colours not applied)\n"
 "  -q        quiet, don't print final report\n"
 "  -o <file> write output to file (default: write to standard output)\n"
+"  -b <file> batch mode. Read the options above, with model_args, for one\n"
+"            model per line of file ('-' for standard input, '#' starts a\n"
+"            comment). Models are made in parallel and written to the -o of\n"
+"            their line, or else to a file numbered by model based on the -o\n"
+"            of the command line (default: iso_kite.off)\n"
+"  -j <thr>  number of threads for batch mode (default: 0, use all cores)\n"
 "\n"
 "\n", prog_name());
 }
@@ -395,7 +404,7 @@ void kt_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hA:B:C:a:N:c:l:kqo:")) != -1) {
+  while ((c = getopt(argc, argv, ":hA:B:C:a:N:c:l:kqo:b:j:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -464,11 +473,29 @@ void kt_opts::process_command_line(int argc, char **argv)
       ofile = optarg;
       break;
 
+    case 'b':
+      batch_file = optarg;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     default:
       error("unknown command line error");
     }
   }
 
+  // batch mode, the model options are processed for each line
+  if (batch_file.length()) {
+    if (argc != optind)
+      error("not valid with batch mode, give them in a batch line",
+            "model_args");
+    return;
+  }
+
   if (kite_only && color_type >= 0) {
     color_type = -1;
     warning("colouring ignored for single kite model", 'c');
@@ -803,25 +830,26 @@ void print_list(vector<vector<string>> &list)
   }
 }
 
-void print_base_model_report(const string &model_name,
-                             const string &orig_model_name,
-                             const vector<double> &hts_used,
-                             const string &model_sym, const string &sym_used)
+string base_model_report(const string &model_name,
+                         const string &orig_model_name,
+                         const vector<double> &hts_used,
+                         const string &model_sym, const string &sym_used)
 {
-  fprintf(stderr, "\n");
-  fprintf(stderr, "Base Model\n");
-  fprintf(stderr, "   model:               %s", model_name.c_str());
+  string report = "\n";
+  report += "Base Model\n";
+  report += "   model:               " + model_name;
   if (model_name != orig_model_name)
-    fprintf(stderr, " (from %s)", orig_model_name.c_str());
-  fprintf(stderr, "\n");
-  fprintf(stderr, "   A:                   %-16.14g\n", hts_used[0]);
-  fprintf(stderr, "   B:                   %-16.14g\n", hts_used[1]);
-  fprintf(stderr, "   C:                   %-16.14g\n", hts_used[2]);
-  fprintf(stderr, "   symmetry:            %s", model_sym.c_str());
+    report += " (from " + orig_model_name + ")";
+  report += "\n";
+  report += msg_str("   A:                   %-16.14g\n", hts_used[0]);
+  report += msg_str("   B:                   %-16.14g\n", hts_used[1]);
+  report += msg_str("   C:                   %-16.14g\n", hts_used[2]);
+  report += "   symmetry:            " + model_sym;
   if (model_sym != sym_used)
-    fprintf(stderr, " (expected %s)", sym_used.c_str());
-  fprintf(stderr, "\n");
-  fprintf(stderr, "\n");
+    report += " (expected " + sym_used + ")";
+  report += "\n";
+  report += "\n";
+  return report;
 }
 
 bool make_base_model(Geometry &geom, const vector<int> &fracs, int num_fracs,
@@ -885,7 +913,7 @@ bool make_list_model(Geometry &geom, const string model_str,
                      vector<string> &model_desc, unsigned int heights_set,
                      double heights[], int num_parts, double angle,
                      char color_type, bool kite_only, char *errmsg,
-                     vector<string> &warnings, int verb)
+                     vector<string> &warnings, string *report)
 {
   warnings.clear();
   string base_model =
@@ -919,10 +947,9 @@ bool make_list_model(Geometry &geom, const string model_str,
       clrngs[FACES].f_one_col(clrngs[2].get_col(0));
     }
     Symmetry base_sym(base_geom);
-    if (verb) {
-      print_base_model_report(base_model, orig_base_model, hts_used,
-                              base_sym.get_symbol(), sym_used);
-    }
+    if (report)
+      *report += base_model_report(base_model, orig_base_model, hts_used,
+                                   base_sym.get_symbol(), sym_used);
     return true;
   }
 
@@ -995,80 +1022,80 @@ bool make_list_model(Geometry &geom, const string model_str,
   else
     sym_repeat(geom, base_geom, min_ts);
 
-  if (verb) {
-    print_base_model_report(base_model, orig_base_model, hts_used,
-                            base_sym.get_symbol(), sym_used);
-    fprintf(stderr, "\n");
-    fprintf(stderr, "Compound\n");
-    fprintf(stderr, "   full symmetry:       %s", full_sym_str.c_str());
+  if (report) {
+    *report += base_model_report(base_model, orig_base_model, hts_used,
+                                 base_sym.get_symbol(), sym_used);
+    *report += "\n";
+    *report += "Compound\n";
+    *report += "   full symmetry:       " + full_sym_str;
     if (full_sym_str != model_desc[1])
-      fprintf(stderr, " (from %s)", model_desc[1].c_str());
-    fprintf(stderr, "\n");
-    fprintf(stderr, "   alignment symmetry:  %s", part_sym_str.c_str());
+      *report += " (from " + model_desc[1] + ")";
+    *report += "\n";
+    *report += "   alignment symmetry:  " + part_sym_str;
     if (part_sym_str != model_desc[2])
-      fprintf(stderr, " (from %s)", model_desc[2].c_str());
-    fprintf(stderr, "\n");
-    fprintf(stderr, "   N:                   %s\n",
-            (N_unneeded) ? "n/a" : msg_str("%d", num_parts).c_str());
-    fprintf(stderr, "   angle:               %s\n",
-            (angle_unneeded) ? "n/a" : msg_str("%-16.14g", ang).c_str());
-    fprintf(stderr, "   components:          %d", (int)min_ts.size());
+      *report += " (from " + model_desc[2] + ")";
+    *report += "\n";
+    *report += "   N:                   ";
+    *report += (N_unneeded) ? "n/a" : msg_str("%d", num_parts);
+    *report += "\n";
+    *report += "   angle:               ";
+    *report += (angle_unneeded) ? "n/a" : msg_str("%-16.14g", ang);
+    *report += "\n";
+    *report += msg_str("   components:          %d", (int)min_ts.size());
     int expected_num_comps =
         full_sym.get_trans().size() / part_sym.get_trans().size();
     if ((int)min_ts.size() != expected_num_comps)
-      fprintf(stderr, " (expected %d)", expected_num_comps);
-    fprintf(stderr, "\n");
-    fprintf(stderr, "\n");
+      *report += msg_str(" (expected %d)", expected_num_comps);
+    *report += "\n";
+    *report += "\n";
   }
 
   return true;
 }
 
-int main(int argc, char *argv[])
+Status make_iso_kite(Geometry &out_geom, kt_opts &opts)
 {
-  kt_opts opts;
-  opts.process_command_line(argc, argv);
-
   char errmsg[MSG_SZ];
-  Geometry out_geom;
   if (opts.list_idx < 0) {
     vector<double> hts_used;
     string sym_used;
     if (!make_base_model(out_geom, opts.triangle, opts.num_fracs,
                          opts.heights_set, opts.heights, opts.color_type,
                          &hts_used, &sym_used, opts.kite_only, errmsg))
-      opts.error(errmsg);
+      return Status::error(errmsg);
     if (*errmsg)
       opts.warning(errmsg);
     if (opts.verb)
-      print_base_model_report(opts.model_name, opts.model_name, hts_used,
-                              Symmetry(out_geom).get_symbol(), sym_used);
+      opts.report(base_model_report(opts.model_name, opts.model_name,
+                                    hts_used, Symmetry(out_geom).get_symbol(),
+                                    sym_used));
   }
   else {
     vector<vector<string>> list;
     get_list(list, opts.model_name, opts.num_parts);
     if (!list.size())
-      opts.error(
-          "list cannot be used with degenerate Schwarz models \n"
-          "(see supported models by running the program without options)\n",
-          'l');
+      return Status::error(
+          "option -l: list cannot be used with degenerate Schwarz models \n"
+          "(see supported models by running the program without options)\n");
     if (opts.list_idx == 0) {
       print_list(list);
-      return 0;
+      return Status::ok();
     }
     else if (opts.list_idx <= (int)list.size()) {
       vector<string> warnings;
+      string report;
       if (!make_list_model(out_geom, opts.model_name, list[opts.list_idx - 1],
                            opts.heights_set, opts.heights, opts.num_parts,
                            opts.angle, opts.color_type, opts.kite_only, errmsg,
-                           warnings, opts.verb))
-        opts.error(errmsg);
+                           warnings, (opts.verb) ? &report : nullptr))
+        return Status::error(errmsg);
+      opts.report(report);
       for (auto &warning : warnings)
         opts.warning(warning.c_str());
     }
     else
-      opts.error(msg_str("list number too large (maximum %d)", list.size()),
-                 'l');
+      return Status::error(msg_str(
+          "option -l: list number too large (maximum %d)", (int)list.size()));
   }
 
   if (opts.kite_only) {
@@ -1079,6 +1106,29 @@ int main(int argc, char *argv[])
     out_geom = kite;
   }
 
+  return Status::ok();
+}
+
+int main(int argc, char *argv[])
+{
+  kt_opts opts;
+  opts.process_command_line(argc, argv);
+
+  if (opts.batch_file.length()) {
+    auto check_opts = [](kt_opts &item) {
+      if (item.batch_file.length())
+        item.error("batch mode is not valid in a batch line", 'b');
+      if (item.list_idx == 0)
+        item.error("listing is not valid in batch mode", 'l');
+    };
+    return make_batch<kt_opts>(opts, opts.batch_file, opts.ofile,
+                               opts.num_threads, make_iso_kite, check_opts);
+  }
+
+  Geometry out_geom;
+  opts.print_status_or_exit(make_iso_kite(out_geom, opts));
+  if (opts.list_idx == 0) // list was printed
+    return 0;
   opts.write_or_error(out_geom, opts.ofile);
 
   return 0;
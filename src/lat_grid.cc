@@ -49,12 +49,13 @@ public:
   int strut_len2;
   COORD_TEST_F coord_test;
   char container;
+  bool stream;
 
   string ofile;
 
   lg_opts()
       : ProgramOpts("lat_grid"), o_width(6), i_width(-1), strut_len2(0),
-        coord_test(sc_test), container('c')
+        coord_test(sc_test), container('c'), stream(false)
   {
   }
 
@@ -95,6 +96,8 @@ void lg_opts::usage()
 "  -C <cent> centre of lattice, in form \"x_val,y_val,z_val\"\n"
 "  -c <type> container, c - cube (default), s - sphere\n"
 "  -s <len2> create struts, the value is the square of the strut length\n"
+"  -S        stream the output, writing the lattice as it is made rather\n"
+"            than holding it in memory (for very large lattices)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
 "\n"
 "\n", prog_name(), help_ver_text);
@@ -108,7 +111,7 @@ void lg_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hc:s:C:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":hc:s:SC:o:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -119,6 +122,10 @@ void lg_opts::process_command_line(int argc, char **argv)
         error("square of strut length cannot be negative", "s");
       break;
 
+    case 'S':
+      stream = true;
+      break;
+
     case 'C':
       print_status_or_exit(centre.read(optarg), c);
       break;
@@ -205,6 +212,15 @@ int main(int argc, char **argv)
   lat->set_centre(opts.centre);
   lat->set_coord_test(opts.coord_test);
 
+  if (opts.stream) {
+    OffStreamWriter writer;
+    opts.print_status_or_exit(writer.open(opts.ofile));
+    lat->write_lattice(writer, opts.strut_len2);
+    delete lat;
+    opts.print_status_or_exit(writer.close());
+    return 0;
+  }
+
   Geometry geom;
   lat->make_lattice(geom);
   delete lat;
@@ -158,48 +158,168 @@ bool k_4_test(int x, int y, int z) //  dist2 = 2
 void add_struts(Geometry &geom, int len2)
 {
   const vector<Vec3d> &verts = geom.verts();
+  KDTree tree(verts);
+  double rad = sqrt(std::max(len2 + epsilon, 0.0));
+  // each pair is only found once, so new edges can only duplicate edges
+  // that were already in the geometry
+  bool check_dups = geom.edges().size() > 0;
   for (unsigned int i = 0; i < verts.size(); i++)
-    for (unsigned int j = i; j < verts.size(); j++) {
-      if (fabs((verts[i] - verts[j]).len2() - len2) < epsilon)
-        geom.add_edge(make_edge(i, j));
+    for (int j : tree.in_radius(verts[i], rad)) {
+      if (j >= (int)i && fabs((verts[i] - verts[j]).len2() - len2) < epsilon) {
+        if (check_dups)
+          geom.add_edge(make_edge(i, j));
+        else
+          geom.add_edge_raw(make_edge(i, j));
+      }
     }
 }
 
-void int_lat_grid::make_lattice(Geometry &geom)
+void int_lat_grid::set_default_centre()
 {
   if (!centre.is_set())
     centre = Vec3d(1, 1, 1) * (o_width / 2.0);
+}
+
+void int_lat_grid::coord_range(int axis, int &lo, int &hi) const
+{
   double o_off = o_width / 2.0 + epsilon;
+  lo = int(ceil(centre[axis] - o_off));
+  hi = int(floor(centre[axis] + o_off));
+}
+
+bool int_lat_grid::in_container(int i, int j, int k) const
+{
   double i_off = i_width / 2.0 - epsilon;
-  int i, j, k;
-  for (k = int(ceil(centre[2] - o_off)); k <= centre[2] + o_off; k++)
-    for (j = int(ceil(centre[1] - o_off)); j <= centre[1] + o_off; j++)
-      for (i = int(ceil(centre[0] - o_off)); i <= centre[0] + o_off; i++) {
-        if (i > centre[0] - i_off && i < centre[0] + i_off &&
-            j > centre[1] - i_off && j < centre[1] + i_off &&
-            k > centre[2] - i_off && k < centre[2] + i_off)
+  return !(i > centre[0] - i_off && i < centre[0] + i_off &&
+           j > centre[1] - i_off && j < centre[1] + i_off &&
+           k > centre[2] - i_off && k < centre[2] + i_off);
+}
+
+void int_lat_grid::for_each_point(
+    const std::function<void(int, int, int)> &func) const
+{
+  int lo[3], hi[3];
+  for (int axis = 0; axis < 3; axis++)
+    coord_range(axis, lo[axis], hi[axis]);
+  for (int k = lo[2]; k <= hi[2]; k++)
+    for (int j = lo[1]; j <= hi[1]; j++)
+      for (int i = lo[0]; i <= hi[0]; i++)
+        if (in_container(i, j, k) && coord_test(i, j, k))
+          func(i, j, k);
+}
+
+int int_lat_grid::for_each_strut(
+    int len2, const std::function<void(int, int)> &func) const
+{
+  int lo[3], hi[3];
+  for (int axis = 0; axis < 3; axis++)
+    coord_range(axis, lo[axis], hi[axis]);
+  int nx = hi[0] - lo[0] + 1;
+  int ny = hi[1] - lo[1] + 1;
+  int nz = hi[2] - lo[2] + 1;
+  if (nx < 1 || ny < 1 || nz < 1)
+    return 0;
+
+  // Offsets from a point to the points that follow it in index order at
+  // the strut length, in the index order of those points.
+  int r = (len2 > 0) ? int(floor(sqrt(double(len2)))) : 0;
+  vector<vector<int>> offs;
+  for (int dk = 0; dk <= r; dk++)
+    for (int dj = -r; dj <= r; dj++)
+      for (int di = -r; di <= r; di++)
+        if (dk * dk + dj * dj + di * di == len2 &&
+            (dk > 0 || dj > 0 || (dj == 0 && di > 0)))
+          offs.push_back({di, dj, dk});
+
+  // Index numbers of the points, or -1, for the last r+1 slices in k
+  int num_slices = std::min(r + 1, nz);
+  vector<vector<int>> slices(num_slices, vector<int>(nx * ny));
+  auto slice = [&](int k) -> vector<int> & {
+    return slices[(k - lo[2]) % num_slices];
+  };
+
+  int idx = 0;
+  auto index_slice = [&](int k) {
+    vector<int> &s = slice(k);
+    for (int j = lo[1]; j <= hi[1]; j++)
+      for (int i = lo[0]; i <= hi[0]; i++)
+        s[(j - lo[1]) * nx + i - lo[0]] =
+            (in_container(i, j, k) && coord_test(i, j, k)) ? idx++ : -1;
+  };
+
+  auto strut_slice = [&](int k) {
+    const vector<int> &s = slice(k);
+    for (int j = lo[1]; j <= hi[1]; j++)
+      for (int i = lo[0]; i <= hi[0]; i++) {
+        int v0 = s[(j - lo[1]) * nx + i - lo[0]];
+        if (v0 < 0)
           continue;
-        if (coord_test(i, j, k))
-          geom.add_vert(Vec3d(i, j, k));
+        for (const auto &off : offs) {
+          int i1 = i + off[0];
+          int j1 = j + off[1];
+          int k1 = k + off[2];
+          if (i1 < lo[0] || i1 > hi[0] || j1 < lo[1] || j1 > hi[1] ||
+              k1 > hi[2])
+            continue;
+          int v1 = slice(k1)[(j1 - lo[1]) * nx + i1 - lo[0]];
+          if (v1 >= 0)
+            func(v0, v1);
+        }
       }
+  };
+
+  // a slice is strutted once all the slices it can reach are indexed
+  for (int k = lo[2]; k <= hi[2]; k++) {
+    index_slice(k);
+    if (k - (num_slices - 1) >= lo[2])
+      strut_slice(k - (num_slices - 1));
+  }
+  for (int k = std::max(lo[2], hi[2] - num_slices + 2); k <= hi[2]; k++)
+    strut_slice(k);
+
+  return idx;
+}
+
+void int_lat_grid::make_lattice(Geometry &geom)
+{
+  set_default_centre();
+  for_each_point([&](int i, int j, int k) { geom.add_vert(Vec3d(i, j, k)); });
 }
 
-void sph_lat_grid::make_lattice(Geometry &geom)
+void int_lat_grid::write_lattice(OffStreamWriter &writer, int strut_len2)
+{
+  set_default_centre();
+  if (strut_len2 < 0)
+    strut_len2 = 0;
+  int num_edges = 0;
+  int num_verts = for_each_strut(strut_len2, [&](int, int) { num_edges++; });
+  writer.write_header(num_verts, num_edges);
+  for_each_point(
+      [&](int i, int j, int k) { writer.write_vert(Vec3d(i, j, k)); });
+  for_each_strut(strut_len2,
+                 [&](int v0, int v1) { writer.write_edge(v0, v1); });
+}
+
+void sph_lat_grid::set_default_centre()
 {
   if (!centre.is_set())
     centre = Vec3d(0, 0, 0);
+}
+
+void sph_lat_grid::coord_range(int axis, int &lo, int &hi) const
+{
+  // the outer width is the square of the radius, so no point lies
+  // further than its square root from the centre
   double o_off = o_width + epsilon;
-  double i_off = i_width - epsilon;
-  int i, j, k;
-  for (k = int(ceil(centre[2] - o_off)); k <= centre[2] + o_off; k++)
-    for (j = int(ceil(centre[1] - o_off)); j <= centre[1] + o_off; j++)
-      for (i = int(ceil(centre[0] - o_off)); i <= centre[0] + o_off; i++) {
-        double dist2 = (Vec3d(i, j, k) - centre).len2();
-        if (o_off < dist2 || i_off > dist2)
-          continue;
-        if (coord_test(i, j, k))
-          geom.add_vert(Vec3d(i, j, k));
-      }
+  double rad = std::min(o_off, sqrt(std::max(o_off, 0.0)));
+  lo = int(ceil(centre[axis] - rad));
+  hi = int(floor(centre[axis] + rad));
+}
+
+bool sph_lat_grid::in_container(int i, int j, int k) const
+{
+  double dist2 = (Vec3d(i, j, k) - centre).len2();
+  return !(o_width + epsilon < dist2 || i_width - epsilon > dist2);
 }
 
 // for lattice code only
@@ -308,7 +428,7 @@ double lattice_radius(const Geometry &geom, const char radius_type)
 
   // allow radius to be calculated for some polygons
   int dimensions;
-  Status stat = tgeom.set_hull("", &dimensions);
+  Status stat = tgeom.set_hull("", &dimensions, HULL_NATIVE);
   if (stat.is_error()) {
     fprintf(stderr, "%s\n", stat.c_msg());
     fprintf(stderr,
@@ -344,7 +464,7 @@ void geom_container_clip(Geometry &geom, Geometry &container,
                          const bool verbose, const double eps)
 {
   // container has to be convex and 3 dimensional
-  Status stat = container.set_hull();
+  Status stat = container.set_hull("", nullptr, HULL_NATIVE);
   if (stat.is_error()) {
     fprintf(stderr, "%s\n", stat.c_msg());
     fprintf(stderr,
@@ -717,22 +837,19 @@ int get_voronoi_geom(Geometry &geom, Geometry &vgeom, const bool central_cells,
   }
   hgeom.orient();
 
-  // Add centroid to a vector. Needed in this form for are_points_in_hull()
-  vector<Vec3d> cent = as_vector(centroid(hgeom.verts()));
+  // keep cells inside the hull, and which touch the centre if required
+  Vec3d cent = centroid(hgeom.verts());
+  auto in_hull = [&](const Vec3d &v) {
+    return are_points_in_hull(as_vector(v), hgeom, INCLUSION_IN | INCLUSION_ON,
+                              eps);
+  };
 
-  vector<Geometry> cells;
-  get_voronoi_cells(geom.verts(), &cells);
+  VoronoiCells cells;
+  get_voronoi_cells(geom.verts(), cells, in_hull,
+                    (central_cells) ? &cent : nullptr, eps);
 
-  for (auto &cell : cells) {
-    if (central_cells &&
-        !are_points_in_hull(cent, hgeom, INCLUSION_IN | INCLUSION_ON, eps)) {
-      continue;
-    }
-    else if (!are_points_in_hull(cell.verts(), hgeom,
-                                 INCLUSION_IN | INCLUSION_ON, eps)) {
-      continue;
-    }
-    vgeom.append(cell);
+  for (int i = 0; i < cells.num_cells(); i++) {
+    vgeom.append(cells.get_cell(i));
     if (one_cell_only)
       break;
   }
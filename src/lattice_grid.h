@@ -31,6 +31,7 @@
 #ifndef LATTICE_GRID_H
 #define LATTICE_GRID_H
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -92,6 +93,13 @@ protected:
   anti::Vec3d centre;
   COORD_TEST_F coord_test;
 
+  virtual void set_default_centre();
+  virtual void coord_range(int axis, int &lo, int &hi) const;
+  virtual bool in_container(int i, int j, int k) const;
+  void for_each_point(const std::function<void(int, int, int)> &func) const;
+  int for_each_strut(int len2,
+                     const std::function<void(int, int)> &func) const;
+
 public:
   // enum { l_sc, l_fcc, l_bcc, l_rh_dodec, l_cubo_oct,
   //   l_tr_oct, l_tr_tet_tet, l_tr_oct_tr_tet_cubo, l_diamond }
@@ -101,16 +109,28 @@ public:
   virtual void set_o_width(double w) { o_width = w; }
   virtual void set_i_width(double w) { i_width = w; }
   virtual void set_centre(anti::Vec3d cent) { centre = cent; }
-  virtual void make_lattice(anti::Geometry &geom);
+  void make_lattice(anti::Geometry &geom);
   // void add_struts(Geometry &geom, int len2);
+
+  /// Write the lattice, and its struts, to an OFF stream
+  /** The output is the same as make_lattice() followed by add_struts(),
+   *  but only a few slices of the lattice are held at a time.
+   * \param writer the open OFF stream.
+   * \param strut_len2 the square of the strut length, or \c 0 for no
+   *  struts. */
+  void write_lattice(anti::OffStreamWriter &writer, int strut_len2);
 };
 
 class sph_lat_grid : public int_lat_grid {
+protected:
+  virtual void set_default_centre();
+  virtual void coord_range(int axis, int &lo, int &hi) const;
+  virtual bool in_container(int i, int j, int k) const;
+
 public:
   sph_lat_grid() {}
   virtual void set_o_width(double w) { o_width = w; }
   virtual void set_i_width(double w) { i_width = w; }
-  virtual void make_lattice(anti::Geometry &geom);
 };
 
 #endif // LATTICE_GRID_H
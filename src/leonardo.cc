@@ -192,12 +192,10 @@ void leo_opts::process_command_line(int argc, char **argv)
 void get_open_edges(const Geometry &geom, vector<vector<int>> &open_edges)
 {
   open_edges.clear();
-  auto efpairs = geom.get_edge_face_pairs(false);
-
-  map<vector<int>, vector<int>>::const_iterator ei;
-  for (ei = efpairs.begin(); ei != efpairs.end(); ++ei) {
-    if (ei->second.size() == 1) // One faces at an edge
-      open_edges.push_back(ei->first);
+  EdgeFaces ef(geom);
+  for (int e = 0; e < ef.num_edges(); e++) {
+    if (ef.num_faces(e) == 1) // One faces at an edge
+      open_edges.push_back(ef.edge(e));
   }
 }
 
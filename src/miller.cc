@@ -66,6 +66,7 @@ public:
   int face_opacity;
 
   double epsilon;
+  int num_threads;
 
   miller_opts()
       : ProgramOpts("miller"), output_parts("s"), merge_faces(false),
@@ -73,7 +74,7 @@ public:
         vertex_coloring_method('\0'), edge_coloring_method('\0'),
         face_coloring_method('\0'), vertex_color(Color::invisible),
         edge_color(Color::invisible), face_color(Color()),
-        map_string("compound"), face_opacity(-1), epsilon(0)
+        map_string("compound"), face_opacity(-1), epsilon(0), num_threads(0)
   {
   }
   void process_command_line(int argc, char **argv);
@@ -100,6 +101,8 @@ void miller_opts::usage()
 "  -O <args> output s - stellation, d - diagram (default: s)\n"
 "  -l <lim>  minimum distance for unique vertex locations as negative exponent\n"
 "               (default: %d giving %.0e)\n"
+"  -j <thr>  number of threads for making the stellation diagrams\n"
+"               (default: 0, use all hardware threads)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
 "\nColoring Options (run 'off_util -H color' for help on color formats)\n"
 "  -F <opt>  face coloring method. d - from diagram, s - symmetry\n"
@@ -127,7 +130,7 @@ void miller_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hLMrO:V:E:F:T:m:l:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":hLMrO:V:E:F:T:m:l:j:o:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -197,6 +200,12 @@ void miller_opts::process_command_line(int argc, char **argv)
       }
       break;
 
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     case 'o':
       ofile = optarg;
       break;
@@ -322,15 +331,13 @@ void color_stellation(Geometry &stellation, const miller_opts &opts)
       clrng.e_face_color();
   }
   else if (opts.edge_coloring_method == 'C') {
-    auto efpairs = stellation.get_edge_face_pairs(false);
-    for (const auto &edge : stellation.edges()) {
-      vector<int> faces = efpairs[edge];
-      int i = find_edge_in_edge_list(stellation.edges(), edge);
-      if (i > -1) {
-        if (!(stellation.colors(EDGES).get(i)).is_invisible()) {
-          int connections = faces.size();
-          stellation.colors(EDGES).set(i, cmap->get_col(connections));
-        }
+    EdgeFaces ef(stellation);
+    for (unsigned int i = 0; i < stellation.edges().size(); i++) {
+      const vector<int> &edge = stellation.edges(i);
+      if (!(stellation.colors(EDGES).get(i)).is_invisible()) {
+        int e_idx = ef.find(edge[0], edge[1]);
+        int connections = (e_idx >= 0) ? ef.num_faces(e_idx) : 0;
+        stellation.colors(EDGES).set(i, cmap->get_col(connections));
       }
     }
   }
@@ -642,6 +649,7 @@ int Miller::get_poly(Geometry &geom, int sym, string cell_str, string sym_str, m
   vector<vector<int> > idx_lists(sz);
 
   // data sizes are verified
+  vector<int> stellation_face_idxs;
   for (unsigned int i = 0; i < diagram_list_strings.size(); i++) {
     if (!diagram_list_strings[i].length())
       continue;
@@ -649,13 +657,13 @@ int Miller::get_poly(Geometry &geom, int sym, string cell_str, string sym_str, m
     read_idx_list((char *)diagram_list_strings[i].c_str(), idx_lists[i], INT_MAX, false);
 
     // stellation face index is in the first position
-    int stellation_face_idx = idx_lists[i][0];
-
-    // construct the diagrams
-    if (!diagrams[stellation_face_idx].verts().size())
-      diagrams[stellation_face_idx] = make_stellation_diagram(geom, stellation_face_idx, sym_str);
+    stellation_face_idxs.push_back(idx_lists[i][0]);
   }
 
+  // construct the diagrams
+  make_stellation_diagrams(diagrams, geom, stellation_face_idxs, sym_str, 500,
+                           epsilon, false, opts.num_threads);
+
   bool merge_faces = opts.merge_faces;
   bool remove_inline_verts = Miller_items[sym].remove_inline_verts;
   bool split_pinched = true;
@@ -49,6 +49,7 @@ using std::map;
 using std::pair;
 using std::make_pair;
 using std::sort;
+using std::unique;
 
 using namespace anti;
 
@@ -158,6 +159,8 @@ public:
   Color face_default_color;
   Color edge_default_color;
   double epsilon;
+  string batch_file;
+  int num_threads;
 
   ColorMapMulti face_map;
   ColorMapMulti edge_map;
@@ -172,8 +175,8 @@ public:
   // former global variable
   bool split;
 
-  ncon_opts()
-      : ProgramOpts("n_icons"), ncon_order(4), d(1), build_method(0),
+  ncon_opts(const string &prog_name = "n_icons")
+      : ProgramOpts(prog_name), ncon_order(4), d(1), build_method(0),
         hide_indent(true), inner_radius(FLT_MAX), outer_radius(FLT_MAX),
         angle(0), point_cut(true), hybrid(false), add_poles(false), twist(1),
         info(false), add_symmetry_polygon(false), face_coloring_method('S'),
@@ -183,8 +186,9 @@ public:
         long_form(false), filter_case2(false), flood_fill_stop(0),
         face_default_color(Color(192, 192, 192, 255)), // darkgrey
         edge_default_color(Color(192, 192, 192, 255)), // darkgrey
-        epsilon(0), angle_is_side_cut(false), double_sweep(false),
-        radius_inversion(false), mod_twist(0), split(false)
+        epsilon(0), num_threads(0), angle_is_side_cut(false),
+        double_sweep(false), radius_inversion(false), mod_twist(0),
+        split(false)
   {
   }
 
@@ -228,6 +232,12 @@ void ncon_opts::usage()
 "  -l <lim>  minimum distance for unique vertex locations as negative exponent\n"
 "               (default: %d giving %.0e)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
+"  -B <file> batch mode. Read the options above, less -I, for one model per\n"
+"               line of file ('-' for standard input, '#' starts a comment).\n"
+"               Models are built in parallel and written to the -o of their\n"
+"               line, or else to a file numbered by model based on the -o of\n"
+"               the command line (default: n_icons.off)\n"
+"  -j <thr>  number of threads for batch mode (default: 0, use all cores)\n"
 "\nColoring Options (run 'off_util -H color' for help on color formats)\n"
 "  -f <mthd> mthd is face coloring method. The coloring is done before twist\n"
 "               key word: none - sets no color\n"
@@ -296,10 +306,9 @@ void ncon_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(
-              argc, argv,
-              ":hn:t:sHM:x:Ac:z:a:r:R:IJ:K:LZm:f:ST:O:e:U:P:Q:YD:X:Wl:o:")) !=
-         -1) {
+  while ((c = getopt(argc, argv,
+                     ":hn:t:sHM:x:Ac:z:a:r:R:IJ:K:LZm:f:ST:O:e:U:P:Q:YD:X:Wl:o:"
+                     "B:j:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -563,6 +572,16 @@ void ncon_opts::process_command_line(int argc, char **argv)
       ofile = optarg;
       break;
 
+    case 'B':
+      batch_file = optarg;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     default:
       error("unknown command line error");
     }
@@ -573,8 +592,13 @@ void ncon_opts::process_command_line(int argc, char **argv)
 
   epsilon = (sig_compare != INT_MAX) ? pow(10, -sig_compare) : ::epsilon;
 
+  // batch subsystem, the options are processed per model
+  if (batch_file.length() > 0) {
+    if (ncon_surf.length() > 0)
+      error("surface count reporting is not valid in batch mode", "J");
+  }
   // surfaces subsystem
-  if (ncon_surf.length() > 0) {
+  else if (ncon_surf.length() > 0) {
     if (ncon_range.size() == 0)
       error("for surfaces reporting -K must be specified", "J");
     else if (!is_even(ncon_range.front()) &&
@@ -915,59 +939,45 @@ int num_lats(const int ncon_order, const bool point_cut)
   return lats;
 }
 
-int num_lats_faces(const vector<faceList *> &face_list)
+int num_lats_faces(const vector<faceList> &face_list)
 {
   int lats = 0;
-  for (auto i : face_list)
-    if (i->lat > lats)
-      lats = i->lat;
+  for (auto &i : face_list)
+    if (i.lat > lats)
+      lats = i.lat;
   // account for lat 0
   return lats + 1;
 }
 
-int num_lats_edges(const vector<edgeList *> &edge_list)
+int num_lats_edges(const vector<edgeList> &edge_list)
 {
   int lats = 0;
-  for (auto i : edge_list)
-    if (i->lat > lats)
-      lats = i->lat;
+  for (auto &i : edge_list)
+    if (i.lat > lats)
+      lats = i.lat;
   return lats;
 }
 
-void add_coord(Geometry &geom, vector<coordList *> &coordinates,
+void add_coord(Geometry &geom, vector<coordList> &coordinates,
                const Vec3d &vert)
 {
-  coordinates.push_back(new coordList(geom.add_vert(vert)));
-}
-
-void clear_coord(vector<coordList *> &coordinates)
-{
-  for (auto &coordinate : coordinates)
-    delete coordinate;
-  coordinates.clear();
+  coordinates.push_back(coordList(geom.add_vert(vert)));
 }
 
-void add_face(Geometry &geom, vector<faceList *> &face_list,
+void add_face(Geometry &geom, vector<faceList> &face_list,
               const vector<int> &face, const int lat, const int lon)
 {
-  face_list.push_back(new faceList(geom.add_face(face), lat, lon, 0));
+  face_list.push_back(faceList(geom.add_face(face), lat, lon, 0));
 }
 
-void add_face(Geometry &geom, vector<faceList *> &face_list,
+void add_face(Geometry &geom, vector<faceList> &face_list,
               const vector<int> &face, const int lat, const int lon,
               const int polygon_no)
 {
-  face_list.push_back(new faceList(geom.add_face(face), lat, lon, polygon_no));
+  face_list.push_back(faceList(geom.add_face(face), lat, lon, polygon_no));
 }
 
-void clear_faces(vector<faceList *> &face_list)
-{
-  for (auto &i : face_list)
-    delete i;
-  face_list.clear();
-}
-
-void delete_face_list_items(vector<faceList *> &face_list,
+void delete_face_list_items(vector<faceList> &face_list,
                             const vector<int> &f_nos)
 {
   vector<int> dels = f_nos;
@@ -985,25 +995,18 @@ void delete_face_list_items(vector<faceList *> &face_list,
       face_list[map_to] = face_list[i];
     }
   }
-  face_list.resize(face_list.size() - del_faces_cnt);
+  face_list.erase(face_list.end() - del_faces_cnt, face_list.end());
 }
 
 // pass edge by value from make_edge()
 // only add_edge_raw can be used else edge count is not correct for n_icons
-void add_edge(Geometry &geom, vector<edgeList *> &edge_list,
+void add_edge(Geometry &geom, vector<edgeList> &edge_list,
               const vector<int> &edge, const int lat, const int lon)
 {
-  edge_list.push_back(new edgeList(geom.add_edge_raw(edge), lat, lon));
+  edge_list.push_back(edgeList(geom.add_edge_raw(edge), lat, lon));
 }
 
-void clear_edges(vector<edgeList *> &edge_list)
-{
-  for (auto &i : edge_list)
-    delete i;
-  edge_list.clear();
-}
-
-void delete_edge_list_items(vector<edgeList *> &edge_list,
+void delete_edge_list_items(vector<edgeList> &edge_list,
                             const vector<int> &f_nos)
 {
   vector<int> dels = f_nos;
@@ -1021,7 +1024,7 @@ void delete_edge_list_items(vector<edgeList *> &edge_list,
       edge_list[map_to] = edge_list[i];
     }
   }
-  edge_list.resize(edge_list.size() - del_edges_cnt);
+  edge_list.erase(edge_list.end() - del_edges_cnt, edge_list.end());
 }
 
 class vertexMap {
@@ -1044,7 +1047,7 @@ void remap_elems(vector<vector<int>> &elems,
   }
 }
 
-void merge_halves(Geometry &geom, vector<polarOrb *> &polar_orbit,
+void merge_halves(Geometry &geom, vector<polarOrb> &polar_orbit,
                   const double eps)
 {
   const vector<Vec3d> &verts = geom.verts();
@@ -1052,9 +1055,9 @@ void merge_halves(Geometry &geom, vector<polarOrb *> &polar_orbit,
   vector<vertexMap> coordinate_pairs;
 
   for (unsigned int i = 0; i < polar_orbit.size(); i++) {
-    int c1 = polar_orbit[i]->coord_no;
+    int c1 = polar_orbit[i].coord_no;
     for (unsigned int j = i + 1; j < polar_orbit.size(); j++) {
-      int c2 = polar_orbit[j]->coord_no;
+      int c2 = polar_orbit[j].coord_no;
       if (!compare(verts[c1], verts[c2], eps)) {
         coordinate_pairs.push_back(vertexMap(c1, c2));
         break;
@@ -1070,8 +1073,8 @@ void merge_halves(Geometry &geom, vector<polarOrb *> &polar_orbit,
 
 // method 3: prime polygon is analog of prime meridian
 void build_prime_polygon(Geometry &geom, vector<int> &prime_meridian,
-                         vector<coordList *> &coordinates,
-                         const vector<poleList *> &pole, const ncon_opts &opts)
+                         vector<coordList> &coordinates, vector<poleList> &pole,
+                         const ncon_opts &opts)
 {
   // for finding poles, the accuracy must be less than the default
   double epsilon_local = 1e-8;
@@ -1105,14 +1108,14 @@ void build_prime_polygon(Geometry &geom, vector<int> &prime_meridian,
                                        sin(deg2rad(ang)) * radius, 0.0));
     if (double_eq(fmod(angle_in_range(ang, opts.epsilon), 360.0), 90.0,
                   epsilon_local)) {
-      pole[0]->idx = geom.verts().size() - 1;
-      pole[0]->lat = 0;
+      pole[0].idx = geom.verts().size() - 1;
+      pole[0].lat = 0;
     }
     else if (double_eq(fmod(angle_in_range(ang, opts.epsilon), 360.0), 270.0,
                        epsilon_local)) {
-      pole[1]->idx = geom.verts().size() - 1;
+      pole[1].idx = geom.verts().size() - 1;
       // all coloring and circuits considered make it point cut. make it true
-      pole[1]->lat = num_lats(opts.ncon_order, true);
+      pole[1].lat = num_lats(opts.ncon_order, true);
     }
     ang += arc;
     if (compound) {
@@ -1150,7 +1153,7 @@ void reverse_poly_indexes_on_y(Geometry &geom, vector<int> &polygon,
 
 // bypass is for testing. rotation will not work if true
 vector<vector<int>> split_bow_ties(Geometry &geom,
-                                   vector<coordList *> &coordinates,
+                                   vector<coordList> &coordinates,
                                    const vector<int> &face, const double eps)
 {
   bool bypass = false;
@@ -1205,43 +1208,123 @@ vector<vector<int>> split_bow_ties(Geometry &geom,
   return faces;
 }
 
-vector<int> find_face_by_lat_lon(const vector<faceList *> &face_list,
-                                 const int lat, const int lon)
-{
-  vector<int> idx;
-  for (unsigned int i = 0; i < face_list.size(); i++) {
-    if (face_list[i]->lat == lat && face_list[i]->lon == lon)
-      idx.push_back(i);
+// indexes of face or edge list items by latitude and longitude. The list
+// should not be changed while the index is in use
+class latLonIndex {
+private:
+  map<pair<int, int>, vector<int>> idxs;
+
+public:
+  template <class T> latLonIndex(const vector<T> &elem_list)
+  {
+    for (unsigned int i = 0; i < elem_list.size(); i++)
+      idxs[make_pair(elem_list[i].lat, elem_list[i].lon)].push_back(i);
+  }
+
+  vector<int> find(const int lat, const int lon) const
+  {
+    auto mi = idxs.find(make_pair(lat, lon));
+    return (mi != idxs.end()) ? mi->second : vector<int>();
   }
-  return idx;
+};
+
+// map each edge to its first index in edges
+void fill_edge_index(const vector<vector<int>> &edges,
+                     map<vector<int>, int> &edge_index)
+{
+  for (int i = 0; i < (int)edges.size(); i++)
+    edge_index.insert(make_pair(make_edge(edges[i][0], edges[i][1]), i));
 }
 
-vector<int> find_edge_by_lat_lon(const vector<edgeList *> &edge_list,
-                                 const int lat, const int lon)
+int find_edge_in_edge_index(const map<vector<int>, int> &edge_index,
+                            const vector<int> &edge)
 {
-  vector<int> idx;
-  for (unsigned int i = 0; i < edge_list.size(); i++) {
-    if (edge_list[i]->lat == lat && edge_list[i]->lon == lon)
-      idx.push_back(i);
+  auto mi = edge_index.find(make_edge(edge[0], edge[1]));
+  return (mi != edge_index.end()) ? mi->second : -1;
+}
+
+// map each edge to the faces that include it, in index order and each face
+// only once, so an entry is as find_faces_with_edge() would return
+void fill_edge_faces(const vector<vector<int>> &faces,
+                     map<vector<int>, vector<int>> &edge_faces)
+{
+  for (int i = 0; i < (int)faces.size(); i++) {
+    int sz = faces[i].size();
+    for (int j = 0; j < sz; j++) {
+      vector<int> &face_idxs =
+          edge_faces[make_edge(faces[i][j], faces[i][(j + 1) % sz])];
+      if (!face_idxs.size() || face_idxs.back() != i)
+        face_idxs.push_back(i);
+    }
   }
-  return idx;
 }
 
-bool add_edge_wrapper(Geometry &geom, vector<edgeList *> &edge_list,
+vector<int> find_faces_in_edge_faces(
+    const map<vector<int>, vector<int>> &edge_faces, const vector<int> &edge)
+{
+  auto mi = edge_faces.find(make_edge(edge[0], edge[1]));
+  return (mi != edge_faces.end()) ? mi->second : vector<int>();
+}
+
+// map each vertex to the elements that include it, as
+// find_elems_with_vertex() would return them. These are held in one array
+// and those for vertex v are returned by find(v)
+class vertexElems {
+private:
+  vector<int> offsets;
+  vector<int> elem_idxs;
+
+  // an element only counts once for a vertex it repeats
+  static vector<int> distinct_verts(vector<int> elem)
+  {
+    sort(elem.begin(), elem.end());
+    elem.erase(unique(elem.begin(), elem.end()), elem.end());
+    return elem;
+  }
+
+public:
+  vertexElems(const vector<vector<int>> &elems, const int num_verts)
+      : offsets(num_verts + 1, 0)
+  {
+    // count the elements of each vertex then place them
+    for (const auto &elem : elems)
+      for (int v_idx : distinct_verts(elem))
+        offsets[v_idx + 1]++;
+    for (int i = 0; i < num_verts; i++)
+      offsets[i + 1] += offsets[i];
+
+    vector<int> pos(offsets.begin(), offsets.end() - 1);
+    elem_idxs.resize(offsets.back());
+    for (int i = 0; i < (int)elems.size(); i++)
+      for (int v_idx : distinct_verts(elems[i]))
+        elem_idxs[pos[v_idx]++] = i;
+  }
+
+  vector<int> find(const int v_idx) const
+  {
+    return vector<int>(elem_idxs.begin() + offsets[v_idx],
+                       elem_idxs.begin() + offsets[v_idx + 1]);
+  }
+};
+
+// edge_index is of the edges in geom, and is updated
+bool add_edge_wrapper(Geometry &geom, vector<edgeList> &edge_list,
+                      map<vector<int>, int> &edge_index,
                       const vector<int> &edge, const int lat,
                       const int lon_front, const int lon_back)
 {
   const vector<Vec3d> &verts = geom.verts();
 
-  int edge_no = find_edge_in_edge_list(geom.edges(), edge);
+  int edge_no = find_edge_in_edge_index(edge_index, edge);
   if (edge_no < 0) {
     double edge_z = centroid(verts, edge)[2];
 
     int lon = (edge_z > 0.0) ? lon_front : lon_back;
     add_edge(geom, edge_list, make_edge(edge[0], edge[1]), lat, lon);
+    edge_index[make_edge(edge[0], edge[1])] = geom.edges().size() - 1;
 
     if (edge_z > 0.0) // || double_eq(edge_z,0.0,eps))
-      edge_list.back()->rotate = true;
+      edge_list.back().rotate = true;
   }
 
   return (edge_no < 0 ? false : true);
@@ -1250,9 +1333,8 @@ bool add_edge_wrapper(Geometry &geom, vector<edgeList *> &edge_list,
 // split_face_indexes is cleared after use
 void apply_latitudes(const Geometry &geom,
                      vector<vector<int>> &split_face_indexes,
-                     const vector<faceList *> &face_list,
-                     const vector<edgeList *> &edge_list,
-                     const vector<poleList *> &pole, const ncon_opts &opts)
+                     vector<faceList> &face_list, vector<edgeList> &edge_list,
+                     const vector<poleList> &pole, const ncon_opts &opts)
 {
   const vector<vector<int>> &faces = geom.faces();
   const vector<vector<int>> &edges = geom.edges();
@@ -1266,19 +1348,19 @@ void apply_latitudes(const Geometry &geom,
   vector<int> edge_lats_save;
   if (opts.build_method == 2) {
     for (unsigned int i = 0; i < edge_list.size(); i++) {
-      int j = edge_list[i]->edge_no;
-      edge_lats_save.push_back(edge_list[j]->lat);
+      int j = edge_list[i].edge_no;
+      edge_lats_save.push_back(edge_list[j].lat);
     }
   }
 
   // collect Y value of edges and map them
   map<int, vector<int>> levels_edges;
   if (opts.build_method == 2) {
-    for (auto i : edge_list) {
-      int j = i->edge_no;
-      if (i->lat < 0)
+    for (auto &i : edge_list) {
+      int j = i.edge_no;
+      if (i.lat < 0)
         continue;
-      int level = i->lat - 1;
+      int level = i.lat - 1;
       levels_edges[level].push_back(j);
     }
 
@@ -1300,18 +1382,18 @@ void apply_latitudes(const Geometry &geom,
     }
 
     // clear face latitudes
-    for (auto i : face_list)
-      i->lat = -1;
+    for (auto &i : face_list)
+      i.lat = -1;
     // clear edge latitudes
-    for (auto i : edge_list) {
-      if (i->lat > -1)
-        i->lat = -1;
+    for (auto &i : edge_list) {
+      if (i.lat > -1)
+        i.lat = -1;
     }
   }
   else if (opts.build_method == 3) {
     vector<pair<double, int>> edge_ys;
-    for (auto i : edge_list) {
-      int j = i->edge_no;
+    for (auto &i : edge_list) {
+      int j = i.edge_no;
       double y = verts[edges[j][0]][1];
       edge_ys.push_back(make_pair(y, j));
     }
@@ -1350,6 +1432,8 @@ void apply_latitudes(const Geometry &geom,
     split_face_indexes.clear();
 
     // each face is associated with one or two edges
+    map<vector<int>, int> edge_index;
+    fill_edge_index(edges, edge_index);
     map<int, vector<int>> faces_edges_map;
     for (unsigned int i = 0; i < faces.size(); i++) {
       vector<int> face = faces[i];
@@ -1358,7 +1442,7 @@ void apply_latitudes(const Geometry &geom,
         vector<int> edge(2);
         edge[0] = face[j];
         edge[1] = face[(j + 1) % sz];
-        int ret = find_edge_in_edge_list(edges, edge);
+        int ret = find_edge_in_edge_index(edge_index, edge);
         if (ret > -1)
           faces_edges_map[i].push_back(ret);
       }
@@ -1382,20 +1466,20 @@ void apply_latitudes(const Geometry &geom,
     int part_number = 1;
     while (part_number) {
       // if south pole is included, colors are backward
-      // if ((part_number == 1) && ((pole[0]->lat > -1) || (pole[1]->lat > -1)))
+      // if ((part_number == 1) && ((pole[0].lat > -1) || (pole[1].lat > -1)))
       // {
-      //   int v_idx = (pole[0]->lat > -1) ? pole[0]->idx : pole[1]->idx;
-      if ((part_number == 1) && (pole[0]->lat > -1)) {
-        int v_idx = pole[0]->idx;
+      //   int v_idx = (pole[0].lat > -1) ? pole[0].idx : pole[1].idx;
+      if ((part_number == 1) && (pole[0].lat > -1)) {
+        int v_idx = pole[0].idx;
         vector<int> faces_with_index = find_faces_with_vertex(faces, v_idx);
         for (int j : faces_with_index) {
-          face_list[j]->lat = lat - 1;
+          face_list[j].lat = lat - 1;
           int k = split_face_map[j];
-          face_list[k]->lat = lat - 1;
+          face_list[k].lat = lat - 1;
           vector<int> edge_idx = faces_edges_map[k];
           for (int m : edge_idx) {
-            if (edge_list[m]->lat == -1) {
-              edge_list[m]->lat = lat;
+            if (edge_list[m].lat == -1) {
+              edge_list[m].lat = lat;
               last_edges.push_back(m);
             }
           }
@@ -1427,7 +1511,7 @@ void apply_latitudes(const Geometry &geom,
 
         // set latitude on first edge level
         for (int j : levels_edges[first_level]) {
-          edge_list[j]->lat = lat;
+          edge_list[j].lat = lat;
           last_edges.push_back(j);
         }
 
@@ -1470,9 +1554,9 @@ void apply_latitudes(const Geometry &geom,
             para--;
 
           int j = face_idx[face_painted];
-          face_list[j]->lat = para;
+          face_list[j].lat = para;
           int k = split_face_map[j];
-          face_list[k]->lat = para;
+          face_list[k].lat = para;
         }
       }
 
@@ -1486,7 +1570,7 @@ void apply_latitudes(const Geometry &geom,
           if (i == 0) {
             early_ending = true;
             for (int k : face_idx) {
-              if (face_list[k]->lat == -1)
+              if (face_list[k].lat == -1)
                 early_ending = false;
             }
           }
@@ -1494,7 +1578,7 @@ void apply_latitudes(const Geometry &geom,
             break;
 
           for (int k : face_idx) {
-            if (face_list[k]->lat != -1)
+            if (face_list[k].lat != -1)
               continue;
 
             int para = 0;
@@ -1506,12 +1590,12 @@ void apply_latitudes(const Geometry &geom,
             if (early_mode)
               para--;
 
-            face_list[k]->lat = para;
+            face_list[k].lat = para;
             int l = split_face_map[k];
-            face_list[l]->lat = para;
+            face_list[l].lat = para;
             vector<int> edges_idx = faces_edges_map[l];
             for (int n : edges_idx) {
-              if (edge_list[n]->lat == -1)
+              if (edge_list[n].lat == -1)
                 next_edges.push_back(n);
             }
           }
@@ -1520,7 +1604,7 @@ void apply_latitudes(const Geometry &geom,
         lat++;
 
         for (int next_edge : next_edges)
-          edge_list[next_edge]->lat = lat;
+          edge_list[next_edge].lat = lat;
         last_edges = next_edges;
       }
 
@@ -1529,7 +1613,7 @@ void apply_latitudes(const Geometry &geom,
       for (unsigned int i = 0; i < levels_edges.size(); i++) {
         for (unsigned int j = 0; j < levels_edges[i].size(); j++) {
           int k = levels_edges[i][j];
-          if (edge_list[k]->lat == -1) {
+          if (edge_list[k].lat == -1) {
             found = true;
             first_level = i;
             break;
@@ -1560,14 +1644,14 @@ void apply_latitudes(const Geometry &geom,
         int lat = edge_lats_save[i];
         if (lat < -1)
           lat = (opts.hide_indent) ? -1 : abs(lat + 2);
-        edge_list[i]->lat = lat;
+        edge_list[i].lat = lat;
       }
     }
     else if (opts.build_method == 3) {
       for (unsigned int i = 0; i < levels_edges.size(); i++) {
         for (unsigned int j = 0; j < levels_edges[i].size(); j++) {
           int k = levels_edges[i][j];
-          edge_list[k]->lat = i + 1;
+          edge_list[k].lat = i + 1;
         }
       }
     }
@@ -1579,7 +1663,7 @@ void apply_latitudes(const Geometry &geom,
       int lat = edge_lats_save[i];
       if (lat < -1) {
         lat = (opts.hide_indent) ? -1 : abs(lat + 2);
-        edge_list[i]->lat = lat;
+        edge_list[i].lat = lat;
       }
     }
   }
@@ -1592,9 +1676,8 @@ void apply_latitudes(const Geometry &geom,
 void apply_latitudes(const Geometry &geom,
                      const vector<vector<int>> &original_faces,
                      const vector<vector<int>> &split_face_indexes,
-                     const vector<faceList *> &face_list,
-                     const vector<edgeList *> &edge_list,
-                     const vector<poleList *> &pole, const ncon_opts &opts)
+                     vector<faceList> &face_list, vector<edgeList> &edge_list,
+                     const vector<poleList> &pole, const ncon_opts &opts)
 {
   const vector<vector<int>> &faces = geom.faces();
   const vector<vector<int>> &edges = geom.edges();
@@ -1634,7 +1717,7 @@ void apply_latitudes(const Geometry &geom,
       }
     }
     int j = edge_y.second;
-    edge_list[j]->lat = lat;
+    edge_list[j].lat = lat;
     last_y = edge_y.first;
   }
 
@@ -1662,14 +1745,14 @@ void apply_latitudes(const Geometry &geom,
   int max_lat_used = 0;
 
   // if there is a north pole
-  if (pole[0]->idx != -1) {
-    Vec3d np = verts[pole[0]->idx];
+  if (pole[0].idx != -1) {
+    Vec3d np = verts[pole[0].idx];
     for (unsigned int i = 0; i < faces.size(); i++) {
       vector<int> face = faces[i];
       for (int j : face) {
         Vec3d v = verts[j];
         if (!compare(v, np, opts.epsilon)) {
-          face_list[i]->lat = 0;
+          face_list[i].lat = 0;
           break;
         }
       }
@@ -1679,6 +1762,9 @@ void apply_latitudes(const Geometry &geom,
 
   wait = (double_sw) ? 2 : 0;
 
+  map<vector<int>, vector<int>> edge_faces;
+  fill_edge_faces(original_faces, edge_faces);
+
   last_y = edge_ys[0].first;
   for (auto &edge_y : edge_ys) {
     if (double_ne(edge_y.first, last_y, opts.epsilon)) {
@@ -1691,7 +1777,7 @@ void apply_latitudes(const Geometry &geom,
     }
 
     int j = edge_y.second;
-    vector<int> face_idx = find_faces_with_edge(original_faces, edges[j]);
+    vector<int> face_idx = find_faces_in_edge_faces(edge_faces, edges[j]);
     // edge must have 2 faces
     if (face_idx.size() != 2)
       continue;
@@ -1706,14 +1792,14 @@ void apply_latitudes(const Geometry &geom,
       int sz = split_face_indexes[l].size();
       for (int m = 0; m < sz; m++) {
         int n = split_face_indexes[l][m];
-        if (face_list[n]->lat == -1) {
+        if (face_list[n].lat == -1) {
           int lat_used = (!k || (k && !first_lat_used)) ? lat - 1 : lat;
           if (lat_used > max_lat_used)
             max_lat_used = lat_used;
-          face_list[n]->lat = lat_used;
+          face_list[n].lat = lat_used;
         }
         else {
-          if (!k && (face_list[n]->lat != lat - 1))
+          if (!k && (face_list[n].lat != lat - 1))
             first_lat_used = false;
         }
       }
@@ -1722,41 +1808,47 @@ void apply_latitudes(const Geometry &geom,
 }
 
 // method 3: fix polygon numbers for compound coloring
-void fix_polygon_numbers(const vector<faceList *> &face_list,
-                         const ncon_opts &opts)
+void fix_polygon_numbers(vector<faceList> &face_list, const ncon_opts &opts)
 {
+  latLonIndex face_index(face_list);
+
+  // the minimum polygon number found for a latitude is applied to the
+  // whole latitude
+  map<int, int> lat_polygon_min;
   int sz = 0;
   int lat = 0;
   do {
     int polygon_min = INT_MAX;
     for (unsigned int j = 0; j < 2; j++) {
       int lon = (opts.longitudes.front() / 2) - j;
-      vector<int> idx = find_face_by_lat_lon(face_list, lat, lon);
+      vector<int> idx = face_index.find(lat, lon);
       sz = (int)idx.size();
       for (int k = 0; k < sz; k++) {
-        int polygon_no = face_list[idx[k]]->polygon_no;
+        int polygon_no = face_list[idx[k]].polygon_no;
         if (polygon_no < polygon_min)
           polygon_min = polygon_no;
       }
     }
 
-    if (polygon_min != INT_MAX) {
-      for (auto j : face_list) {
-        if (j->lat == lat)
-          j->polygon_no = polygon_min;
-      }
-    }
+    if (polygon_min != INT_MAX)
+      lat_polygon_min[lat] = polygon_min;
     lat++;
   } while (sz);
+
+  for (auto &j : face_list) {
+    auto mi = lat_polygon_min.find(j.lat);
+    if (mi != lat_polygon_min.end())
+      j.polygon_no = mi->second;
+  }
 }
 
 // for method 3: analog to form_globe()
 // maximum latitudes is set
 void form_angular_model(Geometry &geom, const vector<int> &prime_meridian,
-                        vector<coordList *> &coordinates,
-                        vector<faceList *> &face_list,
-                        vector<edgeList *> &edge_list,
-                        const vector<poleList *> &pole,
+                        vector<coordList> &coordinates,
+                        vector<faceList> &face_list,
+                        vector<edgeList> &edge_list,
+                        const vector<poleList> &pole,
                         vector<vector<int>> &original_faces,
                         vector<vector<int>> &split_face_indexes,
                         const int polygons_total, const ncon_opts &opts)
@@ -1772,6 +1864,10 @@ void form_angular_model(Geometry &geom, const vector<int> &prime_meridian,
   vector<int> meridian_last;
   vector<int> meridian;
 
+  // edges are added as the model is formed
+  map<vector<int>, int> edge_index;
+  fill_edge_index(geom.edges(), edge_index);
+
   for (int i = 1; i <= polygons_total; i++) {
     // move current meridian one back
     meridian_last = (i == 1) ? prime_meridian : meridian;
@@ -1787,7 +1883,7 @@ void form_angular_model(Geometry &geom, const vector<int> &prime_meridian,
       meridian.clear();
       for (int j = 0; j < opts.ncon_order; j++) {
         int m = prime_meridian[j];
-        if (m == pole[0]->idx || m == pole[1]->idx)
+        if (m == pole[0].idx || m == pole[1].idx)
           meridian.push_back(m);
         else {
           // Rotate Point Counter-Clockwise about Y Axis (looking down through Y
@@ -1861,15 +1957,15 @@ void form_angular_model(Geometry &geom, const vector<int> &prime_meridian,
 
           // the front face is what is rotated
           if (face_z > 0.0)
-            face_list.back()->rotate = true;
+            face_list.back().rotate = true;
 
           // always add edges to discover face latitudes
           if (top_edge.size() == 2)
-            add_edge_wrapper(geom, edge_list, top_edge, -1, lon_front,
-                             lon_back);
+            add_edge_wrapper(geom, edge_list, edge_index, top_edge, -1,
+                             lon_front, lon_back);
           if (bottom_edge.size() == 2)
-            add_edge_wrapper(geom, edge_list, bottom_edge, -1, lon_front,
-                             lon_back);
+            add_edge_wrapper(geom, edge_list, edge_index, bottom_edge, -1,
+                             lon_front, lon_back);
         }
 
         if (split_face_idx.size()) {
@@ -1891,16 +1987,16 @@ void form_angular_model(Geometry &geom, const vector<int> &prime_meridian,
 // for method 2: to hide uneeded edges
 // note that function used to reverse indented based on manual inner and outer
 // radii
-void mark_indented_edges_invisible(const vector<edgeList *> &edge_list,
-                                   const vector<poleList *> &pole,
+void mark_indented_edges_invisible(vector<edgeList> &edge_list,
+                                   vector<poleList> &pole,
                                    const bool radius_reverse,
                                    const ncon_opts &opts)
 {
   // for method 2 we used n/2
   int n = opts.ncon_order / 2;
 
-  for (auto i : edge_list) {
-    int lat = i->lat;
+  for (auto &i : edge_list) {
+    int lat = i.lat;
     bool set_invisible = (is_even(n) && opts.point_cut && !is_even(lat)) ||
                          (is_even(n) && !opts.point_cut && is_even(lat)) ||
                          (!is_even(n) && is_even(lat));
@@ -1908,34 +2004,33 @@ void mark_indented_edges_invisible(const vector<edgeList *> &edge_list,
       set_invisible = (set_invisible) ? false : true;
     // negative latitudes to temporarily label indented edges
     if (set_invisible) {
-      int lat = i->lat;
+      int lat = i.lat;
       lat = -lat - 2;
-      i->lat = lat;
+      i.lat = lat;
     }
   }
 
   for (unsigned int i = 0; i < 2; i++) {
-    if (pole[i]->idx > -1) {
-      int lat = pole[i]->lat;
+    if (pole[i].idx > -1) {
+      int lat = pole[i].lat;
       bool set_invisible = (is_even(n) && opts.point_cut && !is_even(lat)) ||
                            (is_even(n) && !opts.point_cut && is_even(lat)) ||
                            (!is_even(n) && is_even(lat));
       if (radius_reverse)
         set_invisible = (set_invisible) ? false : true;
       if (set_invisible)
-        pole[i]->lat = -1;
+        pole[i].lat = -1;
     }
   }
 }
 
-void restore_indented_edges(const vector<edgeList *> &edge_list,
-                            const ncon_opts &opts)
+void restore_indented_edges(vector<edgeList> &edge_list, const ncon_opts &opts)
 {
-  for (auto i : edge_list) {
-    int lat = i->lat;
+  for (auto &i : edge_list) {
+    int lat = i.lat;
     if (lat < -1) {
       lat = (opts.hide_indent) ? -1 : abs(lat + 2);
-      i->lat = lat;
+      i.lat = lat;
     }
   }
 }
@@ -1981,9 +2076,9 @@ vector<pair<int, int>> get_lat_pairs(const int n, int d, const bool point_cut)
 // for method 2: set latitude numbers for pairs of faces of shell models
 // then split_face_indexes is filled
 void find_split_faces_shell_model(const Geometry &geom,
-                                  const vector<faceList *> &face_list,
-                                  const vector<edgeList *> &edge_list,
-                                  const vector<poleList *> &pole,
+                                  vector<faceList> &face_list,
+                                  vector<edgeList> &edge_list,
+                                  vector<poleList> &pole,
                                   vector<vector<int>> &split_face_indexes,
                                   const ncon_opts &opts)
 {
@@ -2003,28 +2098,28 @@ void find_split_faces_shell_model(const Geometry &geom,
     vector<pair<int, int>> lat_pairs = get_lat_pairs(n, opts.d, pc);
 
     for (auto &lat_pair : lat_pairs) {
-      for (auto j : face_list) {
-        if (j->lat == lat_pair.first || j->lat == lat_pair.second)
-          j->lat = lat;
+      for (auto &j : face_list) {
+        if (j.lat == lat_pair.first || j.lat == lat_pair.second)
+          j.lat = lat;
       }
       lat++;
     }
 
     if (opts.hide_indent) {
-      for (auto i : edge_list) {
-        lat = i->lat;
+      for (auto &i : edge_list) {
+        lat = i.lat;
         if (lat > 1) {
           int adjust = (is_even(lat)) ? 0 : 1;
-          i->lat = (int)floor((double)lat / 2) + adjust;
+          i.lat = (int)floor((double)lat / 2) + adjust;
         }
       }
 
       // fix south pole
-      if (pole[1]->idx != -1) {
-        lat = pole[1]->lat;
+      if (pole[1].idx != -1) {
+        lat = pole[1].lat;
         if (lat > 1) {
           int adjust = (is_even(lat)) ? 0 : 1;
-          pole[1]->lat = (int)floor((double)n / 2) + adjust;
+          pole[1].lat = (int)floor((double)n / 2) + adjust;
         }
       }
     }
@@ -2037,7 +2132,7 @@ void find_split_faces_shell_model(const Geometry &geom,
     face_zs.clear();
     for (unsigned int i = 0; i < face_list.size(); i++) {
       // collect Z centroids of faces
-      if (face_list[i]->lat == lat) {
+      if (face_list[i].lat == lat) {
         Vec3d face_cent = centroid(verts, faces[i]);
         double angle = angle_around_axis(face_cent, Vec3d(1, 0, 0), Vec3d::Y);
         face_zs.push_back(make_pair(angle, i));
@@ -2117,9 +2212,9 @@ void calc_radii(double &inner_radius, double &outer_radius, double &arc,
 // inner_radius, outer_radius set
 // point_cut_calc changed from side cut to point cut if build method 2 and d > 1
 void build_prime_meridian(Geometry &geom, vector<int> &prime_meridian,
-                          vector<coordList *> &coordinates,
-                          double &inner_radius, double &outer_radius,
-                          bool &point_cut_calc, const ncon_opts &opts)
+                          vector<coordList> &coordinates, double &inner_radius,
+                          double &outer_radius, bool &point_cut_calc,
+                          const ncon_opts &opts)
 {
   int n = opts.ncon_order; // pass n and d as const
   int d = opts.d;
@@ -2195,8 +2290,8 @@ vector<int> calc_polygon_numbers(int n, int d, bool point_cut)
 
 // methods 1 and 2
 void form_globe(Geometry &geom, const vector<int> &prime_meridian,
-                vector<coordList *> &coordinates, vector<faceList *> &face_list,
-                vector<edgeList *> &edge_list, const bool point_cut_calc,
+                vector<coordList> &coordinates, vector<faceList> &face_list,
+                vector<edgeList> &edge_list, const bool point_cut_calc,
                 const bool second_half, const ncon_opts &opts)
 {
   const vector<vector<int>> &faces = geom.faces();
@@ -2351,7 +2446,7 @@ void form_globe(Geometry &geom, const vector<int> &prime_meridian,
 
             // patch with the extra edge below, one rotate flag gets missed
             if (half_model_marker != 0)
-              edge_list.back()->rotate = true;
+              edge_list.back().rotate = true;
 
             // the last square has two edges if there is no bottom triangle
             if (lat == lon_faces &&
@@ -2362,9 +2457,9 @@ void form_globe(Geometry &geom, const vector<int> &prime_meridian,
         }
 
         if (half_model_marker != 0) {
-          face_list.back()->rotate = true;
+          face_list.back().rotate = true;
           if (opts.edge_coloring_method || opts.build_method > 1)
-            edge_list.back()->rotate = true;
+            edge_list.back().rotate = true;
         }
       }
     }
@@ -2373,8 +2468,8 @@ void form_globe(Geometry &geom, const vector<int> &prime_meridian,
 
 // add caps to method 1 and 2 models
 // caps indexes are retained
-void add_caps(Geometry &geom, vector<coordList *> &coordinates,
-              vector<faceList *> &face_list, const vector<poleList *> &pole,
+void add_caps(Geometry &geom, vector<coordList> &coordinates,
+              vector<faceList> &face_list, vector<poleList> &pole,
               vector<int> &caps, const bool point_cut_calc,
               const ncon_opts &opts)
 {
@@ -2399,25 +2494,25 @@ void add_caps(Geometry &geom, vector<coordList *> &coordinates,
           : -1;
   int lon_back = (opts.build_method == 2) ? lon_front - 1 : -1;
 
-  pole[0]->idx = -1;
-  pole[0]->lat = -1;
-  pole[1]->idx = -1;
-  pole[1]->lat = lats;
+  pole[0].idx = -1;
+  pole[0].lat = -1;
+  pole[1].idx = -1;
+  pole[1].lat = lats;
 
   // Even order and point cut always have poles (and south pole = 0)
   if (is_even(opts.ncon_order) && point_cut_calc) {
-    pole[0]->idx = longitudinal_faces(opts.ncon_order, point_cut_calc);
-    pole[1]->idx = 0;
+    pole[0].idx = longitudinal_faces(opts.ncon_order, point_cut_calc);
+    pole[1].idx = 0;
   }
   else if (!is_even(opts.ncon_order) || opts.add_poles) {
     if (opts.add_poles)
-      pole[0]->idx = 0;
+      pole[0].idx = 0;
     if (!half_model(lons) || opts.add_poles)
-      pole[1]->idx = 0;
+      pole[1].idx = 0;
   }
 
-  if (pole[0]->idx > -1)
-    pole[0]->lat = 0;
+  if (pole[0].idx > -1)
+    pole[0].lat = 0;
 
   if (opts.add_poles) {
     if (!strchr(opts.hide_elems.c_str(), 't') &&
@@ -2428,7 +2523,7 @@ void add_caps(Geometry &geom, vector<coordList *> &coordinates,
       v[1] = verts.back()[1];
       v[2] = 0;
       add_coord(geom, coordinates, v);
-      pole[0]->idx = verts.size() - 1;
+      pole[0].idx = verts.size() - 1;
 
       if (!strchr(opts.hide_elems.c_str(), 'b') &&
           ((is_even(opts.ncon_order) && !point_cut_calc))) {
@@ -2437,7 +2532,7 @@ void add_caps(Geometry &geom, vector<coordList *> &coordinates,
         v[1] = verts.front()[1];
         v[2] = 0;
         add_coord(geom, coordinates, v);
-        pole[1]->idx = verts.size() - 1;
+        pole[1].idx = verts.size() - 1;
       }
     }
   }
@@ -2457,7 +2552,7 @@ void add_caps(Geometry &geom, vector<coordList *> &coordinates,
           face.push_back(faces[i].back());
         if (opts.split && !split_done && opts.add_poles &&
             (lons.back() > lons.front() / 2))
-          face.push_back(pole[0]->idx);
+          face.push_back(pole[0].idx);
         else if (!opts.split || (opts.split && split_done) ||
                  half_model(lons) ||
                  (!half_model(lons) && (lons.back() != (lons.front() / 2) + 1)))
@@ -2481,12 +2576,12 @@ void add_caps(Geometry &geom, vector<coordList *> &coordinates,
       face.push_back((faces.back()).front());
 
     if (opts.add_poles)
-      face.push_back(pole[0]->idx);
+      face.push_back(pole[0].idx);
 
     add_face(geom, face_list, face, 0, lon_front);
     caps.push_back((int)face_list.size() - 1);
     if (!opts.hybrid)
-      face_list.back()->rotate = true;
+      face_list.back().rotate = true;
   }
 
   // Bottom
@@ -2503,7 +2598,7 @@ void add_caps(Geometry &geom, vector<coordList *> &coordinates,
           face.push_back(faces[i][2]);
         if (opts.split && !split_done && opts.add_poles &&
             (lons.back() > lons.front() / 2))
-          face.push_back(pole[1]->idx);
+          face.push_back(pole[1].idx);
         else if (!opts.split || (opts.split && split_done) ||
                  half_model(lons) ||
                  (!half_model(lons) && (lons.back() != (lons.front() / 2) + 1)))
@@ -2528,18 +2623,18 @@ void add_caps(Geometry &geom, vector<coordList *> &coordinates,
       face.push_back((faces.back()).front());
 
     if (opts.add_poles)
-      face.push_back(pole[1]->idx);
+      face.push_back(pole[1].idx);
 
     add_face(geom, face_list, face, lats - 1, lon_front);
     caps.push_back((int)face_list.size() - 1);
     if (!opts.hybrid)
-      face_list.back()->rotate = true;
+      face_list.back().rotate = true;
   }
 }
 
 // for method 1 covering
-void close_latitudinal(Geometry &geom, vector<faceList *> &face_list,
-                       const vector<poleList *> &pole, const ncon_opts &opts)
+void close_latitudinal(Geometry &geom, vector<faceList> &face_list,
+                       const vector<poleList> &pole, const ncon_opts &opts)
 {
   bool point_cut_calc = opts.point_cut;
   if (opts.build_method == 2 && opts.d > 1)
@@ -2549,7 +2644,7 @@ void close_latitudinal(Geometry &geom, vector<faceList *> &face_list,
 
   // Cover one side
   if (opts.add_poles && (is_even(opts.ncon_order) && !point_cut_calc))
-    face[0].push_back(pole[1]->idx);
+    face[0].push_back(pole[1].idx);
 
   int j = 0;
   for (int i = 1; i <= longitudinal_faces(opts.ncon_order, point_cut_calc) + 1;
@@ -2564,11 +2659,11 @@ void close_latitudinal(Geometry &geom, vector<faceList *> &face_list,
   else {
     if (opts.add_poles && ((is_even(opts.ncon_order) && !point_cut_calc) ||
                            !is_even(opts.ncon_order)))
-      face[0].push_back(pole[0]->idx);
+      face[0].push_back(pole[0].idx);
 
     if (strchr(opts.closure.c_str(), 'v') && (face[0].size() > 2)) {
       add_face(geom, face_list, face[0], -2, -2);
-      face_list.back()->rotate = true;
+      face_list.back().rotate = true;
     }
   }
 
@@ -2585,7 +2680,7 @@ void close_latitudinal(Geometry &geom, vector<faceList *> &face_list,
   int k = longitudinal_faces(opts.ncon_order, point_cut_calc) + 1;
   if (opts.add_poles || (is_even(opts.ncon_order) && point_cut_calc)) {
     if (!half_model(opts.longitudes))
-      face[1].push_back(pole[0]->idx);
+      face[1].push_back(pole[0].idx);
     if (is_even(opts.ncon_order) && point_cut_calc)
       k--;
   }
@@ -2599,11 +2694,11 @@ void close_latitudinal(Geometry &geom, vector<faceList *> &face_list,
   if (opts.add_poles || (((is_even(opts.ncon_order) && point_cut_calc) ||
                           !is_even(opts.ncon_order)) &&
                          !half_model(opts.longitudes)))
-    face[1].push_back(pole[1]->idx);
+    face[1].push_back(pole[1].idx);
 
   if (strchr(opts.closure.c_str(), 'v') && (face[1].size() > 2)) {
     add_face(geom, face_list, face[1], -2, -2);
-    face_list.back()->rotate = true;
+    face_list.back().rotate = true;
   }
 
   // In cases of odd opts.longitudes sides or even opts.longitudes side cuts
@@ -2617,7 +2712,7 @@ void close_latitudinal(Geometry &geom, vector<faceList *> &face_list,
     face[2].push_back(face[1].front());
     face[2].push_back(face[0].back());
     add_face(geom, face_list, face[2], -2, -2);
-    face_list.back()->rotate = true;
+    face_list.back().rotate = true;
   }
 }
 
@@ -2646,16 +2741,16 @@ public:
 };
 
 // untangle polar orbit
-void sort_polar_orbit(Geometry &geom, vector<polarOrb *> &polar_orbit,
+void sort_polar_orbit(Geometry &geom, vector<polarOrb> &polar_orbit,
                       const double eps)
 {
   const vector<Vec3d> &verts = geom.verts();
 
-  Vec3d v0 = verts[polar_orbit[0]->coord_no];
+  Vec3d v0 = verts[polar_orbit[0].coord_no];
   int sz = polar_orbit.size();
   vector<pair<pair<double, double>, int>> angles(sz);
   for (int i = 0; i < sz; i++) {
-    int j = polar_orbit[i]->coord_no;
+    int j = polar_orbit[i].coord_no;
     angles[i].second = j;
     pair<double, double> angle_and_radius;
     angle_and_radius.first = angle_in_range(
@@ -2668,17 +2763,17 @@ void sort_polar_orbit(Geometry &geom, vector<polarOrb *> &polar_orbit,
   sort(angles.begin(), angles.end(), angle_cmp(eps));
 
   for (int i = 0; i < sz; i++)
-    polar_orbit[i]->coord_no = angles[i].second;
+    polar_orbit[i].coord_no = angles[i].second;
 }
 
-void find_polar_orbit(Geometry &geom, vector<polarOrb *> &polar_orbit,
+void find_polar_orbit(Geometry &geom, vector<polarOrb> &polar_orbit,
                       const int build_method, const double eps)
 {
   vector<Vec3d> &verts = geom.raw_verts();
   int sz = verts.size();
   for (int i = 0; i < sz; i++) {
     if (double_eq(verts[i][2], 0.0, eps)) {
-      polar_orbit.push_back(new polarOrb(i));
+      polar_orbit.push_back(polarOrb(i));
     }
     else
         // in case of build method 3, some points were set aside so not to get
@@ -2692,10 +2787,10 @@ void find_polar_orbit(Geometry &geom, vector<polarOrb *> &polar_orbit,
   sort_polar_orbit(geom, polar_orbit, eps);
 }
 
-void ncon_twist(Geometry &geom, const vector<polarOrb *> &polar_orbit,
-                const vector<coordList *> &coordinates,
-                const vector<faceList *> &face_list,
-                const vector<edgeList *> &edge_list, const int ncon_order,
+void ncon_twist(Geometry &geom, vector<polarOrb> &polar_orbit,
+                vector<coordList> &coordinates,
+                const vector<faceList> &face_list,
+                const vector<edgeList> &edge_list, const int ncon_order,
                 const int twist, const vector<int> &longitudes)
 {
   // this function wasn't designed for twist 0
@@ -2710,11 +2805,11 @@ void ncon_twist(Geometry &geom, const vector<polarOrb *> &polar_orbit,
   Trans3d rot = Trans3d::rotate(0, 0, deg2rad(-arc));
 
   for (unsigned int i = 0; i < face_list.size(); i++) {
-    if (face_list[i]->rotate) {
+    if (face_list[i].rotate) {
       for (int coord_no : faces[i]) {
-        if (!coordinates[coord_no]->rotated) {
+        if (!coordinates[coord_no].rotated) {
           verts[coord_no] = rot * verts[coord_no];
-          coordinates[coord_no]->rotated = true;
+          coordinates[coord_no].rotated = true;
         }
       }
     }
@@ -2723,45 +2818,45 @@ void ncon_twist(Geometry &geom, const vector<polarOrb *> &polar_orbit,
   // Patch - If an open model, some of the polar circle coordinates are not yet
   // rotated
   if (!full_model(longitudes))
-    for (auto i : polar_orbit) {
-      int j = i->coord_no;
-      if (!coordinates[j]->rotated) {
+    for (auto &i : polar_orbit) {
+      int j = i.coord_no;
+      if (!coordinates[j].rotated) {
         verts[j] = rot * verts[j];
-        coordinates[j]->rotated = true;
+        coordinates[j].rotated = true;
       }
     }
 
   // Create Doubly Circularly Linked List
   for (int i = 0; i < (int)polar_orbit.size(); i++)
-    polar_orbit[i]->forward = i + 1;
-  polar_orbit.back()->forward = 0;
+    polar_orbit[i].forward = i + 1;
+  polar_orbit.back().forward = 0;
   for (int i = (int)polar_orbit.size() - 1; i > 0; i--)
-    polar_orbit[i]->backward = i - 1;
-  polar_orbit.front()->backward = polar_orbit.size() - 1;
+    polar_orbit[i].backward = i - 1;
+  polar_orbit.front().backward = polar_orbit.size() - 1;
 
   for (int k = 0; k < (int)polar_orbit.size(); k++) {
     int p, q;
-    p = polar_orbit[k]->coord_no;
+    p = polar_orbit[k].coord_no;
     if (twist > 0)
-      q = polar_orbit[k]->forward;
+      q = polar_orbit[k].forward;
     else
-      q = polar_orbit[k]->backward;
+      q = polar_orbit[k].backward;
     for (int n = 1; n < abs(twist); n++) {
       if (twist > 0)
-        q = polar_orbit[q]->forward;
+        q = polar_orbit[q].forward;
       else
-        q = polar_orbit[q]->backward;
+        q = polar_orbit[q].backward;
     }
-    q = polar_orbit[q]->coord_no;
+    q = polar_orbit[q].coord_no;
 
     for (unsigned int i = 0; i < faces.size(); i++)
-      if (!face_list[i]->rotate)
+      if (!face_list[i].rotate)
         for (int &j : faces[i])
           if (j == p)
             j = q * (-1);
 
     for (unsigned int i = 0; i < edges.size(); i++)
-      if (!edge_list[i]->rotate)
+      if (!edge_list[i].rotate)
         for (int &j : edges[i])
           if (j == p)
             j = q * (-1);
@@ -2784,67 +2879,42 @@ void ncon_twist(Geometry &geom, const vector<polarOrb *> &polar_orbit,
 }
 
 // surfaces, case2, case1_twist are changed
-void find_surface_count(const vector<surfaceTable *> &surface_table,
-                        const int twist, int &surfaces, bool &case2,
-                        int &case1_twist)
+void find_surface_count(const surfaceCounts &counts, const int twist,
+                        int &surfaces, bool &case2, int &case1_twist)
 {
+  // coding idea furnished by Adrian Rossiter
   surfaces = 0;
   case2 = false;
   case1_twist = 0;
-  for (auto i : surface_table) {
-    if (twist == i->twist) {
-      surfaces = i->surfaces;
-      case2 = i->case2;
-      case1_twist = i->case1_twist;
-      break;
-    }
-  }
-}
+  if (twist < 2)
+    return;
 
-// ncon_order, point_cut, hybrid are not from opts
-void build_surface_table(vector<surfaceTable *> &surface_table,
-                         const int max_twist, const int ncon_order,
-                         const bool point_cut, const bool hybrid)
-{
-  // coding idea furnished by Adrian Rossiter
-  int axis_edges = 0;
-  int n = ncon_order;
-  int t_mod = 0;
+  int total_surfaces =
+      (int)((gcd(counts.n, 2 * twist - counts.t_mod) + counts.axis_edges) / 2);
 
-  if (!is_even(ncon_order) || hybrid) {
-    axis_edges = 1;
-    if (hybrid) {
-      n *= 2;
-      t_mod = 1;
-    }
-  }
-  else if (is_even(ncon_order) && !point_cut)
-    axis_edges = 2;
+  // subtract out discontinuous surfaces
+  int continuous_surfaces = total_surfaces - counts.axis_edges;
 
-  for (int twist = 2; twist <= max_twist; twist++) {
-    int total_surfaces = (int)((gcd(n, 2 * twist - t_mod) + axis_edges) / 2);
-    // fprintf(stderr,"twist = %d surfaces = %d\n",twist,total_surfaces);
+  // only report those with more than minimum surface counts
+  if (!((continuous_surfaces > 1) ||
+        (continuous_surfaces > 0 && !counts.min_count_point_cut)))
+    return;
 
-    // subtract out discontinuous surfaces for table
-    int continuous_surfaces = total_surfaces - axis_edges;
-    bool factor = false;
-    if (hybrid)
-      factor = (n % (2 * twist - 1) == 0) ? true : false;
-    else
-      factor = (n % twist == 0) ? true : false;
-    int case1_twist = total_surfaces;
-    if (is_even(ncon_order) && !point_cut)
+  bool factor = false;
+  if (counts.hybrid)
+    factor = (counts.n % (2 * twist - 1) == 0) ? true : false;
+  else
+    factor = (counts.n % twist == 0) ? true : false;
+  if (!factor) {
+    case1_twist = total_surfaces;
+    if (counts.side_cut_even)
       case1_twist--;
-
-    // only store those with more than minimum surface counts
-    if ((continuous_surfaces > 1) ||
-        (continuous_surfaces > 0 &&
-         (!(is_even(ncon_order) && point_cut) || hybrid))) {
-      surface_table.push_back(new surfaceTable(twist, continuous_surfaces,
-                                               (factor ? twist : case1_twist),
-                                               (factor ? false : true)));
-    }
   }
+  else
+    case1_twist = twist;
+
+  surfaces = continuous_surfaces;
+  case2 = !factor;
 }
 
 void model_info(const Geometry &geom, const ncon_opts &opts)
@@ -2894,11 +2964,12 @@ void model_info(const Geometry &geom, const ncon_opts &opts)
   fprintf(stderr, "========================================\n");
 }
 
-// surface_table, sd will be changed
+// sd will be changed
 // ncon_order, point_cut, twist, hybrid, info are not from opts
+// counts must be for the same ncon_order, point_cut and hybrid
 void ncon_info(const int ncon_order, const bool point_cut, const int twist,
                const bool hybrid, const bool info,
-               vector<surfaceTable *> &surface_table, surfaceData &sd)
+               const surfaceCounts &counts, surfaceData &sd)
 {
   int first, last, forms, chiral, nonchiral, unique;
 
@@ -3139,11 +3210,6 @@ void ncon_info(const int ncon_order, const bool point_cut, const int twist,
     }
   }
 
-  // if ncon_info() is called multiple times, this keeps surface table from
-  // being called only once
-  if (!surface_table.size())
-    build_surface_table(surface_table, last, ncon_order, point_cut, hybrid);
-
   sd.c_surfaces = 0;
   sd.c_edges = 0;
   sd.d_surfaces = 0;
@@ -3171,14 +3237,14 @@ void ncon_info(const int ncon_order, const bool point_cut, const int twist,
     sd.d_edges = 0;
   }
   else if (hybrid) {
-    find_surface_count(surface_table, posi_twist, sd.c_surfaces, sd.ncon_case2,
+    find_surface_count(counts, posi_twist, sd.c_surfaces, sd.ncon_case2,
                        case1_twist);
     sd.d_surfaces = 1;
     sd.c_edges = sd.c_surfaces + sd.d_surfaces - 1;
     sd.d_edges = 1;
   }
   else if (is_even(ncon_order) && point_cut) {
-    find_surface_count(surface_table, posi_twist, sd.c_surfaces, sd.ncon_case2,
+    find_surface_count(counts, posi_twist, sd.c_surfaces, sd.ncon_case2,
                        case1_twist);
     if (sd.c_surfaces == 0)
       sd.c_surfaces = 1;
@@ -3187,14 +3253,14 @@ void ncon_info(const int ncon_order, const bool point_cut, const int twist,
     sd.d_edges = 2;
   }
   else if (is_even(ncon_order) && !point_cut) {
-    find_surface_count(surface_table, posi_twist, sd.c_surfaces, sd.ncon_case2,
+    find_surface_count(counts, posi_twist, sd.c_surfaces, sd.ncon_case2,
                        case1_twist);
     sd.d_surfaces = 2;
     sd.c_edges = sd.c_surfaces + sd.d_surfaces - 1;
     sd.d_edges = 0;
   }
   else if (!is_even(ncon_order)) {
-    find_surface_count(surface_table, posi_twist, sd.c_surfaces, sd.ncon_case2,
+    find_surface_count(counts, posi_twist, sd.c_surfaces, sd.ncon_case2,
                        case1_twist);
     sd.c_edges = sd.c_surfaces;
     sd.d_surfaces = 1;
@@ -3386,8 +3452,8 @@ void set_edge_color(Geometry &geom, const int i, Color c,
 }
 
 // point cut is not from opts
-void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
-                        const vector<poleList *> &pole,
+void ncon_edge_coloring(Geometry &geom, const vector<edgeList> &edge_list,
+                        const vector<poleList> &pole,
                         map<int, pair<int, int>> &edge_color_table,
                         const bool point_cut_calc, const ncon_opts &opts)
 {
@@ -3408,16 +3474,16 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
   if (opts.edge_coloring_method == 's') {
     int circuit_count = 0;
 
-    for (auto i : edge_list) {
-      int j = i->edge_no;
-      int lat = i->lat;
+    for (auto &i : edge_list) {
+      int j = i.edge_no;
+      int lat = i.lat;
 
-      if (i->lat < 0) {
+      if (i.lat < 0) {
         set_edge_color(geom, j, Color(), opts.edge_opacity);
       }
       else {
         int col_idx = 0;
-        if (i->rotate || (opts.hybrid && pc)) // front side
+        if (i.rotate || (opts.hybrid && pc)) // front side
           col_idx = edge_color_table[lat].second;
         else
           col_idx = edge_color_table[lat].first;
@@ -3433,15 +3499,15 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
     }
 
     for (unsigned int i = 0; i < 2; i++) {
-      if (pole[i]->idx > -1) {
-        int lat = pole[i]->lat;
+      if (pole[i].idx > -1) {
+        int lat = pole[i].lat;
         if (lat < 0)
           continue;
         int col_idx = edge_color_table[lat].second;
         opq = opts.edge_pattern[col_idx % opts.edge_pattern.size()] == '1'
                   ? opts.edge_opacity
                   : 255;
-        set_vert_color(geom, pole[i]->idx, opts.edge_map.get_col(col_idx), opq);
+        set_vert_color(geom, pole[i].idx, opts.edge_map.get_col(col_idx), opq);
       }
     }
 
@@ -3450,13 +3516,13 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
               (circuit_count > 1 ? "s were" : " was"));
   }
   else if (opts.edge_coloring_method == 'l') {
-    for (auto i : edge_list) {
-      int j = i->edge_no;
-      if (i->lat < 0) {
+    for (auto &i : edge_list) {
+      int j = i.edge_no;
+      if (i.lat < 0) {
         set_edge_color(geom, j, Color(), opts.edge_opacity);
       }
       else {
-        int lat = i->lat;
+        int lat = i.lat;
         opq = opts.edge_pattern[lat % opts.edge_pattern.size()] == '1'
                   ? opts.edge_opacity
                   : 255;
@@ -3465,23 +3531,23 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
     }
 
     for (unsigned int i = 0; i < 2; i++) {
-      if (pole[i]->idx > -1) {
-        int lat = pole[i]->lat;
+      if (pole[i].idx > -1) {
+        int lat = pole[i].lat;
         opq = opts.edge_pattern[lat % opts.edge_pattern.size()] == '1'
                   ? opts.edge_opacity
                   : 255;
-        set_vert_color(geom, pole[i]->idx, opts.edge_map.get_col(lat), opq);
+        set_vert_color(geom, pole[i].idx, opts.edge_map.get_col(lat), opq);
       }
     }
   }
   else if (opts.edge_coloring_method == 'm') {
-    for (auto i : edge_list) {
-      int j = i->edge_no;
-      if (i->lon < 0) {
+    for (auto &i : edge_list) {
+      int j = i.edge_no;
+      if (i.lon < 0) {
         set_edge_color(geom, j, Color(), opts.edge_opacity);
       }
       else {
-        int lon = i->lon;
+        int lon = i.lon;
         opq = opts.edge_pattern[lon % opts.edge_pattern.size()] == '1'
                   ? opts.edge_opacity
                   : 255;
@@ -3491,21 +3557,21 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
 
     // poles don't have any longitude
     for (unsigned int i = 0; i < 2; i++) {
-      if (pole[i]->idx > -1) {
-        set_vert_color(geom, pole[i]->idx, opts.edge_default_color,
+      if (pole[i].idx > -1) {
+        set_vert_color(geom, pole[i].idx, opts.edge_default_color,
                        opts.edge_opacity);
       }
     }
   }
   else if (opts.edge_coloring_method == 'b') {
-    for (auto i : edge_list) {
-      int j = i->edge_no;
-      if (i->lat < 0)
+    for (auto &i : edge_list) {
+      int j = i.edge_no;
+      if (i.lat < 0)
         set_edge_color(geom, j, Color(), opts.edge_opacity);
       else {
         int n = -1;
-        if ((is_even(i->lat) && is_even(i->lon)) ||
-            (!is_even(i->lat) && !is_even(i->lon)))
+        if ((is_even(i.lat) && is_even(i.lon)) ||
+            (!is_even(i.lat) && !is_even(i.lon)))
           n = 0;
         else
           n = 1;
@@ -3519,11 +3585,11 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
 
     // poles will be colored based North/South
     for (unsigned int i = 0; i < 2; i++) {
-      if (pole[i]->idx > -1) {
+      if (pole[i].idx > -1) {
         opq = opts.edge_pattern[i % opts.edge_pattern.size()] == '1'
                   ? opts.edge_opacity
                   : 255;
-        set_vert_color(geom, pole[i]->idx, opts.edge_map.get_col(i), opq);
+        set_vert_color(geom, pole[i].idx, opts.edge_map.get_col(i), opq);
       }
     }
   }
@@ -3531,7 +3597,7 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
     // keep track of index beyond loop
     unsigned int k = 0;
     for (unsigned int i = 0; i < edge_list.size(); i++) {
-      int j = edge_list[i]->edge_no;
+      int j = edge_list[i].edge_no;
       opq = opts.edge_pattern[i % opts.edge_pattern.size()] == '1'
                 ? opts.edge_opacity
                 : 255;
@@ -3541,18 +3607,18 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
 
     for (unsigned int i = 0; i < 2; i++) {
       int col_idx = k;
-      if (pole[i]->idx > -1) {
+      if (pole[i].idx > -1) {
         opq = opts.edge_pattern[k % opts.edge_pattern.size()] == '1'
                   ? opts.edge_opacity
                   : 255;
-        set_vert_color(geom, pole[i]->idx, opts.edge_map.get_col(col_idx), opq);
+        set_vert_color(geom, pole[i].idx, opts.edge_map.get_col(col_idx), opq);
       }
       k++;
     }
   }
   else if (strchr("xyz", opts.edge_coloring_method)) {
-    for (auto i : edge_list) {
-      int j = i->edge_no;
+    for (auto &i : edge_list) {
+      int j = i.edge_no;
       double d = 0.0;
       for (int k : edges[j]) {
         if (opts.edge_coloring_method == 'x')
@@ -3590,15 +3656,15 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
 
     // poles are on the axis
     for (unsigned int i = 0; i < 2; i++) {
-      if (pole[i]->idx > -1) {
-        set_vert_color(geom, pole[i]->idx, opts.edge_default_color,
+      if (pole[i].idx > -1) {
+        set_vert_color(geom, pole[i].idx, opts.edge_default_color,
                        opts.edge_opacity);
       }
     }
   }
   else if (opts.edge_coloring_method == 'o') {
-    for (auto i : edge_list) {
-      int j = i->edge_no;
+    for (auto &i : edge_list) {
+      int j = i.edge_no;
       double dx = 0.0;
       double dy = 0.0;
       double dz = 0.0;
@@ -3648,15 +3714,15 @@ void ncon_edge_coloring(Geometry &geom, const vector<edgeList *> &edge_list,
 
     // poles are on the axis
     for (unsigned int i = 0; i < 2; i++) {
-      if (pole[i]->idx > -1) {
-        set_vert_color(geom, pole[i]->idx, opts.edge_default_color,
+      if (pole[i].idx > -1) {
+        set_vert_color(geom, pole[i].idx, opts.edge_default_color,
                        opts.edge_opacity);
       }
     }
   }
 }
 
-void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
+void ncon_face_coloring(Geometry &geom, const vector<faceList> &face_list,
                         map<int, pair<int, int>> &face_color_table,
                         const bool point_cut_calc, const ncon_opts &opts)
 {
@@ -3677,16 +3743,16 @@ void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
   if (opts.face_coloring_method == 's') {
     int circuit_count = 0;
 
-    for (auto i : face_list) {
-      int j = i->face_no;
-      int lat = i->lat;
+    for (auto &i : face_list) {
+      int j = i.face_no;
+      int lat = i.lat;
 
-      if (i->lat < 0) {
+      if (i.lat < 0) {
         set_face_color(geom, j, Color(), opts.face_opacity);
       }
       else {
         int col_idx = 0;
-        if (i->rotate || (opts.hybrid && pc)) // front side
+        if (i.rotate || (opts.hybrid && pc)) // front side
           col_idx = face_color_table[lat].second;
         else
           col_idx = face_color_table[lat].first;
@@ -3708,13 +3774,13 @@ void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
     }
   }
   else if (opts.face_coloring_method == 'l') {
-    for (auto i : face_list) {
-      int j = i->face_no;
-      if (i->lat < 0) {
+    for (auto &i : face_list) {
+      int j = i.face_no;
+      if (i.lat < 0) {
         set_face_color(geom, j, Color(), opts.face_opacity);
       }
       else {
-        int lat = i->lat;
+        int lat = i.lat;
         opq = opts.face_pattern[lat % opts.face_pattern.size()] == '1'
                   ? opts.face_opacity
                   : 255;
@@ -3723,13 +3789,13 @@ void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
     }
   }
   else if (opts.face_coloring_method == 'm') {
-    for (auto i : face_list) {
-      int j = i->face_no;
-      if (i->lon < 0) {
+    for (auto &i : face_list) {
+      int j = i.face_no;
+      if (i.lon < 0) {
         set_face_color(geom, j, Color(), opts.face_opacity);
       }
       else {
-        int lon = i->lon;
+        int lon = i.lon;
         opq = opts.face_pattern[lon % opts.face_pattern.size()] == '1'
                   ? opts.face_opacity
                   : 255;
@@ -3738,14 +3804,14 @@ void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
     }
   }
   else if (opts.face_coloring_method == 'b') {
-    for (auto i : face_list) {
-      int j = i->face_no;
-      if (i->lat < 0)
+    for (auto &i : face_list) {
+      int j = i.face_no;
+      if (i.lat < 0)
         set_face_color(geom, j, Color(), opts.face_opacity);
       else {
         int n = -1;
-        if ((is_even(i->lat) && is_even(i->lon)) ||
-            (!is_even(i->lat) && !is_even(i->lon)))
+        if ((is_even(i.lat) && is_even(i.lon)) ||
+            (!is_even(i.lat) && !is_even(i.lon)))
           n = 0;
         else
           n = 1;
@@ -3759,7 +3825,7 @@ void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
   }
   else if (opts.face_coloring_method == 'n') {
     for (unsigned int i = 0; i < face_list.size(); i++) {
-      int j = face_list[i]->face_no;
+      int j = face_list[i].face_no;
       opq = opts.face_pattern[i % opts.face_pattern.size()] == '1'
                 ? opts.face_opacity
                 : 255;
@@ -3767,8 +3833,8 @@ void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
     }
   }
   else if (strchr("xyz", opts.face_coloring_method)) {
-    for (auto i : face_list) {
-      int j = i->face_no;
+    for (auto &i : face_list) {
+      int j = i.face_no;
       double d = 0.0;
       for (int k : faces[j]) {
         if (opts.face_coloring_method == 'x')
@@ -3805,8 +3871,8 @@ void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
     }
   }
   else if (opts.face_coloring_method == 'o') {
-    for (auto i : face_list) {
-      int j = i->face_no;
+    for (auto &i : face_list) {
+      int j = i.face_no;
       double dx = 0.0;
       double dy = 0.0;
       double dz = 0.0;
@@ -3856,43 +3922,79 @@ void ncon_face_coloring(Geometry &geom, const vector<faceList *> &face_list,
   }
 }
 
-vector<int> find_adjacent_face_idx_in_channel(
-    const Geometry &geom, const int face_idx,
-    const vector<vector<int>> &bare_implicit_edges,
-    map<vector<int>, vector<int>> &faces_by_edge, const bool prime)
+void fill_faces_by_edge(const Geometry &geom,
+                        map<vector<int>, vector<int>> &faces_by_edge)
 {
   const vector<vector<int>> &faces = geom.faces();
 
-  vector<int> face_idx_ret;
-  vector<vector<int>> adjacent_edges;
+  for (int i = 0; i < (int)faces.size(); i++) {
+    int sz = faces[i].size();
+    for (int j = 0; j < sz; j++)
+      faces_by_edge[make_edge(faces[i][j], faces[i][(j + 1) % sz])].push_back(
+          i);
+  }
+}
 
-  vector<int> face = faces[face_idx];
-  int sz = face.size();
-  for (int i = 0; i < sz; i++) {
-    vector<int> edge(2);
-    edge[0] = face[i];
-    edge[1] = face[(i + 1) % sz];
-    if (find_edge_in_edge_list(bare_implicit_edges, edge) > -1) {
-      adjacent_edges.push_back(make_edge(edge[0], edge[1]));
+// the faces adjacent to each face across its bare implicit edges, which are
+// the channels followed by a flood fill. The adjacent faces are found once
+// and held in one array, those of face i are from begin(i) up to end(i)
+class faceChannels {
+private:
+  vector<int> offsets;
+  vector<int> adjacent;
+
+public:
+  faceChannels(const Geometry &geom)
+  {
+    const vector<vector<int>> &faces = geom.faces();
+
+    // bare implicit edges are face edges which are not explicit edges
+    map<vector<int>, int> edge_index;
+    fill_edge_index(geom.edges(), edge_index);
+
+    map<vector<int>, vector<int>> faces_by_edge;
+    fill_faces_by_edge(geom, faces_by_edge);
+
+    offsets.push_back(0);
+    for (int i = 0; i < (int)faces.size(); i++) {
+      int sz = faces[i].size();
+      for (int j = 0; j < sz; j++) {
+        vector<int> edge = make_edge(faces[i][j], faces[i][(j + 1) % sz]);
+        if (edge_index.find(edge) != edge_index.end())
+          continue;
+        for (int k : faces_by_edge[edge])
+          if (k != i)
+            adjacent.push_back(k);
+      }
+      offsets.push_back(adjacent.size());
     }
   }
 
-  vector<int> adjacent_face_idx;
-  for (auto &adjacent_edge : adjacent_edges) {
-    vector<int> face_idx_tmp = faces_by_edge[adjacent_edge];
-    for (int &j : face_idx_tmp) {
-      if (j != face_idx)
-        adjacent_face_idx.push_back(j);
-    }
+  vector<int>::const_iterator begin(const int face_idx) const
+  {
+    return adjacent.begin() + offsets[face_idx];
   }
 
+  vector<int>::const_iterator end(const int face_idx) const
+  {
+    return adjacent.begin() + offsets[face_idx + 1];
+  }
+};
+
+vector<int> find_adjacent_face_idx_in_channel(const Geometry &geom,
+                                              const int face_idx,
+                                              const faceChannels &channels,
+                                              const bool prime)
+{
+  vector<int> face_idx_ret;
+
   // the first time we "prime" so we return faces in both directions. the second
   // face becomes the "stranded" face
   // there may be faces which would get pinched off (stranded), so there may be
   // more than one
-  for (int &i : adjacent_face_idx) {
-    if (prime || !(geom.colors(FACES).get(i)).is_set()) {
-      face_idx_ret.push_back(i);
+  for (auto i = channels.begin(face_idx); i != channels.end(face_idx); ++i) {
+    if (prime || !(geom.colors(FACES).get(*i)).is_set()) {
+      face_idx_ret.push_back(*i);
     }
   }
 
@@ -3900,19 +4002,19 @@ vector<int> find_adjacent_face_idx_in_channel(
 }
 
 // flood_fill_count is changed
-int set_face_colors_by_adjacent_face(
-    Geometry &geom, const int start, const Color &c, const int opq,
-    const int flood_fill_stop, int &flood_fill_count,
-    const vector<vector<int>> &bare_implicit_edges,
-    map<vector<int>, vector<int>> &faces_by_edge)
+int set_face_colors_by_adjacent_face(Geometry &geom, const int start,
+                                     const Color &c, const int opq,
+                                     const int flood_fill_stop,
+                                     int &flood_fill_count,
+                                     const faceChannels &channels)
 {
   if (flood_fill_stop && (flood_fill_count >= flood_fill_stop))
     return 0;
 
   vector<int> stranded_faces;
 
-  vector<int> face_idx = find_adjacent_face_idx_in_channel(
-      geom, start, bare_implicit_edges, faces_by_edge, true);
+  vector<int> face_idx =
+      find_adjacent_face_idx_in_channel(geom, start, channels, true);
   while (face_idx.size()) {
     for (unsigned int i = 0; i < face_idx.size(); i++) {
       if (flood_fill_stop && (flood_fill_count >= flood_fill_stop))
@@ -3922,14 +4024,14 @@ int set_face_colors_by_adjacent_face(
       if (i > 0)
         stranded_faces.push_back(face_idx[i]);
     }
-    face_idx = find_adjacent_face_idx_in_channel(
-        geom, face_idx[0], bare_implicit_edges, faces_by_edge, false);
+    face_idx =
+        find_adjacent_face_idx_in_channel(geom, face_idx[0], channels, false);
   }
 
   // check if stranded faces
   for (unsigned int i = 0; i < stranded_faces.size(); i++) {
-    face_idx = find_adjacent_face_idx_in_channel(
-        geom, stranded_faces[i], bare_implicit_edges, faces_by_edge, false);
+    face_idx = find_adjacent_face_idx_in_channel(geom, stranded_faces[i],
+                                                 channels, false);
     while (face_idx.size()) {
       for (unsigned int i = 0; i < face_idx.size(); i++) {
         if (flood_fill_stop && (flood_fill_count >= flood_fill_stop))
@@ -3939,42 +4041,16 @@ int set_face_colors_by_adjacent_face(
         if (i > 0)
           stranded_faces.push_back(face_idx[i]);
       }
-      face_idx = find_adjacent_face_idx_in_channel(
-          geom, face_idx[0], bare_implicit_edges, faces_by_edge, false);
+      face_idx = find_adjacent_face_idx_in_channel(geom, face_idx[0],
+                                                   channels, false);
     }
   }
 
   return (flood_fill_stop ? 1 : 0);
 }
 
-void fill_bare_implicit_edges(const Geometry &geom,
-                              vector<vector<int>> &bare_implicit_edges)
-{
-  const vector<vector<int>> &edges = geom.edges();
-  vector<vector<int>> implicit_edges;
-  geom.get_impl_edges(implicit_edges);
-
-  for (auto &implicit_edge : implicit_edges) {
-    if (find_edge_in_edge_list(edges, implicit_edge) < 0)
-      bare_implicit_edges.push_back(implicit_edge);
-  }
-}
-
-void fill_faces_by_edge(const Geometry &geom,
-                        map<vector<int>, vector<int>> &faces_by_edge)
-{
-  const vector<vector<int>> &faces = geom.faces();
-
-  for (int i = 0; i < (int)faces.size(); i++) {
-    int sz = faces[i].size();
-    for (int j = 0; j < sz; j++)
-      faces_by_edge[make_edge(faces[i][j], faces[i][(j + 1) % sz])].push_back(
-          i);
-  }
-}
-
 int ncon_face_coloring_by_adjacent_face(Geometry &geom,
-                                        const vector<faceList *> &face_list,
+                                        const vector<faceList> &face_list,
                                         const ncon_opts &opts)
 {
   bool debug = false;
@@ -3986,11 +4062,9 @@ int ncon_face_coloring_by_adjacent_face(Geometry &geom,
   Coloring clrng(&geom);
   clrng.f_one_col(Color());
 
-  vector<vector<int>> bare_implicit_edges;
-  fill_bare_implicit_edges(geom, bare_implicit_edges);
+  faceChannels channels(geom);
 
-  map<vector<int>, vector<int>> faces_by_edge;
-  fill_faces_by_edge(geom, faces_by_edge);
+  latLonIndex face_lat_lon(face_list);
 
   int map_count = 0;
   int sz = 0;
@@ -3998,13 +4072,13 @@ int ncon_face_coloring_by_adjacent_face(Geometry &geom,
   int lon = opts.longitudes.front() / 2 - 1;
   do {
     bool painted = false;
-    vector<int> idx = find_face_by_lat_lon(face_list, lat, lon);
+    vector<int> idx = face_lat_lon.find(lat, lon);
     sz = (int)idx.size();
 
     Color c = map_count;
 
     for (int j : idx) {
-      int f_idx = face_list[j]->face_no;
+      int f_idx = face_list[j].face_no;
       if ((geom.colors(FACES).get(f_idx)).is_set())
         continue;
       if (opts.flood_fill_stop && (flood_fill_count >= opts.flood_fill_stop))
@@ -4012,9 +4086,9 @@ int ncon_face_coloring_by_adjacent_face(Geometry &geom,
 
       set_face_color(geom, f_idx, c, 255);
       flood_fill_count++;
-      ret = set_face_colors_by_adjacent_face(
-          geom, f_idx, c, 255, opts.flood_fill_stop, flood_fill_count,
-          bare_implicit_edges, faces_by_edge);
+      ret = set_face_colors_by_adjacent_face(geom, f_idx, c, 255,
+                                             opts.flood_fill_stop,
+                                             flood_fill_count, channels);
 
       painted = true;
     }
@@ -4034,10 +4108,10 @@ int ncon_face_coloring_by_adjacent_face(Geometry &geom,
       lat = 0;
       lon -= l;
       do {
-        vector<int> idx = find_face_by_lat_lon(face_list, lat, lon);
+        vector<int> idx = face_lat_lon.find(lat, lon);
         sz = idx.size();
         if (sz) {
-          int f_idx = face_list[idx[0]]->face_no;
+          int f_idx = face_list[idx[0]].face_no;
           int k = geom.colors(FACES).get(f_idx).get_index();
           fprintf(stderr, "%d ", k);
         }
@@ -4053,28 +4127,28 @@ int ncon_face_coloring_by_adjacent_face(Geometry &geom,
        lat = 0;
        //lon -= l;
        do {
-          vector<int> idx = find_face_by_lat_lon(face_list,lat,lon);
+          vector<int> idx = face_lat_lon.find(lat,lon);
           sz = idx.size();
           if (sz) {
              vector<int> face_idx;
              int lat2 = -1;
              if (l==1) {
                 face_idx = find_adjacent_face_idx_in_channel(geom, idx[0],
-    bare_implicit_edges, faces_by_edge, true);
+    channels, true);
                 sz = face_idx.size();
                 //fprintf(stderr,"face idx0 = %d, face idx1 =
     %d\n",face_idx[0],face_idx[1]);
                 //fprintf(stderr,"sz = %d lat0 = %d lat1 =
-    %d\n",sz,face_list[face_idx[0]]->lat,face_list[face_idx[1]]->lat);
+    %d\n",sz,face_list[face_idx[0]].lat,face_list[face_idx[1]].lat);
                 if (sz) {
                    if (face_idx[1] > (int)face_list.size())
                       face_idx = find_adjacent_face_idx_in_channel(geom,
-    face_idx[1], bare_implicit_edges, faces_by_edge, true);
-                   lat2 = face_list[face_idx[1]]->lat;
+    face_idx[1], channels, true);
+                   lat2 = face_list[face_idx[1]].lat;
                 }
              }
              else
-                lat2 = face_list[idx[0]]->lat;
+                lat2 = face_list[idx[0]].lat;
              fprintf(stderr,"%d ",lat2);
           }
           lat++;
@@ -4134,8 +4208,8 @@ int ncon_face_coloring_by_adjacent_face(Geometry &geom,
 }
 
 void ncon_edge_coloring_by_adjacent_edge(Geometry &geom,
-                                         const vector<edgeList *> &edge_list,
-                                         const vector<poleList *> &pole,
+                                         const vector<edgeList> &edge_list,
+                                         const vector<poleList> &pole,
                                          const ncon_opts &opts)
 {
   bool debug = false;
@@ -4147,9 +4221,9 @@ void ncon_edge_coloring_by_adjacent_edge(Geometry &geom,
   vector<vector<int>> edges;
   vector<int> edge_no;
   if (!opts.hybrid) {
-    for (auto i : edge_list) {
-      edges.push_back(geom.edges(i->edge_no));
-      edge_no.push_back(i->edge_no);
+    for (auto &i : edge_list) {
+      edges.push_back(geom.edges(i.edge_no));
+      edge_no.push_back(i.edge_no);
     }
   }
   else {
@@ -4178,31 +4252,39 @@ void ncon_edge_coloring_by_adjacent_edge(Geometry &geom,
   // not a circuit, so don't increment circuit count
   // if (is_even(opts.ncon_order) && pc && opts.mod_twist == 0 &&
   // !opts.double_sweep)
-  if (pole[0]->idx != -1 && !opts.double_sweep && !opts.hybrid)
+  if (pole[0].idx != -1 && !opts.double_sweep && !opts.hybrid)
     map_count++;
 
+  latLonIndex edge_lat_lon(edge_list);
+  vertexElems vert_edges(edges, geom.verts().size());
+
+  // keep only the edges not yet colored, in the same order
+  auto remove_set = [&](vector<int> &es) {
+    es.erase(remove_if(es.begin(), es.end(),
+                       [&](int e) {
+                         return geom.colors(EDGES).get(edge_no[e]).is_set();
+                       }),
+             es.end());
+  };
+
   // edge lats start at 1
   int sz = 0;
   int lat = 1;
   int lon = opts.longitudes.front() / 2 - 1;
   do {
     bool painted = false;
-    vector<int> idx = find_edge_by_lat_lon(edge_list, lat, lon);
+    vector<int> idx = edge_lat_lon.find(lat, lon);
     sz = (int)idx.size();
 
     Color c = map_count;
 
     for (int j = 0; j < sz; j++) {
-      int e_idx = edge_list[idx[j]]->edge_no;
+      int e_idx = edge_list[idx[j]].edge_no;
       vector<int> edge = edges[e_idx];
-      vector<int> es = find_edges_with_vertex(edges, edge[0]);
-      vector<int> es_tmp = find_edges_with_vertex(edges, edge[1]);
+      vector<int> es = vert_edges.find(edge[0]);
+      vector<int> es_tmp = vert_edges.find(edge[1]);
       es.insert(es.end(), es_tmp.begin(), es_tmp.end());
-
-      for (int k = (int)es.size() - 1; k >= 0; k--) {
-        if ((geom.colors(EDGES).get(edge_no[es[k]])).is_set())
-          es.erase(es.begin() + k);
-      }
+      remove_set(es);
 
       while (es.size()) {
         // continue to color in one direction, then the other
@@ -4214,22 +4296,14 @@ void ncon_edge_coloring_by_adjacent_edge(Geometry &geom,
         vector<int> es_next;
         for (int e : es) {
           edge = edges[e];
-          if (!es_next.size())
-            es_next = find_edges_with_vertex(edges, edge[0]);
-          else {
-            es_tmp = find_edges_with_vertex(edges, edge[0]);
+          for (int v_idx : edge) {
+            es_tmp = vert_edges.find(v_idx);
             es_next.insert(es_next.end(), es_tmp.begin(), es_tmp.end());
           }
-
-          es_tmp = find_edges_with_vertex(edges, edge[1]);
-          es_next.insert(es_next.end(), es_tmp.begin(), es_tmp.end());
         }
 
         es = es_next;
-        for (int k = (int)es.size() - 1; k >= 0; k--) {
-          if ((geom.colors(EDGES).get(edge_no[es[k]])).is_set())
-            es.erase(es.begin() + k);
-        }
+        remove_set(es);
       }
     }
 
@@ -4245,30 +4319,32 @@ void ncon_edge_coloring_by_adjacent_edge(Geometry &geom,
   // if there is a pole in build_method 3 it is meant to be there
   int n = (opts.build_method == 2 && opts.d != 1) ? opts.ncon_order / 2
                                                   : opts.ncon_order;
-  if ((pole[0]->idx != -1) && ((is_even(n) && pc) || opts.build_method == 3) &&
+  if ((pole[0].idx != -1) && ((is_even(n) && pc) || opts.build_method == 3) &&
       !opts.hybrid) {
     int opq = opts.edge_pattern[0 % opts.edge_pattern.size()] == '1'
                   ? opts.edge_opacity
                   : 255;
     Color c = opts.edge_map.get_col(0);
-    set_vert_color(geom, pole[0]->idx, c, opq);
+    set_vert_color(geom, pole[0].idx, c, opq);
   }
 
   // south pole
-  if ((pole[1]->idx != -1) && (!is_even(n) || (is_even(n) && pc)) &&
+  if ((pole[1].idx != -1) && (!is_even(n) || (is_even(n) && pc)) &&
       !opts.hybrid) {
     int l = (opts.symmetric_coloring && is_even(opts.ncon_order)) ? 0 : lat - 1;
     int opq = opts.edge_pattern[l % opts.edge_pattern.size()] == '1'
                   ? opts.edge_opacity
                   : 255;
     Color c = opts.edge_map.get_col(l);
-    set_vert_color(geom, pole[1]->idx, c, opq);
+    set_vert_color(geom, pole[1].idx, c, opq);
   }
 
   // some models will have a stranded edge
+  map<vector<int>, int> edge_index;
+  fill_edge_index(geom.edges(), edge_index);
   bool painted = false;
   for (auto &edge : edges) {
-    int edge_no = find_edge_in_edge_list(geom.edges(), edge);
+    int edge_no = find_edge_in_edge_index(edge_index, edge);
     if (!(geom.colors(EDGES).get(edge_no)).is_set()) {
       set_edge_color(geom, edge_no, Color(0), 255);
       painted = true;
@@ -4321,10 +4397,10 @@ void ncon_edge_coloring_by_adjacent_edge(Geometry &geom,
       sz = 0;
       lat = 1;
       do {
-        vector<int> idx = find_edge_by_lat_lon(edge_list, lat, lon);
+        vector<int> idx = edge_lat_lon.find(lat, lon);
         int sz = idx.size();
         if (sz) {
-          int e_idx = edge_list[idx[0]]->edge_no;
+          int e_idx = edge_list[idx[0]].edge_no;
           int k = geom.colors(EDGES).get(e_idx).get_index();
           fprintf(stderr, "%d ", k);
         }
@@ -4356,7 +4432,7 @@ void ncon_edge_coloring_by_adjacent_edge(Geometry &geom,
 }
 
 int ncon_face_coloring_by_compound(Geometry &geom,
-                                   const vector<faceList *> &face_list,
+                                   const vector<faceList> &face_list,
                                    const vector<int> &caps,
                                    const ncon_opts &opts)
 {
@@ -4372,8 +4448,8 @@ int ncon_face_coloring_by_compound(Geometry &geom,
   /*
      //test polygon_no
      for (unsigned int i=0;i<face_list.size();i++) {
-        int face_no = face_list[i]->face_no;
-        int polygon_no = face_list[i]->polygon_no;
+        int face_no = face_list[i].face_no;
+        int polygon_no = face_list[i].polygon_no;
         if (opts.face_opacity > -1)
            opq = opts.face_pattern[polygon_no%opts.face_pattern.size()] == '1' ?
      opts.face_opacity : 255;
@@ -4385,16 +4461,18 @@ int ncon_face_coloring_by_compound(Geometry &geom,
 
   vector<pair<int, int>> polygon_table;
 
+  latLonIndex face_lat_lon(face_list);
+
   int sz = 0;
   int lat = 0;
   int lon = opts.longitudes.front() / 2;
   if (!opts.hybrid)
     lon--;
   do {
-    vector<int> idx = find_face_by_lat_lon(face_list, lat, lon);
+    vector<int> idx = face_lat_lon.find(lat, lon);
     sz = idx.size();
     for (int j = 0; j < sz; j++) {
-      int polygon_no = face_list[idx[j]]->polygon_no;
+      int polygon_no = face_list[idx[j]].polygon_no;
       polygon_table.push_back(make_pair(polygon_no, idx[j]));
     }
     lat++;
@@ -4404,11 +4482,7 @@ int ncon_face_coloring_by_compound(Geometry &geom,
   auto li = unique(polygon_table.begin(), polygon_table.end());
   polygon_table.erase(li, polygon_table.end());
 
-  vector<vector<int>> bare_implicit_edges;
-  fill_bare_implicit_edges(geom, bare_implicit_edges);
-
-  map<vector<int>, vector<int>> faces_by_edge;
-  fill_faces_by_edge(geom, faces_by_edge);
+  faceChannels channels(geom);
 
   int map_count = 0;
   int polygon_no_last = -1;
@@ -4429,9 +4503,9 @@ int ncon_face_coloring_by_compound(Geometry &geom,
     set_face_color(geom, face_no, c, opq);
 
     flood_fill_count++;
-    ret = set_face_colors_by_adjacent_face(
-        geom, face_no, c, opq, opts.flood_fill_stop, flood_fill_count,
-        bare_implicit_edges, faces_by_edge);
+    ret = set_face_colors_by_adjacent_face(geom, face_no, c, opq,
+                                           opts.flood_fill_stop,
+                                           flood_fill_count, channels);
 
     if (polygon_no != polygon_no_last)
       map_count++;
@@ -4442,7 +4516,7 @@ int ncon_face_coloring_by_compound(Geometry &geom,
   // color them the first map color
   if (opts.build_method < 3 && opts.mod_twist == 0) {
     for (int cap : caps)
-      geom.colors(FACES).set(face_list[cap]->face_no, opts.face_map.get_col(0));
+      geom.colors(FACES).set(face_list[cap].face_no, opts.face_map.get_col(0));
   }
 
   if (!opts.flood_fill_stop && opts.info)
@@ -4567,10 +4641,10 @@ void ncon_edge_coloring_from_faces(Geometry &geom, const ncon_opts &opts)
 
 // mark edge circuits for methods 2 and 3 color by adjacent edge
 // also for method 1, color by symmetry
-void mark_edge_circuits(Geometry &geom, const vector<edgeList *> &edge_list)
+void mark_edge_circuits(Geometry &geom, const vector<edgeList> &edge_list)
 {
-  for (auto i : edge_list) {
-    int j = i->edge_no;
+  for (auto &i : edge_list) {
+    int j = i.edge_no;
     if (!geom.colors(EDGES).get(j).is_invisible())
       set_edge_color(geom, j, INT_MAX, 255);
   }
@@ -4578,21 +4652,21 @@ void mark_edge_circuits(Geometry &geom, const vector<edgeList *> &edge_list)
 
 // for method 2, if indented edges are not shown, overwrite them as invisible
 void set_indented_edges_invisible(Geometry &geom,
-                                  const vector<edgeList *> &edge_list,
-                                  const vector<poleList *> &pole)
+                                  const vector<edgeList> &edge_list,
+                                  const vector<poleList> &pole)
 {
-  for (auto i : edge_list) {
-    int j = i->edge_no;
-    int lat = i->lat;
+  for (auto &i : edge_list) {
+    int j = i.edge_no;
+    int lat = i.lat;
     if (lat == -1)
       set_edge_color(geom, j, Color::invisible, 255);
   }
 
   for (unsigned int i = 0; i < 2; i++) {
-    if (pole[i]->idx > -1) {
-      int lat = pole[i]->lat;
+    if (pole[i].idx > -1) {
+      int lat = pole[i].lat;
       if (lat == -1)
-        set_vert_color(geom, pole[i]->idx, Color::invisible, 255);
+        set_vert_color(geom, pole[i].idx, Color::invisible, 255);
     }
   }
 }
@@ -4625,9 +4699,10 @@ void make_sequential_map(map<int, pair<int, int>> &color_table)
 }
 
 // coding idea for circuit coloring furnished by Adrian Rossiter
-void build_circuit_table(const int ncon_order, const int twist,
-                         const bool hybrid, const bool symmetric_coloring,
-                         map<int, int> &circuit_table)
+// circuits around a double size polygon repeat with the returned period, and
+// positions i and period-i are on the same circuit
+int circuit_period(const int ncon_order, const int twist, const bool hybrid,
+                   const bool symmetric_coloring)
 {
   // use a double size polygon
   int n = 2 * ncon_order;
@@ -4638,14 +4713,14 @@ void build_circuit_table(const int ncon_order, const int twist,
 
   int t_mult = symmetric_coloring ? 1 : 2;
 
-  int d = gcd(n, t_mult * t);
+  return gcd(n, t_mult * t);
+}
 
-  for (int i = 0; i <= d / 2; i++) {
-    for (int j = i; j < n; j += d)
-      circuit_table[j] = i;
-    for (int j = d - i; j < n; j += d)
-      circuit_table[j] = i;
-  }
+// circuit number of a position around the double size polygon
+int circuit_number(const int position, const int period)
+{
+  int i = position % period;
+  return (i <= period - i) ? i : period - i;
 }
 
 void build_color_table(map<int, pair<int, int>> &color_table,
@@ -4670,11 +4745,7 @@ void build_color_table(map<int, pair<int, int>> &color_table,
       t = n / 2;
   }
 
-  map<int, int> circuit_table;
-  build_circuit_table(n, t, hybrid, symmetric_coloring, circuit_table);
-
-  // for (unsigned int i=0;i<circuit_table.size();i++)
-  //   fprintf(stderr,"circuit_table[%d] = %d\n",i,circuit_table[i]);
+  int period = circuit_period(n, t, hybrid, symmetric_coloring);
 
   if (debug)
     fprintf(stderr, "color table:\n");
@@ -4683,8 +4754,8 @@ void build_color_table(map<int, pair<int, int>> &color_table,
     // when increment = -1, pos can equal -1, use last position
     if (position < 0)
       position = 2 * n + position;
-    int circuit_idx = position % circuit_table.size();
-    color_table[i].first = circuit_table[circuit_idx];
+    int circuit_idx = position % (2 * n);
+    color_table[i].first = circuit_number(circuit_idx, period);
     if (debug)
       fprintf(stderr, "%d ", color_table[i].first);
   }
@@ -4716,9 +4787,9 @@ void build_color_table(map<int, pair<int, int>> &color_table,
 }
 
 // point_cut is not that of opts
-void ncon_coloring(Geometry &geom, const vector<faceList *> &face_list,
-                   const vector<edgeList *> &edge_list,
-                   const vector<poleList *> &pole, const bool point_cut_calc,
+void ncon_coloring(Geometry &geom, const vector<faceList> &face_list,
+                   const vector<edgeList> &edge_list,
+                   const vector<poleList> &pole, const bool point_cut_calc,
                    const int lat_mode, const ncon_opts &opts)
 {
   map<int, pair<int, int>> edge_color_table;
@@ -4834,9 +4905,9 @@ void ncon_coloring(Geometry &geom, const vector<faceList *> &face_list,
 // inner_radius and outer_radius is calculated within
 // double sweep is set in build_globe()
 // radius_inversion is set
-void build_globe(Geometry &geom, vector<coordList *> &coordinates,
-                 vector<faceList *> &face_list, vector<edgeList *> &edge_list,
-                 vector<poleList *> &pole, vector<int> &caps,
+void build_globe(Geometry &geom, vector<coordList> &coordinates,
+                 vector<faceList> &face_list, vector<edgeList> &edge_list,
+                 vector<poleList> &pole, vector<int> &caps,
                  double &inner_radius, double &outer_radius,
                  bool &radius_inversion, bool &double_sweep,
                  const bool second_half, const ncon_opts &opts)
@@ -4857,7 +4928,7 @@ void build_globe(Geometry &geom, vector<coordList *> &coordinates,
     // if either pole was defined it is a point cut
     point_cut_calc = false;
     for (auto &i : pole)
-      if (i->idx != -1)
+      if (i.idx != -1)
         point_cut_calc = true;
 
     // forms with a vertex on Y axis only need 1/2 pass
@@ -4981,8 +5052,8 @@ double hybrid_twist_angle(const int ncon_order, const int d, const int tw,
 }
 
 // if partial model, delete appropriate elements
-void delete_unused_longitudes(Geometry &geom, vector<faceList *> &face_list,
-                              vector<edgeList *> &edge_list,
+void delete_unused_longitudes(Geometry &geom, vector<faceList> &face_list,
+                              vector<edgeList> &edge_list,
                               const vector<int> &caps, const bool opposite,
                               const ncon_opts &opts)
 {
@@ -4992,20 +5063,20 @@ void delete_unused_longitudes(Geometry &geom, vector<faceList *> &face_list,
   // don't allow caps to be deleted
   if (opts.build_method == 2) {
     for (int cap : caps) {
-      int lon = face_list[cap]->lon;
+      int lon = face_list[cap].lon;
       if (lon < opts.longitudes.front() / 2)
-        face_list[cap]->lon = -1;
+        face_list[cap].lon = -1;
     }
   }
 
   vector<int> delete_list;
   vector<int> delete_elem;
   for (unsigned int i = 0; i < face_list.size(); i++) {
-    bool val = (face_list[i]->lon >= opts.longitudes.back());
+    bool val = (face_list[i].lon >= opts.longitudes.back());
     if ((!opposite && val) || (opposite && !val)) {
       delete_list.push_back(i);
       // face_no doesn't work for method 3
-      // int j = face_list[i]->face_no;
+      // int j = face_list[i].face_no;
       delete_elem.push_back(i);
     }
   }
@@ -5018,11 +5089,11 @@ void delete_unused_longitudes(Geometry &geom, vector<faceList *> &face_list,
   delete_list.clear();
   delete_elem.clear();
   for (unsigned int i = 0; i < edge_list.size(); i++) {
-    bool val = (edge_list[i]->lon >= opts.longitudes.back());
+    bool val = (edge_list[i].lon >= opts.longitudes.back());
     if ((!opposite && val) || (opposite && !val)) {
       delete_list.push_back(i);
       // edge_no doesn't work for method 3
-      // int j = edge_list[i]->edge_no;
+      // int j = edge_list[i].edge_no;
       delete_elem.push_back(i);
     }
   }
@@ -5046,11 +5117,11 @@ void delete_unused_longitudes(Geometry &geom, vector<faceList *> &face_list,
 }
 
 // if edges are not specified they need to be cleared
-void delete_unused_edges(Geometry &geom, vector<edgeList *> &edge_list,
+void delete_unused_edges(Geometry &geom, vector<edgeList> &edge_list,
                          const ncon_opts &opts)
 {
   if (!opts.edge_coloring_method) {
-    clear_edges(edge_list);
+    edge_list.clear();
     geom.clear(EDGES);
     geom.colors(VERTS).clear();
   }
@@ -5066,8 +5137,9 @@ bool triangle_zero_area(const Geometry &geom, const int idx1, const int idx2,
 }
 
 void add_triangles_to_close(Geometry &geom, vector<int> &added_triangles,
-                            const double eps)
+                            const ncon_opts &opts)
 {
+  const double eps = opts.epsilon;
   vector<int> face(3);
   vector<int> face_check(3);
 
@@ -5114,9 +5186,9 @@ void add_triangles_to_close(Geometry &geom, vector<int> &added_triangles,
           // check for infinite loop
           if (face[0] == face_check[0] && face[1] == face_check[1] &&
               face[2] == face_check[2]) {
-            fprintf(stderr, "warning: face %d %d %d failed. Polygon at limits "
-                            "of accuracy (method=3)\n",
-                    face[0], face[1], face[2]);
+            opts.report(msg_str("warning: face %d %d %d failed. Polygon at "
+                                "limits of accuracy (method=3)\n",
+                                face[0], face[1], face[2]));
             return;
           }
         }
@@ -5134,14 +5206,16 @@ void add_triangles_to_close(Geometry &geom, vector<int> &added_triangles,
 // hybrids lose opts.longitudes.front()/2-1 from the edge_list
 // be able to back it up and restore it using color elements that are carried
 // along with them
-void backup_flood_longitude_edges(Geometry &geom, vector<edgeList *> &edge_list,
+void backup_flood_longitude_edges(Geometry &geom, vector<edgeList> &edge_list,
                                   const ncon_opts &opts)
 {
+  latLonIndex edge_lat_lon(edge_list);
+
   int sz = 0;
   int lat = 1;
   int lon = opts.longitudes.front() / 2 - 1;
   do {
-    vector<int> idx = find_edge_by_lat_lon(edge_list, lat, lon);
+    vector<int> idx = edge_lat_lon.find(lat, lon);
     sz = (int)idx.size();
     for (int j = 0; j < sz; j++)
       geom.colors(EDGES).set(idx[j], Color(lat));
@@ -5150,8 +5224,7 @@ void backup_flood_longitude_edges(Geometry &geom, vector<edgeList *> &edge_list,
 }
 
 // after restore, change color index to INT_MAX for flood fill procedure
-void restore_flood_longitude_edges(Geometry &geom,
-                                   vector<edgeList *> &edge_list,
+void restore_flood_longitude_edges(Geometry &geom, vector<edgeList> &edge_list,
                                    const ncon_opts &opts)
 {
   const vector<vector<int>> &edges = geom.edges();
@@ -5160,20 +5233,22 @@ void restore_flood_longitude_edges(Geometry &geom,
     Color c = geom.colors(EDGES).get(i);
     int j = c.get_index();
     if (j != INT_MAX && !c.is_invisible()) {
-      edge_list.push_back(new edgeList(i, j, opts.longitudes.front() / 2 - 1));
+      edge_list.push_back(edgeList(i, j, opts.longitudes.front() / 2 - 1));
       geom.colors(EDGES).set(i, INT_MAX);
     }
   }
 }
 
-void backup_flood_longitude_faces(Geometry &geom, vector<faceList *> &face_list,
+void backup_flood_longitude_faces(Geometry &geom, vector<faceList> &face_list,
                                   const ncon_opts &opts)
 {
+  latLonIndex face_lat_lon(face_list);
+
   int sz = 0;
   int lat = 0;
   int lon = opts.longitudes.front() / 2 - 1;
   do {
-    vector<int> idx = find_face_by_lat_lon(face_list, lat, lon);
+    vector<int> idx = face_lat_lon.find(lat, lon);
     sz = (int)idx.size();
     for (int j = 0; j < sz; j++)
       geom.colors(FACES).set(idx[j], Color(lat));
@@ -5182,8 +5257,7 @@ void backup_flood_longitude_faces(Geometry &geom, vector<faceList *> &face_list,
 }
 
 // after restore, unset face color
-void restore_flood_longitude_faces(Geometry &geom,
-                                   vector<faceList *> &face_list,
+void restore_flood_longitude_faces(Geometry &geom, vector<faceList> &face_list,
                                    const ncon_opts &opts)
 {
   const vector<vector<int>> &faces = geom.faces();
@@ -5192,7 +5266,7 @@ void restore_flood_longitude_faces(Geometry &geom,
     if (geom.colors(FACES).get(i).is_index()) {
       int j = geom.colors(FACES).get(i).get_index();
       face_list.push_back(
-          new faceList(i, j, opts.longitudes.front() / 2 - 1, 0));
+          faceList(i, j, opts.longitudes.front() / 2 - 1, 0));
       geom.colors(FACES).set(i, Color());
     }
   }
@@ -5212,14 +5286,14 @@ int process_hybrid(Geometry &geom, ncon_opts &opts)
   int longitudes_back = opts.longitudes.back();
 
   // attributes of elements
-  vector<coordList *> coordinates;
-  vector<faceList *> face_list;
-  vector<edgeList *> edge_list;
+  vector<coordList> coordinates;
+  vector<faceList> face_list;
+  vector<edgeList> edge_list;
 
   // create memory for poles 0 - North Pole 1 - South Pole
-  vector<poleList *> pole;
-  pole.push_back(new poleList);
-  pole.push_back(new poleList);
+  vector<poleList> pole;
+  pole.push_back(poleList());
+  pole.push_back(poleList());
 
   // keep track of caps
   vector<int> caps;
@@ -5257,9 +5331,9 @@ int process_hybrid(Geometry &geom, ncon_opts &opts)
     backup_flood_longitude_edges(geom_d, edge_list, opts);
 
   // start over. build base part second, then rotate it
-  clear_coord(coordinates);
-  clear_faces(face_list);
-  clear_edges(edge_list);
+  coordinates.clear();
+  face_list.clear();
+  edge_list.clear();
   caps.clear();
 
   opts.inner_radius = inner_radius_save;
@@ -5301,7 +5375,7 @@ int process_hybrid(Geometry &geom, ncon_opts &opts)
 
   // merge by using polar orbit coordinates. this keeps the face_list pointing
   // to the right faces
-  vector<polarOrb *> polar_orbit;
+  vector<polarOrb> polar_orbit;
   find_polar_orbit(geom, polar_orbit, opts.build_method, opts.epsilon);
   merge_halves(geom, polar_orbit, opts.epsilon);
   polar_orbit.clear();
@@ -5310,7 +5384,7 @@ int process_hybrid(Geometry &geom, ncon_opts &opts)
   // make it a valid polyhedron, and be able to flood fill across divide
   vector<int> added_triangles;
   if (opts.build_method == 3)
-    add_triangles_to_close(geom, added_triangles, opts.epsilon);
+    add_triangles_to_close(geom, added_triangles, opts);
 
   opts.longitudes.back() = longitudes_back;
 
@@ -5346,9 +5420,9 @@ int process_hybrid(Geometry &geom, ncon_opts &opts)
                    Trans3d::rotate(0, 0, deg2rad(twist_angle)));
 
   // clean up
-  clear_coord(coordinates);
-  clear_faces(face_list);
-  clear_edges(edge_list);
+  coordinates.clear();
+  face_list.clear();
+  edge_list.clear();
 
   return ret;
 }
@@ -5358,14 +5432,14 @@ int process_normal(Geometry &geom, ncon_opts &opts)
 {
   int ret = 0;
 
-  vector<coordList *> coordinates;
-  vector<faceList *> face_list;
-  vector<edgeList *> edge_list;
+  vector<coordList> coordinates;
+  vector<faceList> face_list;
+  vector<edgeList> edge_list;
 
   // create memory for poles 0 - North Pole 1 - South Pole
-  vector<poleList *> pole;
-  pole.push_back(new poleList);
-  pole.push_back(new poleList);
+  vector<poleList> pole;
+  pole.push_back(poleList());
+  pole.push_back(poleList());
 
   // keep track of caps
   vector<int> caps;
@@ -5380,7 +5454,7 @@ int process_normal(Geometry &geom, ncon_opts &opts)
 
   // now we do the twisting
   // twist plane is now determined by points landing on z-plane
-  vector<polarOrb *> polar_orbit;
+  vector<polarOrb> polar_orbit;
   find_polar_orbit(geom, polar_orbit, opts.build_method, opts.epsilon);
 
   // method 1: can't twist when half or less of model is showing
@@ -5405,7 +5479,7 @@ int process_normal(Geometry &geom, ncon_opts &opts)
 
     // for build method 3 there are some unmatched edges
     // make it a valid polyhedron, and be able to flood fill across divide
-    add_triangles_to_close(geom, added_triangles, opts.epsilon);
+    add_triangles_to_close(geom, added_triangles, opts);
   }
 
   if (opts.build_method > 1 && opts.face_coloring_method == 'f')
@@ -5439,9 +5513,9 @@ int process_normal(Geometry &geom, ncon_opts &opts)
   }
 
   // clean up
-  clear_coord(coordinates);
-  clear_faces(face_list);
-  clear_edges(edge_list);
+  coordinates.clear();
+  face_list.clear();
+  edge_list.clear();
 
   return ret;
 }
@@ -5451,10 +5525,13 @@ void ncon_make_inv_edges_of_inv_faces(Geometry &geom)
   const vector<vector<int>> &faces = geom.faces();
   const vector<vector<int>> &edges = geom.edges();
 
+  map<vector<int>, vector<int>> edge_faces;
+  fill_edge_faces(faces, edge_faces);
+
   for (unsigned int i = 0; i < edges.size(); i++) {
     if ((geom.colors(EDGES).get(i)).is_invisible())
       continue;
-    vector<int> face_idx = find_faces_with_edge(faces, edges[i]);
+    vector<int> face_idx = find_faces_in_edge_faces(edge_faces, edges[i]);
     vector<Color> cols;
     for (int j : face_idx)
       cols.push_back(geom.colors(FACES).get(j));
@@ -6018,12 +6095,14 @@ void color_by_symmetry(Geometry &geom, bool &radius_set, ncon_opts &opts)
           "digons in method 3 are taken from edge coloring. none was specified",
           'e');
     else {
+      map<vector<int>, int> edge_index;
+      fill_edge_index(geom.edges(), edge_index);
       for (unsigned int i = 0; i < geom.faces().size(); i++) {
         vector<int> face = geom.faces(i);
         int sz = face.size();
         for (int j = 0; j < sz; j++) {
           vector<int> edge = make_edge(face[j], face[(j + 1) % sz]);
-          int edge_no = find_edge_in_edge_list(geom.edges(), edge);
+          int edge_no = find_edge_in_edge_index(edge_index, edge);
           Color c = geom.colors(EDGES).get(edge_no);
           if ((edge_no != -1) && !c.is_invisible()) {
             geom.colors(FACES).set(i, c);
@@ -6087,17 +6166,16 @@ int ncon_subsystem(Geometry &geom, ncon_opts &opts)
   if (opts.info) {
     model_info(geom, opts);
 
-    vector<surfaceTable *> surface_table;
     if ((opts.d > 1 && (opts.ncon_order - opts.d > 1)) ||
         (opts.build_method == 3 && opts.angle != 0.0)) {
       // fprintf(stderr,"face/edge circuit info not available for star n_icons
       // or those with non-zero angles\n");
     }
     else {
+      surfaceCounts counts(opts.ncon_order, opts.point_cut, opts.hybrid);
       surfaceData sd;
       ncon_info(opts.ncon_order, opts.point_cut, opts.twist, opts.hybrid,
-                opts.info, surface_table, sd);
-      surface_table.clear();
+                opts.info, counts, sd);
     }
   }
 
@@ -6140,9 +6218,46 @@ int ncon_subsystem(Geometry &geom, ncon_opts &opts)
   return ret;
 }
 
+// twists from 2 to last that may have more than the minimum number of
+// surfaces. These are those with a twist factor in common with the order
+// (see find_surface_count()), so are found from the prime factors of the order
+vector<int> multi_surface_twists(const int ncon_order, const bool hybrid,
+                                 const int last)
+{
+  // hybrids use 2*twist-1, even orders use 2*twist
+  int n = (is_even(ncon_order) && !hybrid) ? ncon_order / 2 : ncon_order;
+  vector<int> primes;
+  for (int p = 2; p * p <= n; p++) {
+    if (n % p == 0) {
+      primes.push_back(p);
+      while (n % p == 0)
+        n /= p;
+    }
+  }
+  if (n > 1)
+    primes.push_back(n);
+
+  vector<int> twists;
+  for (int p : primes) {
+    if (hybrid) {
+      // 2*twist-1 is odd
+      if (p == 2)
+        continue;
+      for (int twist = (p + 1) / 2; twist <= last; twist += p)
+        twists.push_back(twist);
+    }
+    else
+      for (int twist = p; twist <= last; twist += p)
+        twists.push_back(twist);
+  }
+  sort(twists.begin(), twists.end());
+  twists.erase(unique(twists.begin(), twists.end()), twists.end());
+
+  return twists;
+}
+
 void surface_subsystem(const ncon_opts &opts)
 {
-  vector<surfaceTable *> surface_table;
   surfaceData sd;
 
   char form = opts.ncon_surf[0];
@@ -6234,15 +6349,18 @@ void surface_subsystem(const ncon_opts &opts)
     else if (form == 'h')
       hybrid = true;
 
+    surfaceCounts counts(ncon_order, point_cut, hybrid);
     bool none = true;
 
+    // build the whole report for this order before writing it out
+    string report;
     if (opts.long_form)
-      fprintf(stderr, "%-5d: ", ncon_order);
+      report += msg_str("%-5d: ", ncon_order);
     else
-      fprintf(stderr, "%d: ", ncon_order);
+      report += msg_str("%d: ", ncon_order);
 
-    for (int twist = 2; twist <= last; twist++) {
-      ncon_info(ncon_order, point_cut, twist, hybrid, info, surface_table, sd);
+    for (int twist : multi_surface_twists(ncon_order, hybrid, last)) {
+      ncon_info(ncon_order, point_cut, twist, hybrid, info, counts, sd);
 
       if ((!is_even(ncon_order) && sd.total_surfaces > 1) ||
           (form != 's' && sd.total_surfaces > 1) ||
@@ -6250,38 +6368,59 @@ void surface_subsystem(const ncon_opts &opts)
         if (!sd.ncon_case2 || (sd.ncon_case2 && !opts.filter_case2)) {
           if (!none) {
             if (opts.long_form)
-              fprintf(stderr, "%-5d: ", ncon_order);
+              report += msg_str("%-5d: ", ncon_order);
             else
-              fprintf(stderr, ", ");
+              report += ", ";
           }
-          char buffer[MSG_SZ];
+          string n_icon;
           if (sd.nonchiral)
-            sprintf(buffer, "[%d+%d]", ncon_order, twist);
+            n_icon = msg_str("[%d+%d]", ncon_order, twist);
           else if (sd.ncon_case2)
-            sprintf(buffer, "{%d+%d}", ncon_order, twist);
+            n_icon = msg_str("{%d+%d}", ncon_order, twist);
           else
-            sprintf(buffer, "(%d+%d)", ncon_order, twist);
+            n_icon = msg_str("(%d+%d)", ncon_order, twist);
           if (opts.long_form)
-            fprintf(stderr, "%-15s %5d %10d %13d %10d %13d\n", buffer,
-                    sd.total_surfaces, sd.c_surfaces, sd.d_surfaces, sd.c_edges,
-                    sd.d_edges);
+            report += msg_str("%-15s %5d %10d %13d %10d %13d\n",
+                              n_icon.c_str(), sd.total_surfaces,
+                              sd.c_surfaces, sd.d_surfaces, sd.c_edges,
+                              sd.d_edges);
           else
-            fprintf(stderr, "%s", buffer);
+            report += n_icon;
           none = false;
         }
       }
     }
-    surface_table.clear();
 
     if (none) {
-      fprintf(stderr, "none");
+      report += "none";
       if (opts.long_form)
-        fprintf(stderr, "\n");
+        report += "\n";
     }
-    fprintf(stderr, "\n");
+    report += "\n";
+    fputs(report.c_str(), stderr);
   }
 }
 
+int batch_subsystem(const ncon_opts &opts)
+{
+  auto check_opts = [](ncon_opts &item) {
+    if (item.batch_file.length())
+      item.error("batch mode is not valid in a batch line", 'B');
+    if (item.ncon_surf.length())
+      item.error("surface count reporting is not valid in batch mode", 'J');
+    if (item.info)
+      item.error("information is not available in batch mode", 'I');
+  };
+
+  // the exit value of a model is kept in the code of its status
+  auto make_model = [](Geometry &geom, ncon_opts &item) {
+    return Status::ok("", ncon_subsystem(geom, item));
+  };
+
+  return make_batch<ncon_opts>(opts, opts.batch_file, opts.ofile,
+                               opts.num_threads, make_model, check_opts);
+}
+
 int main(int argc, char *argv[])
 {
   int ret = 0;
@@ -6289,7 +6428,9 @@ int main(int argc, char *argv[])
   ncon_opts opts;
   opts.process_command_line(argc, argv);
 
-  if (opts.ncon_surf.length())
+  if (opts.batch_file.length())
+    ret = batch_subsystem(opts);
+  else if (opts.ncon_surf.length())
     surface_subsystem(opts);
   else {
     Geometry geom;
@@ -85,15 +85,31 @@ public:
   polarOrb(int c) : coord_no(c) {}
 };
 
-class surfaceTable {
+// surface counts of the twisted n-icons of one order, these follow from
+// the gcd of the order and the twist so are found directly for each twist
+class surfaceCounts {
 public:
-  int twist;
-  int surfaces;
-  int case1_twist;
-  bool case2;
-  surfaceTable(int t, int s, int c, bool r)
-      : twist(t), surfaces(s), case1_twist(c), case2(r)
+  int n;
+  int t_mod;
+  int axis_edges;
+  bool side_cut_even;
+  bool hybrid;
+  bool min_count_point_cut;
+  surfaceCounts(int ncon_order, bool point_cut, bool hybrid)
+      : n(ncon_order), t_mod(0), axis_edges(0), hybrid(hybrid)
   {
+    bool even = (ncon_order % 2 == 0);
+    side_cut_even = even && !point_cut;
+    min_count_point_cut = even && point_cut && !hybrid;
+    if (!even || hybrid) {
+      axis_edges = 1;
+      if (hybrid) {
+        n *= 2;
+        t_mod = 1;
+      }
+    }
+    else if (side_cut_even)
+      axis_edges = 2;
   }
 };
 
@@ -331,6 +331,7 @@ void vertex_query(FILE *ofile, rep_printer &rep, oq_opts &opts)
     }
   }
 
+  rep.find_props(rep_printer::query_props(opts.query));
   for (int idx : opts.idxs) {
     for (unsigned int j = 0; j < query_items.size(); j++) {
       if (j)
@@ -380,6 +381,7 @@ void edge_query(FILE *ofile, rep_printer &rep, oq_opts &opts)
     }
   }
 
+  rep.find_props(rep_printer::query_props(opts.query));
   for (int idx : opts.idxs) {
     for (unsigned int j = 0; j < query_items.size(); j++) {
       if (j)
@@ -439,6 +441,7 @@ void face_query(FILE *ofile, rep_printer &rep, oq_opts &opts)
     }
   }
 
+  rep.find_props(rep_printer::query_props(opts.query));
   for (int idx : opts.idxs) {
     for (unsigned int j = 0; j < query_items.size(); j++) {
       if (j)
@@ -317,6 +317,7 @@ int main(int argc, char *argv[])
       geom.orient_reverse();
   }
 
+  rep.find_report_props(opts.sections.c_str(), opts.counts.c_str());
   print_sections(rep, opts.sections.c_str());
   print_counts(rep, opts.counts.c_str());
 
@@ -57,9 +57,10 @@ using namespace anti;
 int unzip_poly(Geometry &geom, int root, double fract, char centring,
                bool unzip_z_align, char *errmsg);
 
-void triangulate_faces(Geometry &geom, unsigned int winding_rule)
+void triangulate_faces(Geometry &geom, unsigned int winding_rule,
+                       int num_threads)
 {
-  geom.triangulate(Color::invisible, winding_rule);
+  geom.triangulate(Color::invisible, winding_rule, nullptr, num_threads);
 }
 
 void make_skeleton(Geometry &geom)
@@ -1222,6 +1223,8 @@ void pr_opts::usage()
 "  -t <disp> triangulate, include face parts according to winding number\n"
 "            from: odd, nonzero, positive, negative, triangulate (synonym\n"
 "            for nonzero)\n"
+"  -j <thr>  number of threads for the triangulations that follow it\n"
+"            (default: 0, use all hardware threads)\n"
 "  -g        geometry only, remove all colours, remove all two-vertex faces\n"
 "            (edges) that are also a face edge\n"
 "  -x <elms> remove OFF face elements. The element string is processed in\n"
@@ -1331,7 +1334,7 @@ void pr_opts::process_command_line(int argc, char **argv)
   handle_long_opts(argc, argv);
 
   bool trailing_option_l = false; // to warn if there is an -l after a -M
-  while ((c = getopt(argc, argv, ":hH:st:O:d:x:eD:K:A:c:gT:SM:l:u:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":hH:st:O:d:x:eD:K:A:c:gT:SM:l:u:j:o:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -1373,6 +1376,7 @@ void pr_opts::process_command_line(int argc, char **argv)
   }
 
   int sig_compare = INT_MAX;
+  int num_threads = 0;
   vector<string> add_elems;
 
   for (auto &arg : args) {
@@ -1416,7 +1420,8 @@ void pr_opts::process_command_line(int argc, char **argv)
                       "odd|nonzero|positive|negative|triangulate=1"))
         error(msg_str("invalid winding rule '%s'", optarg).c_str(), c);
 
-      triangulate_faces(geom, TESS_WINDING_ODD + atoi(arg_id.c_str()));
+      triangulate_faces(geom, TESS_WINDING_ODD + atoi(arg_id.c_str()),
+                        num_threads);
       break;
 
     case 'd':
@@ -1586,6 +1591,12 @@ void pr_opts::process_command_line(int argc, char **argv)
       }
       break;
 
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     case 'u': {
       int unzip_root;
       split_line(optarg, parts, ",");
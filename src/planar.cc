@@ -37,6 +37,9 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../base/antiprism.h"
@@ -46,6 +49,7 @@ using std::vector;
 using std::pair;
 using std::make_pair;
 using std::map;
+using std::unordered_map;
 using std::min;
 using std::max;
 
@@ -87,6 +91,8 @@ public:
   double value_advance;
   int alpha_mode;
   int face_opacity;
+  int num_threads;
+  bool exact_predicates;
 
   ColorMapMulti map;
   ColorMapMulti map_negative;
@@ -105,7 +111,8 @@ public:
         zero_density_force_blend(false), brightness_adj(-2.0),
         color_system_mode(3), cmy_mode(false), ryb_mode(false), sat_power(0.0),
         value_power(0.0), sat_threshold(1.0), value_advance(0.0), alpha_mode(3),
-        face_opacity(-1), epsilon(0)
+        face_opacity(-1), num_threads(0), exact_predicates(false),
+        epsilon(0)
   {
   }
 
@@ -155,6 +162,10 @@ void planar_opts::usage()
 "  -C <xyz>  center of model, in form 'X,Y,Z' (default: centroid)\n"
 "  -l <lim>  minimum distance for unique vertex locations as negative exponent\n"
 "               (default: %d giving %.0e)\n"
+"  -x        exact predicates, decide edge crossings and whether points are\n"
+"               in polygons exactly (-l still limits vertex locations)\n"
+"  -j <thr>  number of threads for tiling or merging, the planes are\n"
+"               processed in parallel (default: 0, use all hardware threads)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
 "\nColor Blending Options (for option -d)\n"
 "  -M <mode> color blending mode. HSV=1, HSL=2, RGB=3 (default: 3)\n"
@@ -211,7 +222,7 @@ void planar_opts::process_command_line(int argc, char **argv)
 
   while ((c = getopt(
               argc, argv,
-              ":hd:p:w:zVO:HC:SRrIe:E:Db:M:s:t:v:u:a:cyf:T:m:Z:W:n:l:o:")) !=
+              ":hd:p:w:zVO:HC:SRrIe:E:Db:M:s:t:v:u:a:cyf:T:m:Z:W:n:l:xj:o:")) !=
          -1) {
     if (common_opts(c, optopt))
       continue;
@@ -442,6 +453,16 @@ void planar_opts::process_command_line(int argc, char **argv)
       }
       break;
 
+    case 'x':
+      exact_predicates = true;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     case 'o':
       ofile = optarg;
       break;
@@ -536,24 +557,57 @@ vector<vector<int>> on_same_plane_filter(const Geometry &geom,
     return coplanar_faces_filtered;
   }
 
+  // a face can only be on the plane of another face if their offsets
+  // along the normal are in the same or neighbouring buckets. The margin
+  // allows for rounding in the offsets
+  int sz = coplanar_faces.size();
+  vector<double> offsets(sz);
+  double max_len = 0.0;
+  for (int i = 0; i < sz; i++) {
+    const Vec3d &v0 = verts[faces[coplanar_faces[i]][0]];
+    offsets[i] = vdot(v0, normal);
+    max_len = max(max_len, v0.len());
+  }
+  double margin = eps + 8 * DBL_EPSILON * max_len * normal.len();
+  double bucket_sz = (margin > 0) ? 2 * margin : 1.0;
+  auto bucket_idx = [bucket_sz](double offset) {
+    // clamp, so distant planes share the end buckets rather than overflow
+    const double lim = 1e18;
+    return (long long)max(-lim, min(lim, floor(offset / bucket_sz)));
+  };
+
+  // positions in coplanar_faces, in order
+  unordered_map<long long, vector<int>> buckets;
+  for (int i = 0; i < sz; i++)
+    buckets[bucket_idx(offsets[i])].push_back(i);
+
   vector<int> coplanar_faces_actual;
-  vector<int> written;
+  vector<bool> written(sz, false);
 
-  int sz = coplanar_faces.size();
   for (int i = 0; i < sz; i++) {
-    int face_idx1 = coplanar_faces[i];
-    if (find(written.begin(), written.end(), face_idx1) != written.end())
+    if (written[i])
       continue;
+    int face_idx1 = coplanar_faces[i];
     coplanar_faces_actual.push_back(face_idx1);
-    for (int j = i + 1; j < sz; j++) {
-      if (i == j)
-        continue;
+
+    vector<int> candidates;
+    long long b_idx = bucket_idx(offsets[i]);
+    for (long long b = b_idx - 1; b <= b_idx + 1; b++) {
+      auto bucket = buckets.find(b);
+      if (bucket != buckets.end())
+        for (int j : bucket->second)
+          if (j > i)
+            candidates.push_back(j);
+    }
+    sort(candidates.begin(), candidates.end());
+
+    for (int j : candidates) {
       int face_idx2 = coplanar_faces[j];
       Vec3d v0 = verts[faces[face_idx1][0]];
       Vec3d P = verts[faces[face_idx2][0]];
       if (double_eq(vdot(v0 - P, normal), 0.0, eps)) {
         coplanar_faces_actual.push_back(face_idx2);
-        written.push_back(face_idx2);
+        written[j] = true;
       }
     }
 
@@ -564,6 +618,30 @@ vector<vector<int>> on_same_plane_filter(const Geometry &geom,
   return coplanar_faces_filtered;
 }
 
+// reverse each normal which is opposite to an earlier normal in the table
+// the normals are held in a hash, so only nearby normals are compared
+void fold_normal_table(vector<pair<Vec3d, int>> &table, const double eps)
+{
+  vector<Vec3d> normals;
+  for (auto &kp : table)
+    normals.push_back(kp.first);
+  VertexHash nhash(normals, eps);
+
+  int sz = table.size();
+  for (int i = 0; i < sz - 1; i++) {
+    for (int j : nhash.find_all(normals, -normals[i])) {
+      if (j <= i)
+        continue;
+      nhash.remove(normals[j], j);
+      normals[j] = -normals[j];
+      nhash.add(normals[j], j);
+    }
+  }
+
+  for (int i = 0; i < sz; i++)
+    table[i].first = normals[i];
+}
+
 void build_coplanar_faces_list(const Geometry &geom,
                                vector<vector<int>> &coplanar_faces_list,
                                vector<Normal> &coplanar_normals,
@@ -601,16 +679,8 @@ void build_coplanar_faces_list(const Geometry &geom,
   // hemispherical normals are folded only with specific option
   // if folded, this is what associates them on the same plane
   int sz = hemispherical_table.size();
-  if (fold_normals_hemispherical && (sz > 1)) {
-    for (int i = 0; i < sz - 1; i++) {
-      for (int j = i + 1; j < sz; j++) {
-        if (!compare(hemispherical_table[i].first,
-                     -hemispherical_table[j].first, eps)) {
-          hemispherical_table[j].first = -hemispherical_table[j].first;
-        }
-      }
-    }
-  }
+  if (fold_normals_hemispherical && (sz > 1))
+    fold_normal_table(hemispherical_table, eps);
 
   // collect hemispherical which are coplanar
   if (sz) {
@@ -647,16 +717,8 @@ void build_coplanar_faces_list(const Geometry &geom,
 
   // non-hemispherical normals are folded only with specific option
   sz = face_normal_table.size();
-  if (fold_normals && (sz > 1)) {
-    for (int i = 0; i < sz - 1; i++) {
-      for (int j = i + 1; j < sz; j++) {
-        if (!compare(face_normal_table[i].first, -face_normal_table[j].first,
-                     eps)) {
-          face_normal_table[j].first = -face_normal_table[j].first;
-        }
-      }
-    }
-  }
+  if (fold_normals && (sz > 1))
+    fold_normal_table(face_normal_table, eps);
 
   // collect non-hemispherical which are coplanar
   if (sz) {
@@ -1170,6 +1232,50 @@ bool is_point_inside_polygon(const Geometry &polygon, const Vec3d &P,
   return answer;
 }
 
+// as is_point_inside_polygon() with include_edges, for a point on the
+// plane of the polygon, but with exact orientation and incidence tests.
+// winding is of the polygon projected along idx, with exact tests
+bool is_point_inside_polygon_exact(const Geometry &polygon, const Vec3d &P,
+                                   const PolygonWinding &winding,
+                                   const int idx, const int sign,
+                                   const int polygon_fill_type)
+{
+  const vector<vector<int>> &faces = polygon.faces();
+  const vector<Vec3d> &verts = polygon.verts();
+  int idx1 = (idx + 1) % 3;
+  int idx2 = (idx + 2) % 3;
+  auto side = [&](const Vec3d &A, const Vec3d &B) {
+    return sign *
+           orient2d(A[idx1], A[idx2], B[idx1], B[idx2], P[idx1], P[idx2]);
+  };
+
+  // triangles of the polygon include their edges
+  if (polygon_fill_type == 3) {
+    for (const auto &face : faces) {
+      const Vec3d &A = verts[face[0]];
+      const Vec3d &B = verts[face[1]];
+      const Vec3d &C = verts[face[2]];
+      if (side(A, B) >= 0 && side(B, C) >= 0 && side(C, A) >= 0)
+        return true;
+    }
+    return false;
+  }
+
+  // the angle sum is 2pi times the winding number, and the ray crossing
+  // count has the parity of the winding number
+  int winding_number = winding.get_winding_number(P);
+  if ((polygon_fill_type == 1) ? winding_number != 0 : winding_number % 2)
+    return true;
+
+  const vector<int> &face = faces[0];
+  int fsz = face.size();
+  for (int i = 0; i < fsz; i++)
+    if (in_segment_exact(P, verts[face[i]], verts[face[(i + 1) % fsz]], idx))
+      return true;
+
+  return false;
+}
+
 int intersection_is_end_point(const Vec3d &intersection_point, const Vec3d &P0,
                               const Vec3d &P1, const double eps)
 {
@@ -1181,6 +1287,100 @@ int intersection_is_end_point(const Vec3d &intersection_point, const Vec3d &P0,
   return which_one;
 }
 
+// vertices held in the cells of a grid, for finding the vertices that may be
+// near a line segment
+class VertexGrid {
+private:
+  double cell_sz;
+  Vec3d lo;
+  Vec3d hi;
+  unordered_map<uint64_t, vector<int>> cells;
+
+  // cell coordinates are clamped, distant points share the end cells
+  uint64_t cell_coord(double coord, int dim) const
+  {
+    const double lim = (1 << 21) - 1;
+    return (uint64_t)max(0.0, min(lim, floor((coord - lo[dim]) / cell_sz)));
+  }
+  uint64_t cell_key(uint64_t x, uint64_t y, uint64_t z) const
+  {
+    return (x << 42) | (y << 21) | z;
+  }
+
+public:
+  VertexGrid(const vector<Vec3d> &verts, int vsz, double cell_sz)
+      : cell_sz(cell_sz)
+  {
+    if (!vsz)
+      return;
+    lo = verts[0];
+    hi = verts[0];
+    for (int v_idx = 1; v_idx < vsz; v_idx++)
+      for (int d = 0; d < 3; d++) {
+        lo[d] = min(lo[d], verts[v_idx][d]);
+        hi[d] = max(hi[d], verts[v_idx][d]);
+      }
+    for (int v_idx = 0; v_idx < vsz; v_idx++) {
+      const Vec3d &P = verts[v_idx];
+      cells[cell_key(cell_coord(P[0], 0), cell_coord(P[1], 1),
+                     cell_coord(P[2], 2))]
+          .push_back(v_idx);
+    }
+  }
+
+  // the vertices within dist of the line Q0 + s*u, for s in [s0, s1]. The
+  // range is first clipped to the vertices, widened by dist
+  vector<int> near_line(const Vec3d &Q0, const Vec3d &u, double s0, double s1,
+                        double dist) const
+  {
+    vector<int> v_idxs;
+    if (cells.empty())
+      return v_idxs;
+
+    for (int d = 0; d < 3; d++) {
+      if (u[d] == 0.0) {
+        if (Q0[d] < lo[d] - dist || Q0[d] > hi[d] + dist)
+          return v_idxs;
+        continue;
+      }
+      double t0 = (lo[d] - dist - Q0[d]) / u[d];
+      double t1 = (hi[d] + dist - Q0[d]) / u[d];
+      s0 = max(s0, min(t0, t1));
+      s1 = min(s1, max(t0, t1));
+    }
+    if (!(s0 <= s1))
+      return v_idxs;
+
+    // points at steps of half a cell along the line, a box around each
+    // covers the line to the next point
+    double half_width = cell_sz / 4 + dist;
+    double step = cell_sz / 2;
+    long steps = (long)ceil((s1 - s0) / step);
+    vector<uint64_t> keys;
+    for (long i = 0; i <= steps; i++) {
+      Vec3d C = Q0 + min(s0 + i * step, s1) * u;
+      uint64_t c_lo[3], c_hi[3];
+      for (int d = 0; d < 3; d++) {
+        c_lo[d] = cell_coord(C[d] - half_width, d);
+        c_hi[d] = cell_coord(C[d] + half_width, d);
+      }
+      for (uint64_t x = c_lo[0]; x <= c_hi[0]; x++)
+        for (uint64_t y = c_lo[1]; y <= c_hi[1]; y++)
+          for (uint64_t z = c_lo[2]; z <= c_hi[2]; z++)
+            keys.push_back(cell_key(x, y, z));
+    }
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+
+    for (auto key : keys) {
+      auto cell = cells.find(key);
+      if (cell != cells.end())
+        v_idxs.insert(v_idxs.end(), cell->second.begin(), cell->second.end());
+    }
+    return v_idxs;
+  }
+};
+
 // anywhere a vertex is on an edge, split that edge
 bool mesh_verts(Geometry &geom, const double eps)
 {
@@ -1191,6 +1391,39 @@ bool mesh_verts(Geometry &geom, const double eps)
   int vsz = verts.size();
   int esz = edges.size();
 
+  // a vertex P is in an edge if it is within eps of the nearest point on
+  // the edge line, and in_segment() puts that point between the edge ends.
+  // in_segment() compares the first coordinate that varies along the edge
+  // first, so only that coordinate bounds how far along the line the point
+  // can be. Allow for rounding in these tests.
+  double scale = 0.0;
+  for (int v_idx = 0; v_idx < vsz; v_idx++)
+    scale = max(scale, verts[v_idx].len());
+  double margin = fabs(eps) + 64 * DBL_EPSILON * scale;
+  double near_dist = 2 * margin;
+
+  // cells about the size of an edge
+  double len_sum = 0.0;
+  for (int i = 0; i < esz; i++)
+    len_sum += (verts[edges[i][1]] - verts[edges[i][0]]).len();
+  double cell_sz = max(esz ? len_sum / esz : 0.0, 4 * near_dist);
+  if (!(cell_sz > 0.0))
+    cell_sz = 1.0;
+  VertexGrid grid(verts, vsz, cell_sz);
+
+  // as edge_into_geom(), with the existing edges found by key
+  std::unordered_set<uint64_t> edge_keys;
+  auto edge_key = [](int v_idx1, int v_idx2) {
+    return ((uint64_t)min(v_idx1, v_idx2) << 32) |
+           (uint32_t)max(v_idx1, v_idx2);
+  };
+  for (const auto &edge : edges)
+    edge_keys.insert(edge_key(edge[0], edge[1]));
+  auto add_edge = [&](int v_idx1, int v_idx2) {
+    if (v_idx1 != v_idx2 && edge_keys.insert(edge_key(v_idx1, v_idx2)).second)
+      geom.add_edge(make_edge(v_idx1, v_idx2), Color::invisible);
+  };
+
   vector<int> deleted_edges;
 
   // compare only existing edges and verts
@@ -1198,7 +1431,17 @@ bool mesh_verts(Geometry &geom, const double eps)
     vector<pair<double, int>> line_intersections;
     Vec3d Q0 = verts[edges[i][0]];
     Vec3d Q1 = verts[edges[i][1]];
-    for (int v_idx = 0; v_idx < vsz; v_idx++) {
+
+    // a zero length edge has no nearest points
+    Vec3d u = (Q1 - Q0).unit();
+    if (!u.is_set())
+      continue;
+    int dim = (u[0] != 0.0) ? 0 : (u[1] != 0.0) ? 1 : 2;
+    double t0 = (min(Q0[dim], Q1[dim]) - margin - Q0[dim]) / u[dim];
+    double t1 = (max(Q0[dim], Q1[dim]) + margin - Q0[dim]) / u[dim];
+
+    for (int v_idx : grid.near_line(Q0, u, min(t0, t1), max(t0, t1),
+                                    near_dist)) {
       // don't compare to self
       if (edges[i][0] == v_idx || edges[i][1] == v_idx)
         continue;
@@ -1220,14 +1463,12 @@ bool mesh_verts(Geometry &geom, const double eps)
       sort(line_intersections.begin(), line_intersections.end());
       // create edgelets from Q0 through intersection points to Q1 (using
       // indexes)
-      edge_into_geom(geom, edges[i][0], line_intersections[0].second,
-                     Color::invisible);
+      add_edge(edges[i][0], line_intersections[0].second);
       for (unsigned int k = 0; k < line_intersections.size() - 1; k++)
-        edge_into_geom(geom, line_intersections[k].second,
-                       line_intersections[k + 1].second, Color::invisible);
-      edge_into_geom(geom,
-                     line_intersections[line_intersections.size() - 1].second,
-                     edges[i][1], Color::invisible);
+        add_edge(line_intersections[k].second,
+                 line_intersections[k + 1].second);
+      add_edge(line_intersections[line_intersections.size() - 1].second,
+               edges[i][1]);
     }
   }
 
@@ -1457,85 +1698,296 @@ bool winding_rule_filter(int winding_rule_mode, int winding_rule,
   return answer;
 }
 
+// source faces that may contain points of a plane. Each source polygon is
+// entered in a grid on the two coordinates it is projected to, over its
+// bounding box widened to cover the tolerances of the inside tests
+class SourceFaceIndex {
+private:
+  double cell_sz;
+  Vec3d lo;
+  unordered_map<uint64_t, vector<int>> cells[3];
+  vector<int> all_cells; // faces in every cell
+
+  // cell coordinates are clamped, distant points share the end cells
+  uint64_t cell_coord(double coord, int dim) const
+  {
+    const double lim = (1u << 31) - 1;
+    return (uint64_t)max(0.0, min(lim, floor((coord - lo[dim]) / cell_sz)));
+  }
+
+public:
+  /// Constructor
+  /**\param polygons the polygons that will be tested, each as the only face
+   *  of a geometry
+   * \param idxs the coordinate each polygon is projected along
+   * \param triangulated the polygons are triangulated (fill type 3)
+   * \param scale the largest vertex distance from the origin
+   * \param eps a small number, coordinates differing by less are the same */
+  SourceFaceIndex(const vector<Geometry> &polygons, const vector<int> &idxs,
+                  bool triangulated, double scale, double eps)
+  {
+    int psz = polygons.size();
+    if (!psz)
+      return;
+
+    // in_segment() compares the first coordinate that varies along an edge
+    // first, so only that coordinate bounds how far along the line a point
+    // can be on the edge. Allow for rounding in the tests
+    double margin = fabs(eps) + 64 * DBL_EPSILON * scale;
+    double near_dist = 2 * margin;
+
+    vector<Vec3d> mins(psz);
+    vector<Vec3d> maxs(psz);
+    vector<double> widths(psz, near_dist);
+    double len_sum = 0.0;
+    bool lo_set = false;
+    for (int j = 0; j < psz; j++) {
+      const vector<Vec3d> &verts = polygons[j].verts();
+      if (verts.empty())
+        continue;
+      BoundBox bb(verts);
+      mins[j] = bb.get_min();
+      maxs[j] = bb.get_max();
+      if (!lo_set) {
+        lo = mins[j];
+        lo_set = true;
+      }
+      for (int d = 0; d < 3; d++)
+        lo[d] = min(lo[d], mins[j][d]);
+      int idx1 = (idxs[j] + 1) % 3;
+      int idx2 = (idxs[j] + 2) % 3;
+      len_sum += (maxs[j][idx1] - mins[j][idx1] + maxs[j][idx2] -
+                  mins[j][idx2]) /
+                 2;
+
+      // a triangulated polygon is only tested within the bounding boxes of
+      // its triangles
+      if (triangulated || polygons[j].faces().empty())
+        continue;
+
+      // a point may be taken as on an edge beyond its ends, and a ray test
+      // divides by the difference of the end coordinates
+      const vector<int> &face = polygons[j].faces()[0];
+      int fsz = face.size();
+      double width = 4 * near_dist;
+      for (int i = 0; i < fsz; i++) {
+        Vec3d diff = verts[face[(i + 1) % fsz]] - verts[face[i]];
+        double d1 = fabs(diff[idx1]);
+        double d2 = fabs(diff[idx2]);
+        if ((d1 > 0.0 && d1 < 64 * margin) || (d2 > 0.0 && d2 < 64 * margin)) {
+          width = DBL_MAX;
+          break;
+        }
+        Vec3d u = diff.unit();
+        if (!u.is_set())
+          continue;
+        int dim = (u[0] != 0.0) ? 0 : (u[1] != 0.0) ? 1 : 2;
+        width = max(width, margin / fabs(u[dim]) + 4 * near_dist);
+      }
+      widths[j] = width;
+    }
+
+    // cells about the size of a polygon
+    cell_sz = len_sum / psz;
+    if (!(cell_sz > 4 * near_dist))
+      cell_sz = max(4 * near_dist, 1.0);
+
+    const double max_cells = 1024;
+    for (int j = 0; j < psz; j++) {
+      if (polygons[j].verts().empty())
+        continue;
+      if (widths[j] == DBL_MAX) {
+        all_cells.push_back(j);
+        continue;
+      }
+      int idx1 = (idxs[j] + 1) % 3;
+      int idx2 = (idxs[j] + 2) % 3;
+      uint64_t x0 = cell_coord(mins[j][idx1] - widths[j], idx1);
+      uint64_t x1 = cell_coord(maxs[j][idx1] + widths[j], idx1);
+      uint64_t y0 = cell_coord(mins[j][idx2] - widths[j], idx2);
+      uint64_t y1 = cell_coord(maxs[j][idx2] + widths[j], idx2);
+      if ((double)(x1 - x0 + 1) * (y1 - y0 + 1) > max_cells) {
+        all_cells.push_back(j);
+        continue;
+      }
+      for (uint64_t x = x0; x <= x1; x++)
+        for (uint64_t y = y0; y <= y1; y++)
+          cells[idxs[j]][(x << 32) | y].push_back(j);
+    }
+  }
+
+  /// Add the source faces that may contain a point
+  /**\param P the point
+   * \param face_idxs the face indexes are added to this, unsorted and
+   *  possibly repeated */
+  void add_candidates(const Vec3d &P, vector<int> &face_idxs) const
+  {
+    face_idxs.insert(face_idxs.end(), all_cells.begin(), all_cells.end());
+    for (int idx = 0; idx < 3; idx++) {
+      if (cells[idx].empty())
+        continue;
+      int idx1 = (idx + 1) % 3;
+      int idx2 = (idx + 2) % 3;
+      auto it =
+          cells[idx].find((cell_coord(P[idx1], idx1) << 32) |
+                          cell_coord(P[idx2], idx2));
+      if (it != cells[idx].end())
+        face_idxs.insert(face_idxs.end(), it->second.begin(),
+                         it->second.end());
+    }
+  }
+};
+
+// the colour, winding and orientation found for a sample face
+struct sample_result {
+  Color col;
+  int winding_total;
+  bool reverse;
+};
+
 // winding_total_min, winding_total_max are changed
 void sample_colors(Geometry &sgeom, const Geometry &cgeom,
                    const vector<Normal> &original_normals,
                    const vector<int> &nonconvex_faces, int &winding_total_min,
-                   int &winding_total_max, const planar_opts &opts)
+                   int &winding_total_max, int num_threads,
+                   const planar_opts &opts)
 {
   const vector<vector<int>> &sfaces = sgeom.faces();
   const vector<vector<int>> &cfaces = cgeom.faces();
 
-  vector<Color> cols;
+  vector<Color> all_cols;
   Color average_color_all_faces;
   for (unsigned int i = 0; i < cfaces.size(); i++)
-    cols.push_back(cgeom.colors(FACES).get(i));
-  average_color_all_faces = average_color(cols, opts);
-  cols.clear();
+    all_cols.push_back(cgeom.colors(FACES).get(i));
+  average_color_all_faces = average_color(all_cols, opts);
+  all_cols.clear();
 
   Color zero_density_col = opts.zero_density_color;
   if (opts.zero_density_force_blend)
     zero_density_col = average_color_all_faces;
 
-  for (unsigned int i = 0; i < sfaces.size(); i++) {
+  // put colored faces to sample into geoms named polygon, once, with an
+  // index for their winding numbers
+  vector<Geometry> polygons(cfaces.size());
+  vector<Geometry> tpolygons; // needed for triangulation method. the sample
+                              // polygon needs to be triangulated
+  if (opts.polygon_fill_type == 3)
+    tpolygons.resize(cfaces.size());
+  vector<PolygonWinding> windings;
+  windings.reserve(cfaces.size());
+  vector<Vec3d> normals(cfaces.size());
+  vector<int> proj_idxs(cfaces.size());
+  vector<int> proj_signs(cfaces.size());
+  vector<PolygonWinding> proj_windings; // for exact inside tests
+  for (unsigned int j = 0; j < cfaces.size(); j++) {
+    vector<int> face_idxs;
+    face_idxs.push_back(j);
+    polygons[j] = faces_to_geom(cgeom, face_idxs);
+    if (opts.polygon_fill_type == 3) {
+      tpolygons[j] = polygons[j];
+      tpolygons[j].triangulate();
+    }
+    const Normal &original_normal = original_normals[j];
+    windings.push_back(PolygonWinding(
+        polygons[j], original_normal,
+        opts.find_direction && original_normal.is_hemispherical(),
+        opts.epsilon));
+    normals[j] = original_normal.unit();
+    project_using_normal(normals[j], proj_idxs[j], proj_signs[j]);
+    if (opts.exact_predicates) {
+      windings.back().set_exact();
+      proj_windings.push_back(PolygonWinding(
+          polygons[j].verts(), polygons[j].faces()[0], proj_idxs[j],
+          opts.epsilon));
+      proj_windings.back().set_exact();
+    }
+  }
+  const vector<Geometry> &test_polygons =
+      (opts.polygon_fill_type == 3) ? tpolygons : polygons;
+
+  // the sample points lie among the vertices of both geometries
+  double scale = 0.0;
+  for (const auto &v : cgeom.verts())
+    scale = max(scale, v.len());
+  for (const auto &v : sgeom.verts())
+    scale = max(scale, v.len());
+  SourceFaceIndex source_faces(test_polygons, proj_idxs,
+                               opts.polygon_fill_type == 3, scale,
+                               opts.epsilon);
+
+  // triangulate the non-convex sample faces together, to sample on the
+  // centroid(s) of the triangles (until one is hit). The first hit on a
+  // source face sets its winding number, so the triangles must be the
+  // ones made by the tesselator
+  vector<int> nonconvex_pos(sfaces.size(), -1);
+  Geometry tgeom;
+  tgeom.add_verts(sgeom.verts());
+  for (unsigned int k = 0; k < nonconvex_faces.size(); k++) {
+    nonconvex_pos[nonconvex_faces[k]] = k;
+    tgeom.add_face(sfaces[nonconvex_faces[k]]);
+  }
+  vector<int> fmap;
+  if (nonconvex_faces.size())
+    tgeom.triangulate(Color(), TESS_WINDING_NONZERO, &fmap, num_threads,
+                      false);
+
+  vector<sample_result> results(sfaces.size());
+  auto sample_face = [&](int i) {
     vector<Vec3d> points;
 
     // if the sampling face is convex
-    if (find(nonconvex_faces.begin(), nonconvex_faces.end(), (int)i) ==
-        nonconvex_faces.end())
+    int pos = nonconvex_pos[i];
+    if (pos < 0)
       points.push_back(sgeom.face_cent(i));
     else {
-      // else non-convex. need to triangulate the non-convex sample polygon to
-      // sample on centroid(s) of the triangles (until one is hit)
-      vector<int> sface_idxs;
-      sface_idxs.push_back(i);
-      Geometry spolygon = faces_to_geom(sgeom, sface_idxs);
-      spolygon.triangulate();
-      if (!spolygon.faces().size()) {
+      int tri_start = fmap[pos];
+      int tri_end = (pos + 1 < (int)fmap.size()) ? fmap[pos + 1]
+                                                 : tgeom.faces().size();
+      if (tri_start == tri_end) {
         // trangulation of a polygon of zero density leaves no faces
+        vector<int> sface_idxs;
+        sface_idxs.push_back(i);
+        Geometry spolygon = faces_to_geom(sgeom, sface_idxs);
+        spolygon.triangulate(Color(), TESS_WINDING_NONZERO, nullptr, 1);
         points.push_back(centroid(spolygon.verts()));
       }
       else {
         // when merging and it is a nonconvex face, then have to sample all the
         // centroids. else only sample one of them
-        int sz = (opts.planar_merge_type == 1) ? 1 : spolygon.faces().size();
+        int sz = (opts.planar_merge_type == 1) ? 1 : tri_end - tri_start;
         for (int k = 0; k < sz; k++)
-          points.push_back(spolygon.face_cent(k));
+          points.push_back(tgeom.face_cent(tri_start + k));
       }
     }
 
+    // only the source faces near a point can contain it, they are sampled
+    // in face order
+    vector<int> face_idxs;
+    for (auto &point : points)
+      source_faces.add_candidates(point, face_idxs);
+    sort(face_idxs.begin(), face_idxs.end());
+    face_idxs.erase(unique(face_idxs.begin(), face_idxs.end()),
+                    face_idxs.end());
+
     // accumulate winding numbers
     int winding_total = 0;
+    vector<Color> cols;
 
-    // put colored faces to sample (one at a time) into geom named polygon
-    for (unsigned int j = 0; j < cfaces.size(); j++) {
-      vector<int> face_idxs;
-      face_idxs.push_back(j);
-      Geometry polygon = faces_to_geom(cgeom, face_idxs);
-
-      Geometry tpolygon; // needed for triangulation method. the sample
-                         // polygon needs to be triangulated
-      if (opts.polygon_fill_type == 3) {
-        tpolygon = polygon;
-        tpolygon.triangulate();
-      }
-
-      Normal original_normal = original_normals[j];
-      Vec3d normal = original_normal.unit();
-
+    // sample the colored faces one at a time
+    for (int j : face_idxs) {
       // if merging we have to sample all the centroids until there is a hit.
       // otherwise k will begin and end at 0
       for (auto &point : points) {
-        bool answer = is_point_inside_polygon(
-            (opts.polygon_fill_type == 3 ? tpolygon : polygon), point, normal,
-            true, false, opts.polygon_fill_type, opts.epsilon);
+        bool answer =
+            (opts.exact_predicates)
+                ? is_point_inside_polygon_exact(
+                      test_polygons[j], point, proj_windings[j], proj_idxs[j],
+                      proj_signs[j], opts.polygon_fill_type)
+                : is_point_inside_polygon(test_polygons[j], point, normals[j],
+                                          true, false, opts.polygon_fill_type,
+                                          opts.epsilon);
         if (answer) {
-          vector<Vec3d> one_point;
-          one_point.push_back(point);
-          int winding_number = get_winding_number_polygon(
-              polygon, one_point, original_normal,
-              opts.find_direction && original_normal.is_hemispherical(),
-              opts.epsilon);
+          int winding_number = windings[j].get_winding_number(point);
 
           // if merging, find largest magnitude of winding number
           // if they are -W and +W, chose the positive
@@ -1555,26 +2007,26 @@ void sample_colors(Geometry &sgeom, const Geometry &cgeom,
     }
 
     // correct the winding number of the new face. (reverse face if necessary)
-    vector<int> face_idxs;
-    face_idxs.push_back(i);
-    Geometry polygon = faces_to_geom(sgeom, face_idxs);
-    vector<Vec3d> one_point;
-    one_point.push_back(sgeom.face_cent(i));
+    // the polygon only needs the face vertices
+    Geometry polygon;
+    vector<int> pface;
+    for (int v_idx : sfaces[i]) {
+      pface.push_back(polygon.verts().size());
+      polygon.add_vert(sgeom.verts(v_idx));
+    }
+    polygon.add_face(pface);
     Normal sface_normal(sgeom, i, opts.center, opts.epsilon);
-    int winding_number = get_winding_number_polygon(
-        polygon, one_point, sface_normal,
+    PolygonWinding sface_winding(
+        polygon, sface_normal,
         opts.find_direction && sface_normal.is_hemispherical(), opts.epsilon);
-    if ((winding_number < 0 && winding_total > 0) ||
-        (winding_number > 0 && winding_total < 0))
-      reverse(sgeom.raw_faces()[i].begin(), sgeom.raw_faces()[i].end());
+    sface_winding.set_exact(opts.exact_predicates);
+    int winding_number = sface_winding.get_winding_number(sgeom.face_cent(i));
+    results[i].reverse = (winding_number < 0 && winding_total > 0) ||
+                         (winding_number > 0 && winding_total < 0);
 
     if (opts.winding_div2)
       winding_total = (winding_total + 1) / 2;
-
-    if (winding_total < winding_total_min)
-      winding_total_min = winding_total;
-    if (winding_total > winding_total_max)
-      winding_total_max = winding_total;
+    results[i].winding_total = winding_total;
 
     if ((opts.winding_rule != INT_MAX)) {
       // if cols.size() is not zero then there were hits
@@ -1628,8 +2080,24 @@ void sample_colors(Geometry &sgeom, const Geometry &cgeom,
       col.set_brightness(-1.0 + brightness);
     }
 
-    sgeom.colors(FACES).set(i, col);
-    cols.clear();
+    results[i].col = col;
+  };
+
+  // the sample faces are independent, the geometry is only changed after
+  // they have all been sampled
+  parallel_for(sfaces.size(), sample_face, num_threads);
+
+  for (unsigned int i = 0; i < sfaces.size(); i++) {
+    if (results[i].reverse)
+      reverse(sgeom.raw_faces()[i].begin(), sgeom.raw_faces()[i].end());
+
+    int winding_total = results[i].winding_total;
+    if (winding_total < winding_total_min)
+      winding_total_min = winding_total;
+    if (winding_total > winding_total_max)
+      winding_total_max = winding_total;
+
+    sgeom.colors(FACES).set(i, results[i].col);
   }
 }
 
@@ -1641,79 +2109,117 @@ void collect_original_normals(vector<Normal> &original_normals,
     original_normals.push_back(FaceNormals[i]);
 }
 
-void blend_overlapping_faces(Geometry &geom,
-                             const vector<vector<int>> &coplanar_faces_list,
-                             const vector<Normal> &coplanar_normals,
-                             const FaceNormals &FaceNormals,
-                             const planar_opts &opts)
+// tile or merge the faces of one plane, sampling with up to num_threads
+// the winding number range of the plane is returned in winding_total_min and
+// winding_total_max
+Geometry blend_plane_faces(const Geometry &geom,
+                           const vector<int> &coplanar_faces,
+                           const Normal &coplanar_normal,
+                           const FaceNormals &FaceNormals,
+                           int &winding_total_min, int &winding_total_max,
+                           int num_threads, const planar_opts &opts)
 {
-  Geometry bgeom;
-  vector<int> deleted_faces;
+  // load a geom with color faces. keep it and copy it.
+  Geometry cgeom = faces_to_geom(geom, coplanar_faces);
+  Geometry sgeom = cgeom;
 
-  int winding_number_min = INT_MAX;
-  int winding_number_max = INT_MIN;
+  // check here for polygons within polygons
+  vector<vector<int>> connectors;
+  vector<pair<Vec3d, Vec3d>> connectors_verts;
+  if (opts.hole_detection) {
+    vector<pair<int, int>> polygon_hierarchy;
+    check_for_holes(sgeom, polygon_hierarchy, opts.epsilon);
+    if (polygon_hierarchy.size())
+      make_hole_connectors(sgeom, connectors, connectors_verts,
+                           polygon_hierarchy);
+  }
 
-  for (unsigned int i = 0; i < coplanar_faces_list.size(); i++) {
-    // load a geom with color faces. keep it and copy it.
-    Geometry cgeom = faces_to_geom(geom, coplanar_faces_list[i]);
-    Geometry sgeom = cgeom;
-
-    // check here for polygons within polygons
-    vector<vector<int>> connectors;
-    vector<pair<Vec3d, Vec3d>> connectors_verts;
-    if (opts.hole_detection) {
-      vector<pair<int, int>> polygon_hierarchy;
-      check_for_holes(sgeom, polygon_hierarchy, opts.epsilon);
-      if (polygon_hierarchy.size())
-        make_hole_connectors(sgeom, connectors, connectors_verts,
-                             polygon_hierarchy);
-    }
+  make_skeleton(sgeom);
 
-    make_skeleton(sgeom);
+  if (connectors.size())
+    add_hole_connectors(sgeom, connectors);
+  connectors.clear();
 
-    // edges with duplicate indexes can happen if faces have duplicate
-    // sequential indexes
-    delete_duplicate_index_edges(geom);
+  // duplicate vertices and edges can cause problems
+  merge_coincident_elements(sgeom, "ve", 0, opts.epsilon);
 
-    if (connectors.size())
-      add_hole_connectors(sgeom, connectors);
-    connectors.clear();
+  // sort merge can destill more duplicate indexes
+  delete_duplicate_index_edges(sgeom);
 
-    // duplicate vertices and edges can cause problems
-    merge_coincident_elements(sgeom, "ve", 0, opts.epsilon);
+  mesh_verts(sgeom, opts.epsilon);
+  mesh_edges(sgeom, opts.epsilon, opts.exact_predicates,
+             coplanar_normal.outward().unit());
 
-    // sort merge can destill more duplicate indexes
-    delete_duplicate_index_edges(sgeom);
+  // have to use vertex location for marking because indexes have been
+  // scrambled
+  if (connectors_verts.size())
+    mark_hole_connectors(sgeom, connectors_verts, opts.epsilon);
+  connectors_verts.clear();
 
-    mesh_verts(sgeom, opts.epsilon);
-    mesh_edges(sgeom, opts.epsilon);
+  vector<int> nonconvex_faces;
+  fill_in_faces(sgeom, opts.planar_merge_type, nonconvex_faces,
+                coplanar_normal.outward().unit(), opts.epsilon);
 
-    // have to use vertex location for marking because indexes have been
-    // scrambled
-    if (connectors_verts.size())
-      mark_hole_connectors(sgeom, connectors_verts, opts.epsilon);
-    connectors_verts.clear();
+  // original normals are needed for sampling colors
+  vector<Normal> original_normals;
+  collect_original_normals(original_normals, coplanar_faces, FaceNormals);
 
-    vector<int> nonconvex_faces;
-    fill_in_faces(sgeom, opts.planar_merge_type, nonconvex_faces,
-                  coplanar_normals[i].outward().unit(), opts.epsilon);
+  winding_total_min = INT_MAX;
+  winding_total_max = INT_MIN;
+  sample_colors(sgeom, cgeom, original_normals, nonconvex_faces,
+                winding_total_min, winding_total_max, num_threads, opts);
 
-    // original normals are needed for sampling colors
-    vector<Normal> original_normals;
-    collect_original_normals(original_normals, coplanar_faces_list[i],
-                             FaceNormals);
+  return sgeom;
+}
 
-    int winding_total_min = INT_MAX;
-    int winding_total_max = INT_MIN;
-    sample_colors(sgeom, cgeom, original_normals, nonconvex_faces,
-                  winding_total_min, winding_total_max, opts);
+void blend_overlapping_faces(Geometry &geom,
+                             const vector<vector<int>> &coplanar_faces_list,
+                             const vector<Normal> &coplanar_normals,
+                             const FaceNormals &FaceNormals,
+                             const planar_opts &opts)
+{
+  int sz = coplanar_faces_list.size();
 
-    if (winding_total_min < winding_number_min)
-      winding_number_min = winding_total_min;
-    if (winding_total_max > winding_number_max)
-      winding_number_max = winding_total_max;
+  // edges with duplicate indexes can happen if faces have duplicate
+  // sequential indexes
+  if (sz)
+    delete_duplicate_index_edges(geom);
 
-    bgeom.append(sgeom);
+  // the planes are independent, so they are tiled or merged in parallel and
+  // the results are joined in order. Threads left over from the planes
+  // sample within them
+  int num_threads = opts.num_threads;
+  if (num_threads <= 0)
+    num_threads = std::thread::hardware_concurrency();
+  int plane_threads = max(1, num_threads / max(sz, 1));
+  vector<Geometry> sgeoms(sz);
+  vector<int> winding_total_mins(sz);
+  vector<int> winding_total_maxs(sz);
+  parallel_for(
+      sz,
+      [&](int i) {
+        sgeoms[i] = blend_plane_faces(geom, coplanar_faces_list[i],
+                                      coplanar_normals[i], FaceNormals,
+                                      winding_total_mins[i],
+                                      winding_total_maxs[i], plane_threads,
+                                      opts);
+      },
+      opts.num_threads);
+
+  Geometry bgeom;
+  vector<int> deleted_faces;
+
+  int winding_number_min = INT_MAX;
+  int winding_number_max = INT_MIN;
+
+  for (int i = 0; i < sz; i++) {
+    if (winding_total_mins[i] < winding_number_min)
+      winding_number_min = winding_total_mins[i];
+    if (winding_total_maxs[i] > winding_number_max)
+      winding_number_max = winding_total_maxs[i];
+
+    bgeom.append(sgeoms[i]);
+    sgeoms[i].clear_all();
 
     // mark the faces in the cluster for deletion at the end
     deleted_faces.insert(deleted_faces.end(), coplanar_faces_list[i].begin(),
@@ -1822,8 +2328,9 @@ vector<int> find_end_points_vertex(const Geometry &geom,
   const vector<Vec3d> &verts = geom.verts();
 
   Geometry vgeom;
+  VertexHash vhash(vgeom, eps);
   for (int vert_indexe : vert_indexes)
-    vertex_into_geom(vgeom, verts[vert_indexe], Color::invisible, eps);
+    vertex_into_geom(vgeom, vhash, verts[vert_indexe], Color::invisible);
   vgeom.set_hull();
 
   const vector<Vec3d> &gverts = vgeom.verts();
@@ -1950,10 +2457,15 @@ void stitch_faces_on_seams(Geometry &geom, const double eps)
   vector<vector<int>> colinear_vertex_list;
   build_colinear_vertex_list(geom, colinear_vertex_list, eps);
 
-  // find what vertices are in faces
-  vector<vector<int>> vert_has_faces;
-  for (unsigned int i = 0; i < verts.size(); i++)
-    vert_has_faces.push_back(find_faces_with_vertex(faces, i));
+  // find what vertices are in faces, in one pass. the face lists are in
+  // order, as from find_faces_with_vertex()
+  vector<vector<int>> vert_has_faces(verts.size());
+  for (unsigned int i = 0; i < faces.size(); i++)
+    for (int v_idx : faces[i]) {
+      vector<int> &face_idxs = vert_has_faces[v_idx];
+      if (face_idxs.empty() || face_idxs.back() != (int)i)
+        face_idxs.push_back(i);
+    }
 
   for (auto colinear_verts : colinear_vertex_list) {
     int sz = colinear_verts.size();
@@ -1965,9 +2477,9 @@ void stitch_faces_on_seams(Geometry &geom, const double eps)
         vector<int> added_vertices;
         for (int l = j + 1; l < sz; l++) {
           int test_v_idx = colinear_verts[l];
-          vector<int> vert_has_faces_test = vert_has_faces[test_v_idx];
-          if (find(vert_has_faces_test.begin(), vert_has_faces_test.end(),
-                   face_idx) == vert_has_faces_test.end()) {
+          const vector<int> &vert_has_faces_test = vert_has_faces[test_v_idx];
+          if (!std::binary_search(vert_has_faces_test.begin(),
+                                  vert_has_faces_test.end(), face_idx)) {
             added_vertices.push_back(test_v_idx);
           }
           else {
@@ -2006,7 +2518,7 @@ void remove_in_line_vertices(Geometry &geom, const double eps)
 
   vector<int> deleted_verts;
   for (unsigned int i = 0; i < verts.size(); i++) {
-    if (find(end_points.begin(), end_points.end(), i) == end_points.end())
+    if (!std::binary_search(end_points.begin(), end_points.end(), (int)i))
       deleted_verts.push_back(i);
   }
   end_points.clear();
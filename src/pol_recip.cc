@@ -62,6 +62,7 @@ public:
   int num_iters;
   double epsilon;
   bool append;
+  int num_threads;
 
   string ifile;
   string ofile;
@@ -70,7 +71,7 @@ public:
       : ProgramOpts("pol_recip"), recip_rad(0), init_rad(0),
         recip_rad_type('x'), recip_cent_type('x'), init_cent_type('x'),
         invert(false), inf(1e15), extra_ideal_elems(true), num_iters(10000),
-        epsilon(0), append(false)
+        epsilon(0), append(false), num_threads(0)
   {
   }
 
@@ -116,6 +117,8 @@ void pr_opts::usage()
 "  -l <lim>  minimum distance change to terminate, as negative exponent\n"
 "               (default: %d giving %.0e)\n"
 "  -a        append dual to original polyhedron\n"
+"  -j <thr>  number of threads for the reciprocal vertices of larger models\n"
+"            (default: 0, use all hardware threads)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
 "\n"
 "\n", prog_name(), help_ver_text, inf, int(-log(::epsilon)/log(10) + 0.5), ::epsilon);
@@ -131,7 +134,7 @@ void pr_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hc:C:r:R:xao:n:l:iI:")) != -1) {
+  while ((c = getopt(argc, argv, ":hc:C:r:R:xao:n:l:iI:j:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -221,6 +224,12 @@ void pr_opts::process_command_line(int argc, char **argv)
       }
       break;
 
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     default:
       error("unknown command line error");
     }
@@ -285,7 +294,7 @@ int find_mid_centre(Geometry &geom, double &rad, Vec3d &cent, int n,
 }
 
 int find_can_centre(Geometry &geom, char type, double &rad, Vec3d &cent,
-                    bool invert, int n, const double &eps)
+                    bool invert, int n, const double &eps, int num_threads)
 {
   bool use_e = false;
   bool use_vf = false;
@@ -309,7 +318,7 @@ int find_can_centre(Geometry &geom, char type, double &rad, Vec3d &cent,
     rad = (1 - 2 * (rad < 0)) * rep.iedge_dist_lims().sum / e_sz;
   }
   Geometry dual;
-  get_dual(dual, geom, rad, cent);
+  get_dual(dual, geom, rad, cent, 1e20, num_threads);
   if (invert)
     dual.transform(Trans3d::translate(cent) * Trans3d::inversion() *
                    Trans3d::translate(-cent));
@@ -394,7 +403,7 @@ int find_can_centre(Geometry &geom, char type, double &rad, Vec3d &cent,
     //      (cur_cent-cent).len());
     if (fabs(cent_test) < eps && fabs(rad_test) < eps)
       break;
-    get_pol_recip_verts(dual, geom, rad, cur_cent);
+    get_pol_recip_verts(dual, geom, rad, cur_cent, 1e15, num_threads);
     if (invert)
       dual.transform(Trans3d::translate(cur_cent) * Trans3d::inversion() *
                      Trans3d::translate(-cur_cent));
@@ -489,7 +498,7 @@ Vec3d find_NOTmidcenter(const Geometry &geom)
 */
 
 void find_recip_centre(Geometry &geom, char type, double &rad, Vec3d &cent,
-                       int n, const double &eps)
+                       int n, const double &eps, int num_threads)
 {
   if (fabs(rad) < epsilon)
     rad = epsilon / 2.0;
@@ -506,25 +515,25 @@ void find_recip_centre(Geometry &geom, char type, double &rad, Vec3d &cent,
     find_mid_centre(geom, rad, cent, n, eps);
     break;
   case 'e':
-    find_can_centre(geom, 'e', rad, cent, invert, n, eps);
+    find_can_centre(geom, 'e', rad, cent, invert, n, eps, num_threads);
     break;
   case 'E':
     rad = -rad;
-    find_can_centre(geom, 'e', rad, cent, invert, n, eps);
+    find_can_centre(geom, 'e', rad, cent, invert, n, eps, num_threads);
     break;
   case 'v':
-    find_can_centre(geom, 'v', rad, cent, invert, n, eps);
+    find_can_centre(geom, 'v', rad, cent, invert, n, eps, num_threads);
     break;
   case 'V':
     rad = -rad;
-    find_can_centre(geom, 'v', rad, cent, invert, n, eps);
+    find_can_centre(geom, 'v', rad, cent, invert, n, eps, num_threads);
     break;
   case 'a':
-    find_can_centre(geom, 'a', rad, cent, invert, n, eps);
+    find_can_centre(geom, 'a', rad, cent, invert, n, eps, num_threads);
     break;
   case 'A':
     rad = -rad;
-    find_can_centre(geom, 'a', rad, cent, invert, n, eps);
+    find_can_centre(geom, 'a', rad, cent, invert, n, eps, num_threads);
     break;
   }
 }
@@ -646,7 +655,7 @@ int main(int argc, char *argv[])
   else {
     centre = opts.init_cent;
     find_recip_centre(geom, opts.recip_cent_type, opts.init_rad, centre,
-                      opts.num_iters, opts.epsilon);
+                      opts.num_iters, opts.epsilon, opts.num_threads);
   }
 
   double radius;
@@ -659,7 +668,7 @@ int main(int argc, char *argv[])
         find_recip_rad(geom, opts.recip_rad_type, centre, opts.space_verts);
 
   Geometry dual;
-  get_dual(dual, geom, radius, centre, 1.01 * opts.inf);
+  get_dual(dual, geom, radius, centre, 1.01 * opts.inf, opts.num_threads);
   if (opts.invert)
     dual.transform(Trans3d::translate(centre) * Trans3d::inversion() *
                    Trans3d::translate(-centre));
@@ -87,8 +87,90 @@ char *rep_printer::col2s(char *buf, Color col)
   return buf;
 }
 
+unsigned int rep_printer::section_props(char sec)
+{
+  switch (sec) {
+  case 'G':
+    return PROP_FACE_AREAS | PROP_CONNECTIVITY;
+  case 'F':
+    return PROP_FACE_AREAS | PROP_CONNECTIVITY | PROP_FACE_NONPLANARS;
+  case 'E':
+    return PROP_EDGE_LENGTHS;
+  case 'a':
+    return PROP_FACE_ANGLES;
+  case 'S':
+    return PROP_DIHEDRALS | PROP_SOLID_ANGLES;
+  case 'D':
+    return PROP_VERT_DISTS | PROP_FACE_DISTS | PROP_EDGE_DISTS;
+  default:
+    return PROP_NONE;
+  }
+}
+
+unsigned int rep_printer::counts_props(char cnts)
+{
+  switch (cnts) {
+  case 'F':
+    return PROP_FACE_ANGLES;
+  case 'E':
+    return PROP_EDGE_LENGTHS;
+  case 'D':
+    return PROP_DIHEDRALS;
+  case 'S':
+    return PROP_SOLID_ANGLES;
+  case 'o':
+    return PROP_VERT_CONS;
+  default:
+    return PROP_NONE;
+  }
+}
+
+unsigned int rep_printer::query_props(const string &query)
+{
+  unsigned int props = PROP_NONE;
+  for (unsigned int i = 1; i < query.size(); i++) {
+    char item = query[i];
+    if (query[0] == 'V') {
+      if (item == 'a')
+        props |= PROP_SOLID_ANGLES;
+      else if (item == 'o' || item == 'n')
+        props |= PROP_VERT_CONS;
+      else if (item == 'F')
+        props |= PROP_FACE_ANGLES;
+    }
+    else if (query[0] == 'E') {
+      if (item == 'f')
+        props |= PROP_EDGE_FACE_PAIRS;
+      else if (item == 'a')
+        props |= PROP_DIHEDRALS;
+    }
+    else if (query[0] == 'F') {
+      if (item == 'n')
+        props |= PROP_EDGE_FACE_PAIRS;
+      else if (item == 'A')
+        props |= PROP_FACE_AREAS;
+      else if (item == 'p')
+        props |= PROP_FACE_NONPLANARS;
+      else if (item == 'P')
+        props |= PROP_FACE_PERIMETERS;
+    }
+  }
+  return props;
+}
+
+void rep_printer::find_report_props(const char *sections, const char *counts)
+{
+  unsigned int props = PROP_NONE;
+  for (const char *c = sections; *c; c++)
+    props |= section_props(*c);
+  for (const char *c = counts; *c; c++)
+    props |= counts_props(*c);
+  find_props(props);
+}
+
 void rep_printer::general_sec()
 {
+  find_props(section_props('G'));
   char s1[MSG_SZ];
   fprintf(ofile, "[general]\n");
   fprintf(ofile, "num_verts = %d\n", num_verts());
@@ -150,6 +232,7 @@ void rep_printer::general_sec()
 
 void rep_printer::faces_sec()
 {
+  find_props(section_props('F'));
   char s1[MSG_SZ];
   char s2[MSG_SZ];
   int sz = num_faces();
@@ -191,6 +274,7 @@ void rep_printer::faces_sec()
 
 void rep_printer::angles_sec()
 {
+  find_props(section_props('a'));
   char s1[MSG_SZ];
   fprintf(ofile, "[angles]\n");
   fprintf(ofile, "angle_max = %s\n", d2s(s1, rad2deg(angle_lims().max)));
@@ -203,6 +287,7 @@ void rep_printer::angles_sec()
 
 void rep_printer::solid_angles_sec()
 {
+  find_props(section_props('S'));
   char s1[MSG_SZ], s2[MSG_SZ];
   fprintf(ofile, "[solid_angles]\n");
   fprintf(ofile, "dihed_angle_max = %s (%d, %d)\n",
@@ -230,6 +315,7 @@ void rep_printer::solid_angles_sec()
 
 void rep_printer::edges_sec()
 {
+  find_props(section_props('E'));
   char s1[MSG_SZ];
   fprintf(ofile, "[edges]\n");
   fprintf(ofile, "num_edges = %d\n", num_edges());
@@ -249,6 +335,7 @@ void rep_printer::edges_sec()
 
 void rep_printer::distances_sec()
 {
+  find_props(section_props('D'));
   char s1[MSG_SZ];
   fprintf(ofile, "[distances]\n");
   fprintf(ofile, "given_center = (%s)\n", v2s(s1, get_center()));
@@ -353,6 +440,7 @@ void rep_printer::vert_heights_cnts()
 
 void rep_printer::edge_lengths_cnts()
 {
+  find_props(counts_props('E'));
   char s1[MSG_SZ];
   char s2[MSG_SZ];
   fprintf(ofile, "[edge_lengths_cnts]\n");
@@ -367,6 +455,7 @@ void rep_printer::edge_lengths_cnts()
 
 void rep_printer::dihedral_angles_cnts()
 {
+  find_props(counts_props('D'));
   char s1[MSG_SZ];
   char s2[MSG_SZ];
   fprintf(ofile, "[dihedral_angles_cnts]\n");
@@ -382,6 +471,7 @@ void rep_printer::dihedral_angles_cnts()
 
 void rep_printer::solid_angles_cnts()
 {
+  find_props(counts_props('S'));
   char s1[MSG_SZ];
   char s2[MSG_SZ];
   fprintf(ofile, "[solid_angles_cnts]\n");
@@ -396,6 +486,7 @@ void rep_printer::solid_angles_cnts()
 
 void rep_printer::vert_order_cnts()
 {
+  find_props(counts_props('o'));
   fprintf(ofile, "[vert_order_cnts]\n");
   map<int, int>::iterator mi;
   map<int, int> cnts;
@@ -431,6 +522,7 @@ void rep_printer::face_sides_cnts()
 
 void rep_printer::face_angles_cnts()
 {
+  find_props(counts_props('F'));
   char s1[MSG_SZ];
   fprintf(ofile, "[face_angles_cnts]\n");
   const map<vector<double>, int, AngleVectLess> &face_angs =
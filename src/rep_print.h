@@ -86,6 +86,15 @@ public:
     extra_f_sz += f_sz;
   }
 
+  // properties used by a section, by counts, and by an element query
+  // string, to find together with find_props()
+  static unsigned int section_props(char sec);
+  static unsigned int counts_props(char cnts);
+  static unsigned int query_props(const std::string &query);
+
+  // find the properties of all the sections and counts together
+  void find_report_props(const char *sections, const char *counts);
+
   void general_sec();
   void faces_sec();
   void edges_sec();
@@ -27,6 +27,7 @@
 */
 
 #include <ctype.h>
+#include <functional>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -44,12 +45,13 @@ public:
   int num_divs;
   bool stagger;
   bool pts_at_poles;
+  bool stream;
 
   string ofile;
 
   sphc_opts()
       : ProgramOpts("sph_ring"), num_rings(10), num_divs(0), stagger(false),
-        pts_at_poles(true)
+        pts_at_poles(true), stream(false)
   {
   }
   void process_command_line(int argc, char **argv);
@@ -72,6 +74,8 @@ void sphc_opts::usage()
 "%s"
 "  -s        stagger placement of balls between cirles\n"
 "  -x        don't place points at the two poles\n"
+"  -S        stream the output, writing the points as they are made rather\n"
+"            than holding them in memory (for very large numbers of points)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
 "\n"
 "\n", prog_name(), help_ver_text);
@@ -85,7 +89,7 @@ void sphc_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hsxo:")) != -1) {
+  while ((c = getopt(argc, argv, ":hsxSo:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -98,6 +102,10 @@ void sphc_opts::process_command_line(int argc, char **argv)
       pts_at_poles = false;
       break;
 
+    case 'S':
+      stream = true;
+      break;
+
     case 'o':
       ofile = optarg;
       break;
@@ -123,33 +131,47 @@ void sphc_opts::process_command_line(int argc, char **argv)
     error("too many arguments");
 }
 
-void make_sph_rings(Geometry &geom, int rings, int divs, bool stagger,
-                    bool pts_at_poles)
+double ring_num_pts(int ring, int rings, int divs)
+{
+  if (divs)
+    return divs;
+  double vert_ang_inc = M_PI / (rings + 1);
+  double ball_dia = sqrt(2 - 2 * cos(vert_ang_inc));
+  double rad = sin(ring * vert_ang_inc);
+  double val = (2 * rad * rad - ball_dia * ball_dia) / (2 * rad * rad);
+  if (val < -1 || val > 1)
+    return 1;
+  else
+    return floor(2 * M_PI / acos(safe_for_trig(val)));
+}
+
+long count_sph_rings(int rings, int divs, bool pts_at_poles)
+{
+  long num_pts = 2 * pts_at_poles;
+  for (int i = 1; i < rings + 1; i++)
+    num_pts += (long)ceil(ring_num_pts(i, rings, divs));
+  return num_pts;
+}
+
+void make_sph_rings(const std::function<void(const Vec3d &)> &add_pt,
+                    int rings, int divs, bool stagger, bool pts_at_poles)
 {
   if (pts_at_poles) {
-    geom.add_vert(Vec3d(0, 1, 0));
-    geom.add_vert(Vec3d(0, -1, 0));
+    add_pt(Vec3d(0, 1, 0));
+    add_pt(Vec3d(0, -1, 0));
   }
   double horz_stagger = 0;
   double vert_ang_inc = M_PI / (rings + 1);
-  double ball_dia = sqrt(2 - 2 * cos(vert_ang_inc));
   for (int i = 1; i < rings + 1; i++) {
-    double num_pts = divs;
+    double num_pts = ring_num_pts(i, rings, divs);
     double vert_ang = i * vert_ang_inc;
     double rad = sin(vert_ang);
-    if (!divs) {
-      double val = (2 * rad * rad - ball_dia * ball_dia) / (2 * rad * rad);
-      if (val < -1 || val > 1)
-        num_pts = 1;
-      else
-        num_pts = floor(2 * M_PI / acos(safe_for_trig(val)));
-    }
 
     double horz_ang_inc = 2 * M_PI / num_pts;
     for (int j = 0; j < num_pts; j++) {
       double horz_ang = j * horz_ang_inc + horz_stagger;
       Vec3d P(rad * sin(horz_ang), cos(vert_ang), rad * cos(horz_ang));
-      geom.add_vert(P);
+      add_pt(P);
     }
 
     if (stagger)
@@ -162,9 +184,21 @@ int main(int argc, char **argv)
   sphc_opts opts;
   opts.process_command_line(argc, argv);
 
+  if (opts.stream) {
+    OffStreamWriter writer;
+    opts.print_status_or_exit(writer.open(opts.ofile));
+    writer.write_header(
+        count_sph_rings(opts.num_rings, opts.num_divs, opts.pts_at_poles), 0);
+    make_sph_rings([&](const Vec3d &P) { writer.write_vert(P); },
+                   opts.num_rings, opts.num_divs, opts.stagger,
+                   opts.pts_at_poles);
+    opts.print_status_or_exit(writer.close());
+    return 0;
+  }
+
   Geometry geom;
-  make_sph_rings(geom, opts.num_rings, opts.num_divs, opts.stagger,
-                 opts.pts_at_poles);
+  make_sph_rings([&](const Vec3d &P) { geom.add_vert(P); }, opts.num_rings,
+                 opts.num_divs, opts.stagger, opts.pts_at_poles);
 
   opts.write_or_error(geom, opts.ofile);
 
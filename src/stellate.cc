@@ -61,6 +61,7 @@ public:
   string output_parts;
   bool move_to_front;
   int projection_width;
+  bool exact_predicates;
 
   char vertex_coloring_method;
   char edge_coloring_method;
@@ -74,16 +75,18 @@ public:
   int face_opacity;
 
   double epsilon;
+  int num_threads;
 
   stellate_opts()
       : ProgramOpts("stellate"), merge_faces(true),
         remove_inline_vertices(true), split_pinched(true), resolve_faces(false),
         remove_multiples(false), rebuild_compound_model(false),
         output_parts("s"), move_to_front(false), projection_width(500),
-        vertex_coloring_method('\0'), edge_coloring_method('\0'),
-        face_coloring_method('d'), vertex_color(Color::invisible),
-        edge_color(Color::invisible), face_color(Color()),
-        map_string("compound"), face_opacity(-1), epsilon(0)
+        exact_predicates(false), vertex_coloring_method('\0'),
+        edge_coloring_method('\0'), face_coloring_method('d'),
+        vertex_color(Color::invisible), edge_color(Color::invisible),
+        face_color(Color()), map_string("compound"), face_opacity(-1),
+        epsilon(0), num_threads(0)
   {
   }
   void process_command_line(int argc, char **argv);
@@ -119,6 +122,10 @@ void stellate_opts::usage()
 "  -w <int>  width to project stellation diagram (default: 500)\n"
 "  -l <lim>  minimum distance for unique vertex locations as negative exponent\n"
 "               (default: %d giving %.0e)\n"
+"  -x        exact predicates, decide where diagram lines cross exactly\n"
+"               (-l still limits vertex locations)\n"
+"  -j <thr>  number of threads for making the stellation diagrams\n"
+"               (default: 0, use all hardware threads)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
 "\nColoring Options (run 'off_util -H color' for help on color formats)\n"
 "  -F <opt>  face coloring method. d - from diagram, s - symmetry (default: d)\n"
@@ -146,7 +153,7 @@ void stellate_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hf:s:MISRDrzw:O:V:E:F:T:m:l:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":hf:s:MISRDrzw:O:V:E:F:T:m:l:xj:o:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -248,6 +255,16 @@ void stellate_opts::process_command_line(int argc, char **argv)
       }
       break;
 
+    case 'x':
+      exact_predicates = true;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     case 'o':
       ofile = optarg;
       break;
@@ -372,15 +389,13 @@ void color_stellation(Geometry &stellation, const stellate_opts &opts)
       clrng.e_face_color();
   }
   else if (opts.edge_coloring_method == 'C') {
-    auto efpairs = stellation.get_edge_face_pairs(false);
-    for (const auto &edge : stellation.edges()) {
-      vector<int> faces = efpairs[edge];
-      int i = find_edge_in_edge_list(stellation.edges(), edge);
-      if (i > -1) {
-        if (!(stellation.colors(EDGES).get(i)).is_invisible()) {
-          int connections = faces.size();
-          stellation.colors(EDGES).set(i, cmap->get_col(connections));
-        }
+    EdgeFaces ef(stellation);
+    for (unsigned int i = 0; i < stellation.edges().size(); i++) {
+      const vector<int> &edge = stellation.edges(i);
+      if (!(stellation.colors(EDGES).get(i)).is_invisible()) {
+        int e_idx = ef.find(edge[0], edge[1]);
+        int connections = (e_idx >= 0) ? ef.num_faces(e_idx) : 0;
+        stellation.colors(EDGES).set(i, cmap->get_col(connections));
       }
     }
   }
@@ -595,6 +610,7 @@ int main(int argc, char *argv[])
   vector<vector<int>> idx_lists(sz);
 
   bool display_diagrams_only = true;
+  vector<int> stellation_face_idxs;
   for (int i = 0; i < sz; i++) {
     opts.print_status_or_exit(
         read_idx_list((char *)opts.diagram_list_strings[i].c_str(),
@@ -615,11 +631,16 @@ int main(int argc, char *argv[])
     if (idx_lists[i].size() > 1)
       display_diagrams_only = false;
 
-    // construct the diagrams
-    if (!diagrams[stellation_face_idx].verts().size())
-      diagrams[stellation_face_idx] =
-          make_stellation_diagram(geom, stellation_face_idx, opts.sym_str,
-                                  opts.projection_width, opts.epsilon);
+    stellation_face_idxs.push_back(stellation_face_idx);
+  }
+
+  // construct the diagrams
+  make_stellation_diagrams(diagrams, geom, stellation_face_idxs, opts.sym_str,
+                           opts.projection_width, opts.epsilon,
+                           opts.exact_predicates, opts.num_threads);
+
+  for (int i = 0; i < sz; i++) {
+    int stellation_face_idx = idx_lists[i][0];
 
     // check face index range. start from 1 since 0 is a placeholder for
     // stellation face
@@ -84,8 +84,11 @@ public:
 
   double epsilon;
 
-  symmetro_opts()
-      : ProgramOpts("symmetro"), sym('\0'), p(0), q(0), dihedral_n(0),
+  string batch_file;
+  int num_threads;
+
+  symmetro_opts(const string &prog_name = "symmetro")
+      : ProgramOpts(prog_name), sym('\0'), p(0), q(0), dihedral_n(0),
         sym_id_no(1), sym_mirror('\0'), vert_z(INT_MAX), rotation(0.0),
         rotation_as_increment(0.0), add_pi(false), rotation_axis(-1),
         angle_between_axes(DBL_MAX), scale_axis(-1), convex_hull(0), offset(0),
@@ -94,7 +97,7 @@ public:
         vert_col(Color(255, 215, 0)),    // gold
         edge_col(Color(211, 211, 211)),  // lightgrey
         frame_col(Color(135, 206, 235)), // skyblue3
-        epsilon(0)
+        epsilon(0), num_threads(0)
   {
   }
 
@@ -169,6 +172,12 @@ void symmetro_opts::usage()
 "  -l <lim>  minimum distance for unique vertex locations as negative exponent\n"
 "               (default: %d giving %.0e)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
+"  -B <file> batch mode. Read the options of this help, less -v, for one\n"
+"               model per line of file ('-' for standard input, '#' starts a\n"
+"               comment). Models are made in parallel and written to the -o\n"
+"               of their line, or else to a file numbered by model based on\n"
+"               the -o of the command line (default: symmetro.off)\n"
+"  -j <thr>  number of threads for batch mode (default: 0, use all cores)\n"
 "\nColoring Options (run 'off_util -H color' for help on color formats)\n"
 "  -V <col>  vertex color (default: gold)\n"
 "  -E <col>  edge color   (default: lightgray)\n"
@@ -231,7 +240,8 @@ void symmetro_opts::process_command_line(int argc, char **argv)
     scale.push_back(DBL_MAX);
 
   while ((c = getopt(argc, argv,
-                     ":hk:t:m:s:c:M:a:r:A:C:q:O:xvf:Q:V:E:DT:l:o:")) != -1) {
+                     ":hk:t:m:s:c:M:a:r:A:C:q:O:xvf:Q:V:E:DT:l:o:"
+                     "B:j:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -935,6 +945,16 @@ void symmetro_opts::process_command_line(int argc, char **argv)
       ofile = optarg;
       break;
 
+    case 'B':
+      batch_file = optarg;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     default:
       error("unknown command line error");
     }
@@ -943,6 +963,10 @@ void symmetro_opts::process_command_line(int argc, char **argv)
   if (argc - optind > 0)
     error("too many arguments");
 
+  // batch mode, the model options are processed for each line
+  if (batch_file.length())
+    return;
+
   if (!mode)
     error("one of -k, -t, -s, -c must be specified");
 
@@ -1938,10 +1962,8 @@ void unitize_edges( vector<Geometry> &pgeom )
 }
 */
 
-int main(int argc, char *argv[])
+Status make_symmetro(Geometry &geom, symmetro_opts &opts)
 {
-  symmetro_opts opts;
-  opts.process_command_line(argc, argv);
   char errmsg[MSG_SZ];
 
   symmetro s;
@@ -1979,14 +2001,12 @@ int main(int argc, char *argv[])
   }
   for (int i = 0; i < (int)opts.scale.size(); i++) {
     if ((opts.scale[i] != DBL_MAX) && (i != idx[0] && i != idx[1]))
-      opts.error(
-          msg_str("polygon '%d' is not generated so cannot be used for scaling",
-                  i),
-          'r');
+      return Status::error(msg_str("option -r: polygon '%d' is not generated "
+                                   "so cannot be used for scaling", i));
   }
   for (int i = 0; i < (int)opts.scale.size(); i++) {
     if (opts.scale[i] < 0)
-      opts.error("scale cannot be negative", 'r');
+      return Status::error("option -r: scale cannot be negative");
   }
   if (opts.mode == 's' || opts.mode == 'c') {
     for (int i = 0; i < (int)opts.scale.size(); i++) {
@@ -2007,12 +2027,12 @@ int main(int argc, char *argv[])
     opts.rotation_axis = idx[0];
   // check rotation axis specifier for zero
   if (opts.mode != 'k' && opts.rotation_axis == 2)
-    opts.error("only 0 and 1 are valid for axis when not using option -k", 'a');
+    return Status::error("option -a: only 0 and 1 are valid for axis when "
+                         "not using option -k");
   else if (opts.rotation_axis != idx[0] && opts.rotation_axis != idx[1])
-    opts.error(
-        msg_str("polygon '%d' is not generated so cannot be used for rotation",
-                opts.rotation_axis),
-        'a');
+    return Status::error(msg_str("option -a: polygon '%d' is not generated "
+                                 "so cannot be used for rotation",
+                                 opts.rotation_axis));
   // swap axes if we are rotating the axis 1 polygon
   // if -k and p == q then alway use axis 0
   bool swap_axes = false;
@@ -2047,13 +2067,13 @@ int main(int argc, char *argv[])
 
   // fill symmetry axes here
   if (s.fill_sym_vec(opts.mode, errmsg))
-    opts.error(errmsg);
+    return Status::error(errmsg);
 
   vector<Geometry> pgeom = s.calc_polygons(
       opts.mode, opts.rotation, opts.rotation_as_increment, opts.add_pi,
       swap_axes, opts.offset, opts.verbose, opts.angle_between_axes, errmsg);
   if (*errmsg)
-    opts.error(errmsg);
+    return Status::error(errmsg);
 
   // if ( opts.d_substitute[0] || opts.d_substitute[1] )
   //   unitize_edges( pgeom );
@@ -2086,7 +2106,6 @@ int main(int argc, char *argv[])
     fprintf(stderr, "\n");
   }
 
-  Geometry geom;
   geom = build_geom(pgeom, opts);
 
   if (opts.frame_elems.length()) {
@@ -2095,6 +2114,28 @@ int main(int argc, char *argv[])
     geom.append(geom_frame);
   }
 
+  return Status::ok();
+}
+
+int main(int argc, char *argv[])
+{
+  symmetro_opts opts;
+  opts.process_command_line(argc, argv);
+
+  if (opts.batch_file.length()) {
+    auto check_opts = [](symmetro_opts &item) {
+      if (item.batch_file.length())
+        item.error("batch mode is not valid in a batch line", 'B');
+      if (item.verbose)
+        item.error("verbose output is not valid in batch mode", 'v');
+    };
+    return make_batch<symmetro_opts>(opts, opts.batch_file, opts.ofile,
+                                     opts.num_threads, make_symmetro,
+                                     check_opts);
+  }
+
+  Geometry geom;
+  opts.print_status_or_exit(make_symmetro(geom, opts));
   opts.write_or_error(geom, opts.ofile);
 
   return 0;
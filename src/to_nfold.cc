@@ -608,11 +608,12 @@ int cyc_geom::make_geom(Geometry *o_geom, int to_n, int to_d)
     for (auto si = f_equivs[i].begin(); si != f_equivs[i].end(); ++si)
       f2equiv[*si] = i;
 
-  auto e2f = geom->get_edge_face_pairs(false);
-  for (const auto &kp : e2f) {
-    if (is_axial_edge(kp.first, *geom, eps) && kp.second.size() == 2 &&
-        f2equiv[kp.second[0]] == f2equiv[kp.second[1]]) {
-      cyc_chain cyc_c(*geom, kp.first, 1, eps);
+  EdgeFaces ef(*geom);
+  for (int e = 0; e < ef.num_edges(); e++) {
+    if (ef.num_faces(e) == 2 &&
+        f2equiv[ef.edge_face(e, 0)] == f2equiv[ef.edge_face(e, 1)] &&
+        is_axial_edge(ef.edge(e), *geom, eps)) {
+      cyc_chain cyc_c(*geom, ef.edge(e), 1, eps);
       chains.push_back(cyc_c);
     }
   }
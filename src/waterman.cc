@@ -32,7 +32,9 @@
 #include <cmath>
 #include <cstdlib> // avoid ambiguities with std::abs(long) on OSX
 #include <ctype.h>
+#include <functional>
 #include <limits>
+#include <map>
 #include <stdio.h>
 #include <string>
 #include <vector>
@@ -42,6 +44,7 @@
 
 using std::string;
 using std::vector;
+using std::map;
 using std::pair;
 using std::make_pair;
 
@@ -86,6 +89,7 @@ public:
   Vec3d center;
   int method;
   bool fill;
+  bool stream;
   bool verbose;
   long scale;
   bool tester_defeat;
@@ -101,7 +105,8 @@ public:
 
   waterman_opts()
       : ProgramOpts("waterman"), lattice_type(-1), radius(0), R_squared(0),
-        origin_based(true), method(1), fill(false), verbose(false), scale(0),
+        origin_based(true), method(1), fill(false), stream(false),
+        verbose(false), scale(0),
         tester_defeat(false), convex_hull(true), add_hull(false),
         color_method('\0'), face_opacity(-1), epsilon(0)
   {
@@ -128,6 +133,8 @@ void waterman_opts::usage()
 "  -m <mthd> 1 - sphere-ray intersection  2 - z guess (default: 1)\n"
 "  -C <opt>  c - convex hull only, i - keep interior, s - supress (default: c)\n"
 "  -f        fill interior points (not for -C c)\n"
+"  -S        stream the fill points to the output as they are made, rather\n"
+"            than holding them in memory (for very large fills)\n"
 "  -t        defeat computational error testing for sphere-ray method\n"
 "  -v        verbose output (on computational errors)\n"
 "  -l <lim>  minimum distance for unique vertex locations as negative exponent\n"
@@ -160,7 +167,7 @@ void waterman_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hr:q:m:ftvC:V:E:F:Z:T:l:o:")) != -1) {
+  while ((c = getopt(argc, argv, ":hr:q:m:fStvC:V:E:F:Z:T:l:o:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -215,6 +222,10 @@ void waterman_opts::process_command_line(int argc, char **argv)
       fill = true;
       break;
 
+    case 'S':
+      stream = true;
+      break;
+
     case 't':
       tester_defeat = true;
       break;
@@ -753,52 +764,74 @@ void z_guess_waterman(Geometry &geom, const int lattice_type,
   // fprintf(stderr,"Total errors amount: %ld\n",total_amount);
 }
 
-// fill interior points
-Geometry fill_interior(const Geometry &geom, const int lattice_type)
+// minimum and maximum z for each x,y of the model points
+map<pair<long, long>, pair<long, long>> fill_z_ranges(const Geometry &geom)
 {
   const vector<Vec3d> &verts = geom.verts();
 
-  map<pair<long, long>, long> min_z_vert;
-  map<pair<long, long>, long> max_z_vert;
-
-  map<pair<long, long>, long>::iterator it;
+  map<pair<long, long>, pair<long, long>> z_ranges;
   for (long i = 0; i < (long)verts.size(); i++) {
     long x = lround(verts[i][0]);
     long y = lround(verts[i][1]);
     long z = lround(verts[i][2]);
 
-    pair<long, long> key = make_pair(x, y);
-
     // initialize values
-    it = min_z_vert.find(key);
-    if (it == min_z_vert.end())
-      min_z_vert[key] = LONG_MAX;
-    it = max_z_vert.find(key);
-    if (it == max_z_vert.end())
-      max_z_vert[key] = LONG_MIN;
+    auto it = z_ranges.emplace(make_pair(x, y), make_pair(LONG_MAX, LONG_MIN))
+                  .first;
 
     // find minimum z and maximum z for an x,y
-    if (z < min_z_vert[key])
-      min_z_vert[key] = z;
-    if (z > max_z_vert[key])
-      max_z_vert[key] = z;
+    if (z < it->second.first)
+      it->second.first = z;
+    if (z > it->second.second)
+      it->second.second = z;
   }
 
-  Geometry fill;
-  vector<Vec3d> &fill_verts = fill.raw_verts();
+  return z_ranges;
+}
 
-  for (auto const &key : min_z_vert) {
+// fill interior points
+void fill_interior(const map<pair<long, long>, pair<long, long>> &z_ranges,
+                   const int lattice_type,
+                   const std::function<void(const Vec3d &)> &add_pt)
+{
+  for (auto const &key : z_ranges) {
     long x = key.first.first;
     long y = key.first.second;
-    long z_min = key.second;
-    long z_max = max_z_vert[make_pair(x, y)];
+    long z_min = key.second.first;
+    long z_max = key.second.second;
     for (long i = z_min + 1; i < z_max; i++) {
       if (!lattice_type || valid_point(lattice_type, x, y, i))
-        fill_verts.push_back(Vec3d(x, y, i));
+        add_pt(Vec3d(x, y, i));
     }
   }
+}
 
-  return fill;
+// write the model followed by the fill points, without holding the fill
+// points in memory
+Status write_with_fill(const string &file_name, const Geometry &geom,
+                       const map<pair<long, long>, pair<long, long>> &z_ranges,
+                       const int lattice_type, const Color &fill_col)
+{
+  long num_fill = 0;
+  fill_interior(z_ranges, lattice_type, [&](const Vec3d &) { num_fill++; });
+  long num_fill_elems = fill_col.is_set() ? num_fill : 0;
+
+  OffStreamWriter writer;
+  Status stat = writer.open(file_name);
+  if (stat.is_error())
+    return stat;
+
+  long num_verts = geom.verts().size();
+  writer.write_header(num_verts + num_fill,
+                      OffStreamWriter::count_elems(geom) + num_fill_elems);
+  writer.write_verts(geom);
+  fill_interior(z_ranges, lattice_type,
+                [&](const Vec3d &P) { writer.write_vert(P); });
+  writer.write_elems(geom);
+  for (long i = 0; i < num_fill_elems; i++)
+    writer.write_vert_elem(num_verts + i, fill_col);
+
+  return writer.close();
 }
 
 int main(int argc, char *argv[])
@@ -821,13 +854,18 @@ int main(int argc, char *argv[])
 
   // interior filling
   Geometry fill_verts;
+  map<pair<long, long>, pair<long, long>> fill_ranges;
   if (opts.fill) {
     if (opts.verbose)
       fprintf(stderr, "filling interior\n");
 
-    fill_verts = fill_interior(geom, opts.lattice_type);
-    if (opts.fill_col.is_set())
-      Coloring(&fill_verts).v_one_col(opts.fill_col);
+    fill_ranges = fill_z_ranges(geom);
+    if (!opts.stream) {
+      fill_interior(fill_ranges, opts.lattice_type,
+                    [&](const Vec3d &P) { fill_verts.add_vert(P); });
+      if (opts.fill_col.is_set())
+        Coloring(&fill_verts).v_one_col(opts.fill_col);
+    }
   }
 
   // convex hull and coloring
@@ -861,14 +899,21 @@ int main(int argc, char *argv[])
   if (opts.vert_col.is_set())
     Coloring(&geom).v_one_col(opts.vert_col);
 
-  // append fill points
-  if (opts.fill)
-    geom.append(fill_verts);
-
   if (opts.verbose)
     fprintf(stderr, "writing output\n");
 
-  opts.write_or_error(geom, opts.ofile);
+  if (opts.stream) {
+    // fill points are streamed after the model
+    opts.print_status_or_exit(write_with_fill(
+        opts.ofile, geom, fill_ranges, opts.lattice_type, opts.fill_col));
+  }
+  else {
+    // append fill points
+    if (opts.fill)
+      geom.append(fill_verts);
+
+    opts.write_or_error(geom, opts.ofile);
+  }
 
   if (opts.verbose)
     fprintf(stderr, "done!\n");
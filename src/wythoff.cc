@@ -57,10 +57,13 @@ public:
   bool quiet;
   string ifile;
   string ofile;
+  string batch_file;
+  int num_threads;
 
-  wy_opts()
-      : ProgramOpts("wythoff"), input_is_meta(false), add_meta(false),
-        face_ht(0.0), reverse(false), color_with_value(true), quiet(false)
+  wy_opts(const string &prog_name = "wythoff")
+      : ProgramOpts(prog_name), input_is_meta(false), add_meta(false),
+        face_ht(0.0), reverse(false), color_with_value(true), quiet(false),
+        num_threads(0)
   {
   }
 
@@ -115,6 +118,12 @@ void wy_opts::usage()
 "  -f <ht>   lift the face centres by this height\n"
 "  -q        quiet, don't print report\n"
 "  -o <file> write output to file (default: write to standard output)\n"
+"  -B <file> batch mode. Read the options above, with input_file, for one\n"
+"            model per line of file ('-' for standard input, '#' starts a\n"
+"            comment). Models are made in parallel and written to the -o of\n"
+"            their line, or else to a file numbered by model based on the -o\n"
+"            of the command line (default: wythoff.off)\n"
+"  -j <thr>  number of threads for batch mode (default: 0, use all cores)\n"
 "\n"
 "\n", prog_name(), help_ver_text);
 }
@@ -127,7 +136,7 @@ void wy_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":ho:p:c:f:Rr:Miuqa")) != -1) {
+  while ((c = getopt(argc, argv, ":ho:p:c:f:Rr:MiuqaB:j:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -180,6 +189,16 @@ void wy_opts::process_command_line(int argc, char **argv)
       ofile = optarg;
       break;
 
+    case 'B':
+      batch_file = optarg;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     default:
       error("unknown command line error");
     }
@@ -192,6 +211,9 @@ void wy_opts::process_command_line(int argc, char **argv)
 
   if (argc - optind == 1)
     ifile = argv[optind];
+
+  if (batch_file.length() && ifile.length())
+    error("not valid with batch mode, give it in a batch line", "input_file");
 }
 
 void color_meta(Geometry &meta)
@@ -206,13 +228,13 @@ void color_meta(Geometry &meta)
   clrng.v_one_col(Color::invisible);
 }
 
-int main(int argc, char *argv[])
+Status make_wythoff(Geometry &ogeom, wy_opts &opts)
 {
-  wy_opts opts;
-  opts.process_command_line(argc, argv);
-
   Geometry geom;
-  opts.read_or_error(geom, opts.ifile);
+  Status stat = geom.read(opts.ifile);
+  if (stat.is_error())
+    return stat;
+  opts.print_status_or_exit(stat);
 
   GeometryInfo info(geom);
   bool orientable = true;
@@ -227,8 +249,12 @@ int main(int argc, char *argv[])
   }
 
   Tiling &tiling = opts.tiling;
-  if (opts.relabel != "")
-    opts.print_status_or_exit(tiling.relabel_pattern(opts.relabel), 'm');
+  if (opts.relabel != "") {
+    stat = tiling.relabel_pattern(opts.relabel);
+    if (stat.is_error())
+      return Status::error("option -m: " + stat.msg());
+    opts.print_status_or_exit(stat, 'm');
+  }
   if (opts.reverse) {
     tiling.reverse_pattern();
     opts.warning("base polyhedron is not oriented: reverse has no effect", 'R');
@@ -237,22 +263,25 @@ int main(int argc, char *argv[])
   if (!orientable)
     tiling.start_everywhere();
 
-  Status stat = tiling.set_geom(geom, opts.input_is_meta, opts.face_ht);
+  stat = tiling.set_geom(geom, opts.input_is_meta, opts.face_ht);
   if (stat.is_error())
-    opts.print_status_or_exit(stat, 'm');
-  Geometry ogeom;
+    return Status::error("option -m: " + stat.msg());
   vector<int> tile_counts;
-  opts.print_status_or_exit(tiling.make_tiling(ogeom, &tile_counts));
+  stat = tiling.make_tiling(ogeom, &tile_counts);
+  if (stat.is_error())
+    return stat;
+  opts.print_status_or_exit(stat);
   if (!orientable)
     merge_coincident_elements(ogeom, "f");
 
   if (!opts.quiet) {
-    fprintf(stderr, "\n");
-    fprintf(stderr, "Tiling pattern: %s\n", tiling.pattern_string().c_str());
-    fprintf(stderr, "Tile Counts:\n");
+    string report = "\n";
+    report += "Tiling pattern: " + tiling.pattern_string() + "\n";
+    report += "Tile Counts:\n";
     for (unsigned int i = 0; i < tile_counts.size(); i++)
-      fprintf(stderr, "  %-4u: %d\n", i, tile_counts[i]);
-    fprintf(stderr, "\n");
+      report += msg_str("  %-4u: %d\n", i, tile_counts[i]);
+    report += "\n";
+    opts.report(report);
   }
 
   if (opts.color_with_value) {
@@ -273,6 +302,27 @@ int main(int argc, char *argv[])
     ogeom.append(meta);
   }
 
+  return Status::ok();
+}
+
+int main(int argc, char *argv[])
+{
+  wy_opts opts;
+  opts.process_command_line(argc, argv);
+
+  if (opts.batch_file.length()) {
+    auto check_opts = [](wy_opts &item) {
+      if (item.batch_file.length())
+        item.error("batch mode is not valid in a batch line", 'B');
+      if (!item.ifile.length())
+        item.error("input file must be given in a batch line", "input_file");
+    };
+    return make_batch<wy_opts>(opts, opts.batch_file, opts.ofile,
+                               opts.num_threads, make_wythoff, check_opts);
+  }
+
+  Geometry ogeom;
+  opts.print_status_or_exit(make_wythoff(ogeom, opts));
   opts.write_or_error(ogeom, opts.ofile);
 
   return 0;
@@ -58,11 +58,13 @@ public:
   bool fix_connect;
 
   string ofile;
+  string batch_file;
+  int num_threads;
 
-  jb_opts()
-      : ProgramOpts("jitterbug"), stage(0.0), faces(f_equ | f_oth),
+  jb_opts(const string &prog_name = "jitterbug")
+      : ProgramOpts(prog_name), stage(0.0), faces(f_equ | f_oth),
         cycle_type('f'), lat_size(1), tri_fix(false), tri_top(false),
-        fix_connect(false)
+        fix_connect(false), num_threads(0)
   {
   }
 
@@ -102,6 +104,12 @@ void jb_opts::usage()
 "  -t        fix an opposing pair of triangles, stopping them from rotating\n"
 "  -T        rotate so equilateral triangle is on top (suports -t)\n"
 "  -o <file> write output to file (default: write to standard output)\n"
+"  -B <file> batch mode. Read the options above, with cycle_stage, for one\n"
+"            model per line of file ('-' for standard input, '#' starts a\n"
+"            comment). Models are made in parallel and written to the -o of\n"
+"            their line, or else to a file numbered by model based on the -o\n"
+"            of the command line (default: jitterbug.off)\n"
+"  -j <thr>  number of threads for batch mode (default: 0, use all cores)\n"
 "\n"
 "\n", prog_name(), help_ver_text);
 }
@@ -114,7 +122,7 @@ void jb_opts::process_command_line(int argc, char **argv)
 
   handle_long_opts(argc, argv);
 
-  while ((c = getopt(argc, argv, ":hf:c:l:tTro:")) != -1) {
+  while ((c = getopt(argc, argv, ":hf:c:l:tTro:B:j:")) != -1) {
     if (common_opts(c, optopt))
       continue;
 
@@ -171,6 +179,16 @@ void jb_opts::process_command_line(int argc, char **argv)
       ofile = optarg;
       break;
 
+    case 'B':
+      batch_file = optarg;
+      break;
+
+    case 'j':
+      print_status_or_exit(read_int(optarg, &num_threads), c);
+      if (num_threads < 0)
+        error("number of threads cannot be negative", c);
+      break;
+
     default:
       error("unknown command line error");
     }
@@ -181,6 +199,9 @@ void jb_opts::process_command_line(int argc, char **argv)
     exit(1);
   }
 
+  if (batch_file.length() && argc - optind == 1)
+    error("not valid with batch mode, give it in a batch line", "cycle_stage");
+
   stage = 0.0;
   if (argc - optind == 1) {
     print_status_or_exit(read_double(argv[optind], &stage), c);
@@ -384,17 +405,33 @@ void lattice_trans(Geometry &lat_jb, double cyc_val, bool tri_fix, bool tri_top)
   lat_jb.transform(trans);
 }
 
-int main(int argc, char *argv[])
+Status make_jitterbug(Geometry &lat_jb, const jb_opts &opts)
 {
-  jb_opts opts;
-  opts.process_command_line(argc, argv);
-
   double cyc_val = cycle_value(opts.stage, opts.cycle_type);
-  Geometry jb, lat_jb;
+  Geometry jb;
   double scale = jb_make(jb, cyc_val, opts.faces);
   lattice_make(lat_jb, jb, cyc_val, scale, opts.lat_size, opts.fix_connect);
   lattice_trans(lat_jb, cyc_val, opts.tri_fix, opts.tri_top);
 
+  return Status::ok();
+}
+
+int main(int argc, char *argv[])
+{
+  jb_opts opts;
+  opts.process_command_line(argc, argv);
+
+  if (opts.batch_file.length()) {
+    auto check_opts = [](jb_opts &item) {
+      if (item.batch_file.length())
+        item.error("batch mode is not valid in a batch line", 'B');
+    };
+    return make_batch<jb_opts>(opts, opts.batch_file, opts.ofile,
+                               opts.num_threads, make_jitterbug, check_opts);
+  }
+
+  Geometry lat_jb;
+  opts.print_status_or_exit(make_jitterbug(lat_jb, opts));
   opts.write_or_error(lat_jb, opts.ofile);
 
   return 0;